@@ -0,0 +1,190 @@
+/***************************************************************************************
+// Memory allocators for Sprites, smooth font metrics and scratch buffers
+***************************************************************************************/
+
+/***************************************************************************************
+** Function name:           allocMemory, freeMemory
+** Description:             Use the allocator if one is set, otherwise the heap
+***************************************************************************************/
+static void* allocMemory(TFT_eAllocator *alloc, size_t size)
+{
+  if (alloc) return alloc->allocate(size);
+  return malloc(size);
+}
+
+static void freeMemory(TFT_eAllocator *alloc, void *ptr)
+{
+  if (ptr == nullptr) return;
+  if (alloc) alloc->release(ptr);
+  else free(ptr);
+}
+
+
+/***************************************************************************************
+** Function name:           alignRegion - helper function for the allocators
+** Description:             Align the start of a region and return the usable size
+***************************************************************************************/
+static size_t alignRegion(void *mem, size_t size, uint8_t **aligned)
+{
+  uintptr_t start = ((uintptr_t)mem + ALLOC_ALIGN - 1) & ~(uintptr_t)(ALLOC_ALIGN - 1);
+  *aligned = (uint8_t*)start;
+  if (mem == nullptr || start - (uintptr_t)mem > size) return 0;
+  return size - (start - (uintptr_t)mem);
+}
+
+
+/***************************************************************************************
+** Function name:           TFT_eArena
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eArena::TFT_eArena(void *mem, size_t size)
+{
+  _size = alignRegion(mem, size, &_mem);
+  reset();
+}
+
+
+/***************************************************************************************
+** Function name:           allocate
+** Description:             Take a block from the free end of the arena
+***************************************************************************************/
+void* TFT_eArena::allocate(size_t size)
+{
+  if (size == 0) size = 1;
+  size = (size + ALLOC_ALIGN - 1) & ~(size_t)(ALLOC_ALIGN - 1);
+  if (size > _size - _used || ARENA_HEADER > _size - _used - size) return nullptr;
+
+  // The header holds the block size, the lowest bit is set while the block is in use
+  *(size_t*)(_mem + _used) = size | 1;
+
+  _last  = _used;
+  _used += ARENA_HEADER + size;
+  _live++;
+
+  return _mem + _last + ARENA_HEADER;
+}
+
+
+/***************************************************************************************
+** Function name:           release
+** Description:             Release a block, the space is reused when possible
+***************************************************************************************/
+void TFT_eArena::release(void *ptr)
+{
+  uint8_t *block = (uint8_t*)ptr;
+
+  // Ignore pointers that are not in the allocated part of the arena
+  if (block < _mem + ARENA_HEADER || block >= _mem + _used) return;
+  if ((block - _mem) % ALLOC_ALIGN) return;
+
+  // A block that has already been released is not counted again
+  size_t *header = (size_t*)(block - ARENA_HEADER);
+  if ((*header & 1) == 0) return;
+  *header &= ~(size_t)1;
+
+  if (--_live == 0) { _used = 0; _last = 0; }
+  else if (block == _mem + _last + ARENA_HEADER) _used = _last;
+}
+
+
+/***************************************************************************************
+** Function name:           TFT_ePool
+** Description:             Class constructor
+***************************************************************************************/
+TFT_ePool::TFT_ePool(void *mem, size_t size)
+{
+  _size    = alignRegion(mem, size, &_mem);
+  _used    = 0;
+  _classes = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           addClass
+** Description:             Reserve count blocks of blockSize bytes
+***************************************************************************************/
+bool TFT_ePool::addClass(size_t blockSize, uint16_t count)
+{
+  if (_classes >= POOL_CLASSES || count == 0) return false;
+
+  // A free block holds the link to the next one
+  if (blockSize < sizeof(void*)) blockSize = sizeof(void*);
+  blockSize = (blockSize + ALLOC_ALIGN - 1) & ~(size_t)(ALLOC_ALIGN - 1);
+  if (blockSize > (_size - _used) / count) return false;
+
+  // Keep the classes in order of block size so allocate() finds the best fit first
+  uint8_t c = _classes++;
+  while (c > 0 && _class[c - 1].blockSize > blockSize) { _class[c] = _class[c - 1]; c--; }
+
+  poolClass_t *pc = &_class[c];
+  pc->start     = _mem + _used;
+  pc->end       = pc->start + blockSize * count;
+  pc->blockSize = blockSize;
+  pc->free      = nullptr;
+  pc->freeCount = count;
+  _used += blockSize * count;
+
+  // Link the blocks, lowest address first
+  for (uint8_t *block = pc->end - blockSize; block >= pc->start; block -= blockSize) {
+    *(void**)block = pc->free;
+    pc->free = block;
+    if (block == pc->start) break;
+  }
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           allocate
+** Description:             Take the smallest free block that holds size bytes
+***************************************************************************************/
+void* TFT_ePool::allocate(size_t size)
+{
+  for (uint8_t c = 0; c < _classes; c++) {
+    poolClass_t *pc = &_class[c];
+    if (pc->blockSize < size || pc->free == nullptr) continue;
+    void *block = pc->free;
+    pc->free = *(void**)block;
+    pc->freeCount--;
+    return block;
+  }
+
+  return nullptr;
+}
+
+
+/***************************************************************************************
+** Function name:           release
+** Description:             Return a block to the free list of its class
+***************************************************************************************/
+void TFT_ePool::release(void *ptr)
+{
+  uint8_t *block = (uint8_t*)ptr;
+
+  for (uint8_t c = 0; c < _classes; c++) {
+    poolClass_t *pc = &_class[c];
+    if (block < pc->start || block >= pc->end) continue;
+    if ((block - pc->start) % pc->blockSize) return; // Not the start of a block
+    *(void**)block = pc->free;
+    pc->free = block;
+    pc->freeCount++;
+    return;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           available
+** Description:             Return the number of free blocks that could hold size bytes
+***************************************************************************************/
+uint16_t TFT_ePool::available(size_t size)
+{
+  uint16_t count = 0;
+
+  for (uint8_t c = 0; c < _classes; c++) {
+    if (_class[c].blockSize >= size) count += _class[c].freeCount;
+  }
+
+  return count;
+}
@@ -0,0 +1,101 @@
+/***************************************************************************************
+// The following classes provide memory for Sprites, smooth font metrics and scratch
+// buffers from a region reserved by the sketch instead of the system heap. Use
+// setAllocator() on the TFT_eSPI or TFT_eSprite instance, Sprites created with a TFT
+// instance start with the allocator of that instance.
+//
+// On a device that runs for a long time, creating and deleting Sprites of different
+// sizes can fragment the heap until createSprite() fails. Reserving the region once at
+// boot, for example with heap_caps_malloc() for DMA capable RAM on an ESP32, or with
+// ps_malloc() for PSRAM, keeps those allocations in a predictable place.
+//
+// Blocks returned are aligned to ALLOC_ALIGN bytes.
+***************************************************************************************/
+
+#define ALLOC_ALIGN       sizeof(void*)
+
+// Size of the header in front of each TFT_eArena block
+#define ARENA_HEADER      ALLOC_ALIGN
+
+// Maximum number of block sizes in a TFT_ePool
+#ifndef POOL_CLASSES
+  #define POOL_CLASSES 6
+#endif
+
+// Interface used by the library, a sketch can provide its own implementation
+class TFT_eAllocator {
+
+ public:
+
+  virtual ~TFT_eAllocator(void) { }
+
+  virtual void* allocate(size_t size) = 0; // Return nullptr if there is no space
+  virtual void  release(void *ptr) = 0;    // ptr is from allocate() or nullptr
+};
+
+
+// Fixed arena, blocks are taken from the region in order. A released block is only
+// reused if it was the last one allocated, and the whole arena becomes free again when
+// every block has been released. Suits memory that is freed together, such as the
+// metrics of a smooth font or the Sprites of a screen that is drawn and then deleted.
+// Each block has an ARENA_HEADER byte header that marks it in use, so a block released
+// twice is only counted once. Pointers outside the arena are ignored by release().
+class TFT_eArena : public TFT_eAllocator {
+
+ public:
+
+  TFT_eArena(void *mem, size_t size);
+
+  void*    allocate(size_t size);
+  void     release(void *ptr);
+
+  void     reset(void) { _used = 0; _last = 0; _live = 0; } // Free all blocks
+  size_t   used(void)  { return _used; }                     // Bytes in use, including alignment and headers
+  size_t   size(void)  { return _size; }
+
+ private:
+
+  uint8_t* _mem;  // Region, aligned
+  size_t   _size; // Usable size of region in bytes
+  size_t   _used; // Offset of the first free byte
+  size_t   _last; // Offset of the last block allocated
+  uint32_t _live; // Number of blocks not released
+};
+
+
+// Size class pool, the region is divided into classes of equal size blocks with
+// addClass(), and each request is given the smallest free block that is big enough.
+// Blocks never move or split so the pool cannot fragment. Suits Sprites and buffers
+// that are created and deleted repeatedly with a few known sizes.
+class TFT_ePool : public TFT_eAllocator {
+
+ public:
+
+  TFT_ePool(void *mem, size_t size);
+
+  // Reserve count blocks of blockSize bytes from the region, returns false if the
+  // region does not have space or POOL_CLASSES classes have already been added.
+  // Classes may be added in any order
+  bool     addClass(size_t blockSize, uint16_t count);
+
+  void*    allocate(size_t size);
+  void     release(void *ptr);
+
+  uint16_t available(size_t size); // Number of free blocks that could hold size bytes
+
+ private:
+
+  typedef struct {
+    uint8_t* start;     // First block of the class
+    uint8_t* end;       // End of the last block
+    size_t   blockSize; // Aligned block size
+    void*    free;      // List of free blocks, linked through their first word
+    uint16_t freeCount;
+  } poolClass_t;
+
+  uint8_t*    _mem;     // Region, aligned
+  size_t      _size;    // Usable size of region in bytes
+  size_t      _used;    // Bytes given to classes
+  uint8_t     _classes; // Number of classes added
+  poolClass_t _class[POOL_CLASSES];
+};
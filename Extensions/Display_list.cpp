@@ -0,0 +1,378 @@
+ // This is part of the TFT_eSPI class and is associated with display list recording
+
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Display list record formats, each record starts on a DL_ALIGN byte boundary
+////////////////////////////////////////////////////////////////////////////////////////
+
+#define DL_ALIGN  sizeof(void*)
+#define DL_BATCH  32   // Maximum number of solid rectangles sorted and merged as a group
+
+#define DL_RECT   1    // fillRect(), drawFastHLine(), drawFastVLine() and drawPixel()
+#define DL_IMAGE  2    // pushImage() 16-bit image in RAM
+#define DL_IMAGEP 3    // pushImage() 16-bit image in FLASH (PROGMEM)
+#define DL_STRING 4    // drawString()
+#define DL_SPAN   5    // Anti-aliased line of colours, the colours follow the record
+
+typedef struct {
+  uint8_t  op;
+  uint8_t  flags;
+  uint16_t color;
+  int16_t  x, y, w, h;
+} dl_rect_t;
+
+typedef struct {
+  uint8_t  op;
+  uint8_t  swap;       // _swapBytes setting when recorded
+  uint16_t spare;
+  int16_t  x, y, w, h;
+  const uint16_t *data;
+} dl_image_t;
+
+typedef struct {
+  uint8_t  op;
+  uint8_t  font;
+  uint16_t len;        // Record size in bytes, including the string
+  int16_t  x, y;
+  uint16_t fg, bg;     // Text state when recorded
+  int16_t  padX;
+  uint8_t  datum, size;
+  uint8_t  fillbg;
+  uint8_t  glyph_ab, glyph_bb;
+#ifdef LOAD_GFXFF
+  GFXfont *gfxFont;
+#endif
+  char     text[1];
+} dl_string_t;
+
+// Size of a record rounded up to the next record boundary
+#define DL_SIZE(len) (((len) + DL_ALIGN - 1) & ~(uint32_t)(DL_ALIGN - 1))
+
+// Check a value can be held in a record coordinate
+#define DL_FITS(v) ((v) >= -32768 && (v) <= 32767)
+
+
+/***************************************************************************************
+** Function name:           startRecording
+** Description:             Start recording drawing calls into a caller supplied arena
+***************************************************************************************/
+void TFT_eSPI::startRecording(void *arena, uint32_t size)
+{
+  // Align the start of the arena so records can hold pointers
+  uintptr_t start = ((uintptr_t)arena + DL_ALIGN - 1) & ~(uintptr_t)(DL_ALIGN - 1);
+  uint32_t  skip  = start - (uintptr_t)arena;
+
+  if (arena == nullptr || size <= skip) { _dlRecord = false; return; }
+
+  _dlArena  = (uint8_t*)start;
+  _dlSize   = size - skip;
+  _dlUsed   = 0;
+  _dlRecord = true;
+}
+
+
+/***************************************************************************************
+** Function name:           stopRecording
+** Description:             Stop recording, the list is kept for flush() or replay()
+***************************************************************************************/
+void TFT_eSPI::stopRecording(void)
+{
+  _dlRecord = false;
+}
+
+
+/***************************************************************************************
+** Function name:           dlAlloc
+** Description:             Reserve space for a record, the list is flushed if full
+***************************************************************************************/
+void* TFT_eSPI::dlAlloc(uint32_t len)
+{
+  len = DL_SIZE(len);
+
+  // Record can never fit so draw it directly after the earlier records
+  if (len > _dlSize) { flush(); return nullptr; }
+
+  if (_dlUsed + len > _dlSize) flush();
+
+  void *rec = _dlArena + _dlUsed;
+  _dlUsed += len;
+  return rec;
+}
+
+
+/***************************************************************************************
+** Function name:           dlRect
+** Description:             Record a solid rectangle, returns false if not recorded
+***************************************************************************************/
+bool TFT_eSPI::dlRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  // Nothing will be drawn, so nothing needs to be recorded
+  if ((w < 1) || (h < 1)) return true;
+
+  if (!DL_FITS(x) || !DL_FITS(y) || !DL_FITS(w) || !DL_FITS(h)) { flush(); return false; }
+
+  dl_rect_t *rec = (dl_rect_t*)dlAlloc(sizeof(dl_rect_t));
+  if (rec == nullptr) return false;
+
+  rec->op    = DL_RECT;
+  rec->flags = 0;
+  rec->color = color;
+  rec->x = x; rec->y = y; rec->w = w; rec->h = h;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           dlImage
+** Description:             Record a 16-bit image by reference, returns false if not recorded
+***************************************************************************************/
+bool TFT_eSPI::dlImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data, bool progmem)
+{
+  if (!DL_FITS(x) || !DL_FITS(y) || !DL_FITS(w) || !DL_FITS(h)) { flush(); return false; }
+
+  dl_image_t *rec = (dl_image_t*)dlAlloc(sizeof(dl_image_t));
+  if (rec == nullptr) return false;
+
+  rec->op   = progmem ? DL_IMAGEP : DL_IMAGE;
+  rec->swap = _swapBytes;
+  rec->x = x; rec->y = y; rec->w = w; rec->h = h;
+  rec->data = data;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           dlSpan
+** Description:             Record a line of colours by value, returns false if not recorded
+***************************************************************************************/
+// Used for anti-aliased spans, the caller's buffer is reused so the colours are copied
+bool TFT_eSPI::dlSpan(int32_t x, int32_t y, const uint16_t *color, int32_t len)
+{
+  if (!DL_FITS(x) || !DL_FITS(y) || !DL_FITS(len)) { flush(); return false; }
+
+  dl_image_t *rec = (dl_image_t*)dlAlloc(sizeof(dl_image_t) + len * sizeof(uint16_t));
+  if (rec == nullptr) return false;
+
+  uint16_t *data = (uint16_t*)(rec + 1);
+  memcpy(data, color, len * sizeof(uint16_t));
+
+  rec->op   = DL_SPAN;
+  rec->swap = true;    // Colours are not byte swapped
+  rec->x = x; rec->y = y; rec->w = len; rec->h = 1;
+  rec->data = data;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           dlString
+** Description:             Record a string and the text state, returns false if not recorded
+***************************************************************************************/
+bool TFT_eSPI::dlString(const char *string, int32_t x, int32_t y, uint8_t font)
+{
+  uint32_t n = strlen(string);
+  uint32_t len = offsetof(dl_string_t, text) + n + 1;
+
+  if (!DL_FITS(x) || !DL_FITS(y) || len > 0xFFF0) { flush(); return false; }
+
+  dl_string_t *rec = (dl_string_t*)dlAlloc(len);
+  if (rec == nullptr) return false;
+
+  rec->op     = DL_STRING;
+  rec->font   = font;
+  rec->len    = DL_SIZE(len);
+  rec->x = x; rec->y = y;
+  rec->fg     = textcolor;
+  rec->bg     = textbgcolor;
+  rec->padX   = padX;
+  rec->datum  = textdatum;
+  rec->size   = textsize;
+  rec->fillbg = _fillbg;
+  rec->glyph_ab = glyph_ab;
+  rec->glyph_bb = glyph_bb;
+#ifdef LOAD_GFXFF
+  rec->gfxFont = gfxFont;
+#endif
+  memcpy(rec->text, string, n + 1);
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           flush
+** Description:             Replay the display list to this TFT and clear it
+***************************************************************************************/
+void TFT_eSPI::flush(void)
+{
+  if (_dlUsed == 0) return;
+
+  dlReplay(this);
+  _dlUsed = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           replay
+** Description:             Replay the display list to another TFT instance
+***************************************************************************************/
+void TFT_eSPI::replay(TFT_eSPI *tft)
+{
+  if (tft) dlReplay(tft);
+}
+
+
+/***************************************************************************************
+** Function name:           replay
+** Description:             Replay the display list into a Sprite
+***************************************************************************************/
+void TFT_eSPI::replay(TFT_eSprite *spr)
+{
+  if (spr) dlReplay(spr);
+}
+
+
+/***************************************************************************************
+** Function name:           dlReplay
+** Description:             Draw the list records with the target's drawing functions
+***************************************************************************************/
+// Runs of solid rectangles are sorted top to bottom and adjacent rectangles of the same
+// colour are merged. This is only done where no rectangle of a different colour overlaps,
+// so the result is the same as drawing the records in order.
+template <typename T> void TFT_eSPI::dlReplay(T *target)
+{
+  TFT_eSPI *tft = target; // For access to the text state
+
+  // The drawing calls made here must not be recorded again
+  bool record = _dlRecord;
+  bool tftRecord = tft->_dlRecord;
+  _dlRecord = false;
+  tft->_dlRecord = false;
+
+  // Save the target text and image state, this is changed to match each record
+  uint32_t textcolor_ = tft->textcolor, textbgcolor_ = tft->textbgcolor;
+  int32_t  padX_ = tft->padX;
+  uint8_t  textdatum_ = tft->textdatum, textsize_ = tft->textsize;
+  uint8_t  glyph_ab_ = tft->glyph_ab, glyph_bb_ = tft->glyph_bb;
+  bool     fillbg_ = tft->_fillbg, swapBytes_ = tft->_swapBytes;
+#ifdef LOAD_GFXFF
+  GFXfont *gfxFont_ = tft->gfxFont;
+#endif
+
+  dl_rect_t batch[DL_BATCH];
+  uint32_t  count = 0;
+
+  // Hold the transaction open, as startWrite() does, so the drawing functions do not end it
+  bool lock = tft->lockTransaction;
+  tft->begin_nin_write();
+  tft->lockTransaction = true;
+  tft->inTransaction = true;
+
+  uint32_t pos = 0;
+  while (pos < _dlUsed || count) {
+    uint8_t *ptr = _dlArena + pos;
+    dl_rect_t *rect = (pos < _dlUsed && *ptr == DL_RECT) ? (dl_rect_t*)ptr : nullptr;
+
+    // Add the rectangle to the batch if it does not conflict with one already there
+    if (rect && count < DL_BATCH) {
+      bool conflict = false;
+      for (uint32_t i = 0; i < count; i++) {
+        dl_rect_t *b = &batch[i];
+        if (b->color != rect->color && rect->x < b->x + b->w && b->x < rect->x + rect->w &&
+                                       rect->y < b->y + b->h && b->y < rect->y + rect->h) {
+          conflict = true;
+          break;
+        }
+      }
+
+      if (!conflict) {
+        // Merge with an existing rectangle if the union is a rectangle, else insert
+        // in top to bottom, left to right order
+        uint32_t i = 0;
+        for (; i < count; i++) {
+          dl_rect_t *b = &batch[i];
+          if (b->color != rect->color) continue;
+          if (!DL_FITS(b->w + rect->w) || !DL_FITS(b->h + rect->h)) continue;
+          if (b->x == rect->x && b->w == rect->w) {
+            if (b->y + b->h == rect->y) { b->h += rect->h; break; }
+            if (rect->y + rect->h == b->y) { b->y = rect->y; b->h += rect->h; break; }
+          }
+          if (b->y == rect->y && b->h == rect->h) {
+            if (b->x + b->w == rect->x) { b->w += rect->w; break; }
+            if (rect->x + rect->w == b->x) { b->x = rect->x; b->w += rect->w; break; }
+          }
+        }
+
+        if (i == count) {
+          i = count++;
+          while (i && (batch[i - 1].y > rect->y || (batch[i - 1].y == rect->y && batch[i - 1].x > rect->x))) {
+            batch[i] = batch[i - 1];
+            i--;
+          }
+          batch[i] = *rect;
+        }
+
+        pos += DL_SIZE(sizeof(dl_rect_t));
+        continue;
+      }
+    }
+
+    // Draw the batch before any other record, or when a rectangle would conflict
+    if (count) {
+      for (uint32_t i = 0; i < count; i++) {
+        target->fillRect(batch[i].x, batch[i].y, batch[i].w, batch[i].h, batch[i].color);
+      }
+      count = 0;
+      continue;
+    }
+
+    if (*ptr == DL_IMAGE || *ptr == DL_IMAGEP || *ptr == DL_SPAN) {
+      dl_image_t *rec = (dl_image_t*)ptr;
+      tft->_swapBytes = rec->swap;
+      if (rec->op == DL_IMAGEP) target->pushImage(rec->x, rec->y, rec->w, rec->h, rec->data);
+      else target->pushImage(rec->x, rec->y, rec->w, rec->h, (uint16_t*)rec->data);
+      if (rec->op == DL_SPAN) pos += DL_SIZE(sizeof(dl_image_t) + rec->w * sizeof(uint16_t));
+      else pos += DL_SIZE(sizeof(dl_image_t));
+    }
+    else if (*ptr == DL_STRING) {
+      dl_string_t *rec = (dl_string_t*)ptr;
+      tft->textcolor   = rec->fg;
+      tft->textbgcolor = rec->bg;
+      tft->padX        = rec->padX;
+      tft->textdatum   = rec->datum;
+      tft->textsize    = rec->size;
+      tft->_fillbg     = rec->fillbg;
+      tft->glyph_ab    = rec->glyph_ab;
+      tft->glyph_bb    = rec->glyph_bb;
+#ifdef LOAD_GFXFF
+      tft->gfxFont     = rec->gfxFont;
+#endif
+      target->drawString(rec->text, rec->x, rec->y, rec->font);
+      pos += rec->len;
+    }
+    else break; // Unknown record, list is corrupt
+  }
+
+  tft->lockTransaction = lock;
+  tft->inTransaction = lock;
+  tft->end_nin_write();
+
+  tft->textcolor   = textcolor_;
+  tft->textbgcolor = textbgcolor_;
+  tft->padX        = padX_;
+  tft->textdatum   = textdatum_;
+  tft->textsize    = textsize_;
+  tft->_fillbg     = fillbg_;
+  tft->glyph_ab    = glyph_ab_;
+  tft->glyph_bb    = glyph_bb_;
+  tft->_swapBytes  = swapBytes_;
+#ifdef LOAD_GFXFF
+  tft->gfxFont     = gfxFont_;
+#endif
+
+  tft->_dlRecord = tftRecord;
+  _dlRecord = record;
+}
@@ -0,0 +1,36 @@
+ // This is part of the TFT_eSPI class and is associated with display list recording
+
+ public:
+
+  // While recording, fillRect(), drawFastHLine(), drawFastVLine(), drawPixel(),
+  // drawString() and the 16-bit pushImage() functions append a compact record to the
+  // caller supplied arena instead of writing to the TFT. flush() then replays the list
+  // in a single transaction. Other functions are not recorded and draw immediately, so
+  // call flush() first if the order matters. Images are stored by pointer so the image
+  // data must remain valid until the list has been replayed. Anti-aliased spans copy
+  // their colours into the list, the background is read when the span is recorded.
+  // setViewport() and resetViewport() flush the list while recording, so records keep
+  // their viewport.
+  void     startRecording(void *arena, uint32_t size); // Start recording into arena (size in bytes)
+  void     stopRecording(void);                        // Stop recording, the list is kept
+  bool     isRecording(void) { return _dlRecord; }
+
+  void     flush(void);                  // Replay the list to this TFT, then clear the list
+  void     replay(TFT_eSPI *tft);        // Replay the list to another TFT, the list is kept
+  void     replay(TFT_eSprite *spr);     // Replay the list into a Sprite, the list is kept
+  void     clearList(void) { _dlUsed = 0; }
+  uint32_t listUsed(void)  { return _dlUsed; } // Arena bytes used by the list
+
+ private:
+
+  bool     dlRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  bool     dlImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data, bool progmem);
+  bool     dlSpan(int32_t x, int32_t y, const uint16_t *color, int32_t len);
+  bool     dlString(const char *string, int32_t x, int32_t y, uint8_t font);
+  void*    dlAlloc(uint32_t len);
+  template <typename T> void dlReplay(T *target);
+
+  uint8_t* _dlArena  = nullptr; // Caller supplied list buffer, aligned
+  uint32_t _dlSize   = 0;       // Usable size of arena in bytes
+  uint32_t _dlUsed   = 0;       // Bytes occupied by records
+  bool     _dlRecord = false;   // Drawing calls are being recorded
@@ -0,0 +1,366 @@
+/**************************************************************************************
+// The following class builds vector paths from lines and Bezier curves and draws them
+// with the TFT_eSPI polygon filling functions. See Path.h for the coordinate system.
+***************************************************************************************/
+
+// Maximum number of straight segments used for one curve
+#ifndef PATH_CURVE_STEPS
+  #define PATH_CURVE_STEPS 64
+#endif
+
+constexpr float PathPi = 3.14159265359;
+
+/***************************************************************************************
+** Function name:           pathFixed - helper function for TFT_ePath
+** Description:             convert a pixel coordinate to 1/256 pixel units
+***************************************************************************************/
+static inline int32_t pathFixed(float v)
+{
+  return (int32_t)floorf(v * 256.0f + 0.5f);
+}
+
+/***************************************************************************************
+** Function name:           pathWork - helper functions for TFT_ePath
+** Description:             buffer space for the polygon filling work space
+***************************************************************************************/
+// Number of edges of buffer space taken by the work space for n edges
+static inline uint32_t pathWorkEdges(uint32_t n)
+{
+  return (n * sizeof(tftPolyWork_t) + sizeof(tftPolyEdge_t) - 1) / sizeof(tftPolyEdge_t);
+}
+
+// Largest number of edges that fit in spare edges of buffer space with their work space
+static uint16_t pathFillSpace(uint16_t spare)
+{
+  uint32_t n = (uint32_t)spare * sizeof(tftPolyEdge_t) / (sizeof(tftPolyEdge_t) + sizeof(tftPolyWork_t));
+  while (n && (n + pathWorkEdges(n) > spare)) n--;
+  return n;
+}
+
+/***************************************************************************************
+** Function name:           TFT_ePath
+** Description:             Class constructor
+***************************************************************************************/
+TFT_ePath::TFT_ePath(tftPolyEdge_t *edges, uint16_t size)
+{
+  _edge = edges;
+  _size = edges ? size : 0;
+  _tolerance = 0.25;
+  _tft  = nullptr;
+  _color = _bg_color = 0;
+  _step = 0;
+
+  reset();
+}
+
+/***************************************************************************************
+** Function name:           reset
+** Description:             Clear the path
+***************************************************************************************/
+void TFT_ePath::reset(void)
+{
+  _count = 0;
+  _used  = 0;
+  _sx = _sy = _cx = _cy = 0;
+  _closing  = false;
+  _move     = true;
+  _overflow = false;
+}
+
+/***************************************************************************************
+** Function name:           setTolerance
+** Description:             Set the maximum error when curves are flattened
+***************************************************************************************/
+void TFT_ePath::setTolerance(float tolerance)
+{
+  if (tolerance < 0.01f) tolerance = 0.01f;
+  _tolerance = tolerance;
+}
+
+/***************************************************************************************
+** Function name:           addEdge (private function)
+** Description:             Set up edge e from xa,ya to xb,yb
+***************************************************************************************/
+// Horizontal segments are kept so they can be stroked, they do not change the filled area
+bool TFT_ePath::addEdge(tftPolyEdge_t *e, int32_t xa, int32_t ya, int32_t xb, int32_t yb, uint8_t flags)
+{
+  if ((xa == xb) && (ya == yb)) return false;
+
+  if (!setEdge(e, xa, ya, xb, yb)) {
+    e->x0 = xa; e->y0 = ya;
+    e->x1 = xb; e->y1 = yb;
+    e->dxdy = 0;
+    e->dir  = 1;
+  }
+  e->flags = flags;
+
+  return true;
+}
+
+/***************************************************************************************
+** Function name:           moveTo
+** Description:             Start a new sub-path
+***************************************************************************************/
+void TFT_ePath::moveTo(float x, float y)
+{
+  // The edge closing the last sub-path is kept for filling
+  _closing = false;
+  _move    = true;
+
+  _sx = _cx = pathFixed(x);
+  _sy = _cy = pathFixed(y);
+}
+
+/***************************************************************************************
+** Function name:           lineTo
+** Description:             Add a straight line from the current point to x,y
+***************************************************************************************/
+void TFT_ePath::lineTo(float x, float y)
+{
+  int32_t xp = pathFixed(x);
+  int32_t yp = pathFixed(y);
+
+  if ((xp == _cx) && (yp == _cy)) return;
+
+  // The closing edge is replaced by the new segment and added again after it
+  if (_closing) { _count--; _closing = false; }
+
+  if (_count >= _size) _overflow = true;
+  else if (addEdge(_edge + _count, _cx, _cy, xp, yp, _move ? PATH_SEG_MOVE : 0)) {
+    _count++;
+    _move = false;
+  }
+
+  _cx = xp;
+  _cy = yp;
+
+  if ((_cx == _sx) && (_cy == _sy)) return;
+
+  if (_count >= _size) _overflow = true;
+  else if (addEdge(_edge + _count, _cx, _cy, _sx, _sy, PATH_SEG_CLOSE)) {
+    _count++;
+    _closing = true;
+  }
+}
+
+/***************************************************************************************
+** Function name:           quadTo
+** Description:             Add a quadratic Bezier curve from the current point to x,y
+***************************************************************************************/
+void TFT_ePath::quadTo(float cx, float cy, float x, float y)
+{
+  float x0 = _cx / 256.0f;
+  float y0 = _cy / 256.0f;
+
+  // The error of n equal steps is |p0 - 2c + p2| / (4 * n * n)
+  float dx = x0 - 2 * cx + x;
+  float dy = y0 - 2 * cy + y;
+  int32_t n = ceilf(sqrtf(sqrtf(dx * dx + dy * dy) / (4 * _tolerance)));
+  if (n < 1) n = 1;
+  if (n > PATH_CURVE_STEPS) n = PATH_CURVE_STEPS;
+
+  for (int32_t i = 1; i < n; i++) {
+    float t = (float)i / n;
+    float u = 1.0f - t;
+    lineTo(u * u * x0 + 2 * u * t * cx + t * t * x,
+           u * u * y0 + 2 * u * t * cy + t * t * y);
+  }
+  lineTo(x, y);
+}
+
+/***************************************************************************************
+** Function name:           cubicTo
+** Description:             Add a cubic Bezier curve from the current point to x,y
+***************************************************************************************/
+void TFT_ePath::cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y)
+{
+  float x0 = _cx / 256.0f;
+  float y0 = _cy / 256.0f;
+
+  // The error of n equal steps is at most 3 * max|p(i) - 2p(i+1) + p(i+2)| / (4 * n * n)
+  float ax = x0 - 2 * c1x + c2x, ay = y0 - 2 * c1y + c2y;
+  float bx = c1x - 2 * c2x + x,  by = c1y - 2 * c2y + y;
+  float dd = fmaxf(ax * ax + ay * ay, bx * bx + by * by);
+  int32_t n = ceilf(sqrtf(3 * sqrtf(dd) / (4 * _tolerance)));
+  if (n < 1) n = 1;
+  if (n > PATH_CURVE_STEPS) n = PATH_CURVE_STEPS;
+
+  for (int32_t i = 1; i < n; i++) {
+    float t = (float)i / n;
+    float u = 1.0f - t;
+    float a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+    lineTo(a * x0 + b * c1x + c * c2x + d * x,
+           a * y0 + b * c1y + c * c2y + d * y);
+  }
+  lineTo(x, y);
+}
+
+/***************************************************************************************
+** Function name:           close
+** Description:             Close the current sub-path with a line to its start
+***************************************************************************************/
+void TFT_ePath::close(void)
+{
+  // The closing edge becomes a normal segment so it is stroked
+  if (_closing) _edge[_count - 1].flags &= ~PATH_SEG_CLOSE;
+  _closing = false;
+  _move    = true;
+
+  _cx = _sx;
+  _cy = _sy;
+}
+
+/***************************************************************************************
+** Function name:           fill
+** Description:             Fill the area inside the path
+***************************************************************************************/
+void TFT_ePath::fill(TFT_eSPI *tft, uint32_t color, uint32_t bg_color, bool smooth)
+{
+  BUS_STAT_SCOPE_ON(tft, STAT_POLYGON);
+
+  // The work space goes in the free part of the buffer
+  if (pathWorkEdges(_count) > (uint32_t)(_size - _count)) { _overflow = true; return; }
+
+  tft->fillEdges(_edge, _count, (tftPolyWork_t*)(_edge + _count), color, bg_color, smooth);
+}
+
+/***************************************************************************************
+** Function name:           stroke
+** Description:             Draw along the path with rounded joins and ends
+***************************************************************************************/
+// The outline of each segment is a rectangle, round joins are added as fans on the outside
+// of each bend and open sub-paths have half circle ends. These shapes overlap but they all
+// have the same winding direction so filling them together draws each pixel once.
+void TFT_ePath::stroke(TFT_eSPI *tft, float width, uint32_t color, uint32_t bg_color)
+{
+  BUS_STAT_SCOPE_ON(tft, STAT_POLYGON);
+
+  float r = width / 2.0f;
+  if ((r <= 0) || !_count) return;
+
+  _tft = tft;
+  _color = color;
+  _bg_color = bg_color;
+  _used = 0;
+
+  // Angle step for round joins and ends, the chord error is within the tolerance
+  _step = (_tolerance < r) ? 2.0f * acosf(1.0f - _tolerance / r) : PathPi / 2;
+
+  uint16_t first = 0; // First segment of the sub-path
+
+  for (uint16_t i = 0; i < _count; i++) {
+    const tftPolyEdge_t *e = _edge + i;
+    if (e->flags & PATH_SEG_CLOSE) continue;
+    if (e->flags & PATH_SEG_MOVE) first = i;
+
+    // Segment direction is lost when edges are stored top end first
+    float ax = e->x0 / 256.0f, ay = e->y0 / 256.0f;
+    float bx = e->x1 / 256.0f, by = e->y1 / 256.0f;
+    if (e->dir < 0) { transpose(ax, bx); transpose(ay, by); }
+
+    float dx = bx - ax, dy = by - ay;
+    float len = sqrtf(dx * dx + dy * dy);
+    float nx = -dy * r / len, ny = dx * r / len;
+
+    float rect[8] = { ax + nx, ay + ny, bx + nx, by + ny, bx - nx, by - ny, ax - nx, ay - ny };
+    addOutline(rect, 4);
+
+    // Find the segment joined to the end of this one
+    uint16_t j = i + 1;
+    if ((j >= _count) || (_edge[j].flags & (PATH_SEG_MOVE | PATH_SEG_CLOSE))) {
+      // End of the sub-path, it is closed if it finishes at the start point
+      const tftPolyEdge_t *f = _edge + first;
+      int32_t fx = (f->dir < 0) ? f->x1 : f->x0;
+      int32_t fy = (f->dir < 0) ? f->y1 : f->y0;
+      int32_t ex = (e->dir < 0) ? e->x0 : e->x1;
+      int32_t ey = (e->dir < 0) ? e->y0 : e->y1;
+
+      if ((i != first) && (fx == ex) && (fy == ey)) j = first;
+      else {
+        // Round ends
+        addFan(bx, by, nx, ny, -PathPi);
+        float fdx = (f->x1 - f->x0) * f->dir / 256.0f;
+        float fdy = (f->y1 - f->y0) * f->dir / 256.0f;
+        float flen = sqrtf(fdx * fdx + fdy * fdy);
+        addFan(fx / 256.0f, fy / 256.0f, fdy * r / flen, -fdx * r / flen, -PathPi);
+        continue;
+      }
+    }
+
+    // Round join, the fan sweeps from this segment to the next one on the outside of the bend
+    const tftPolyEdge_t *g = _edge + j;
+    float gdx = (g->x1 - g->x0) * g->dir / 256.0f;
+    float gdy = (g->y1 - g->y0) * g->dir / 256.0f;
+    float cross = dx * gdy - dy * gdx;
+    float sweep = atan2f(cross, dx * gdx + dy * gdy);
+    if (fabsf(sweep) < 0.01f) continue; // Nearly straight so no gap to fill
+    if (sweep > 0) addFan(bx, by, -nx, -ny, sweep);
+    else           addFan(bx, by,  nx,  ny, sweep);
+  }
+
+  flushOutline();
+}
+
+/***************************************************************************************
+** Function name:           addOutline (private function)
+** Description:             Add a closed polygon to the stroke outline
+***************************************************************************************/
+// All polygons are added with the same winding direction so the overlaps are not holes
+void TFT_ePath::addOutline(const float *xy, uint16_t n)
+{
+  // The outline and its work space go in the free part of the buffer, draw what is there
+  // if it is full
+  uint16_t space = pathFillSpace(_size - _count);
+  if (n > space) { _overflow = true; return; }
+  if (_used + n > space) flushOutline();
+
+  float area = 0;
+  for (uint16_t i = 0, k = n - 1; i < n; k = i++) area += xy[2 * k] * xy[2 * i + 1] - xy[2 * i] * xy[2 * k + 1];
+
+  tftPolyEdge_t *e = _edge + _count + _used;
+  for (uint16_t i = 0, k = n - 1; i < n; k = i++) {
+    uint16_t a = (area < 0) ? k : i;
+    uint16_t b = (area < 0) ? i : k;
+    if (setEdge(e, pathFixed(xy[2 * b]), pathFixed(xy[2 * b + 1]), pathFixed(xy[2 * a]), pathFixed(xy[2 * a + 1]))) {
+      e++;
+      _used++;
+    }
+  }
+}
+
+/***************************************************************************************
+** Function name:           addFan (private function)
+** Description:             Add a circle sector to the stroke outline
+***************************************************************************************/
+// The sector is centred on cx,cy and sweeps by the sweep angle from the offset ax,ay
+void TFT_ePath::addFan(float cx, float cy, float ax, float ay, float sweep)
+{
+  int32_t n = ceilf(fabsf(sweep) / _step);
+  if (n < 1) n = 1;
+  if (n > PATH_CURVE_STEPS) n = PATH_CURVE_STEPS;
+
+  float xy[2 * (PATH_CURVE_STEPS + 2)];
+  xy[0] = cx;
+  xy[1] = cy;
+
+  float c = cosf(sweep / n), s = sinf(sweep / n);
+  for (int32_t i = 0; i <= n; i++) {
+    xy[2 * i + 2] = cx + ax;
+    xy[2 * i + 3] = cy + ay;
+    float t = ax * c - ay * s;
+    ay = ax * s + ay * c;
+    ax = t;
+  }
+
+  addOutline(xy, n + 2);
+}
+
+/***************************************************************************************
+** Function name:           flushOutline (private function)
+** Description:             Draw the stroke outline held in the buffer
+***************************************************************************************/
+void TFT_ePath::flushOutline(void)
+{
+  if (_used) _tft->fillEdges(_edge + _count, _used, (tftPolyWork_t*)(_edge + _count + _used), _color, _bg_color, true);
+  _used = 0;
+}
@@ -0,0 +1,73 @@
+/***************************************************************************************
+// The following class builds vector paths from straight lines and quadratic and cubic
+// Bezier curves. Curves are flattened to straight segments which are held in an edge
+// buffer supplied by the sketch, so a path can be rebuilt for every frame without any
+// memory being allocated. The path can then be filled or stroked with anti-aliasing
+// into the TFT or a TFT_eSprite.
+//
+// Coordinates are in pixels with the same origin as other drawing functions, the
+// area of pixel x,y is from x,y to x+1,y+1. A 1 pixel wide stroke that fills a pixel
+// line exactly must be at the pixel centre i.e. y + 0.5
+***************************************************************************************/
+
+// Path segment flags, these are held in the flags member of the tftPolyEdge_t
+#define PATH_SEG_MOVE  0x01 // First segment of a sub-path
+#define PATH_SEG_CLOSE 0x02 // Segment added to close the sub-path for filling, it is not stroked
+
+class TFT_ePath {
+
+ public:
+
+  // The buffer holds one edge for each flattened segment. Filling uses the free part of the
+  // buffer as work space and needs half an edge for each segment. Stroking uses the free
+  // part for the outline and its work space, about 12 edges per segment draws it in one
+  // pass, with less it is drawn in parts which are blended twice where they meet
+  TFT_ePath(tftPolyEdge_t *edges, uint16_t size);
+
+  void     reset(void);                                   // Clear the path, the buffer is kept
+  void     moveTo(float x, float y);                      // Start a new sub-path at x,y
+  void     lineTo(float x, float y);                      // Straight line to x,y
+  void     quadTo(float cx, float cy, float x, float y);  // Quadratic curve to x,y with control point cx,cy
+  void     cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y); // Cubic curve to x,y
+  void     close(void);                                   // Line back to the start of the sub-path
+
+           // Maximum distance in pixels between a curve and the straight segments that
+           // replace it, default is 0.25. Larger values give fewer segments
+  void     setTolerance(float tolerance);
+
+           // Fill the area inside the path, sub-paths are closed automatically and may cross
+           // (non-zero winding rule). If bg_color is not included the background pixel colour
+           // will be read from the TFT or sprite
+  void     fill(TFT_eSPI *tft, uint32_t color, uint32_t bg_color = 0x00FFFFFF, bool smooth = true);
+
+           // Draw along the path with a line width in pixels, joins and open ends are rounded
+  void     stroke(TFT_eSPI *tft, float width, uint32_t color, uint32_t bg_color = 0x00FFFFFF);
+
+  uint16_t segments(void) { return _count; }    // Number of edges used by the path
+  bool     overflow(void) { return _overflow; } // True if the buffer was too small
+
+ private:
+
+  bool     addEdge(tftPolyEdge_t *e, int32_t xa, int32_t ya, int32_t xb, int32_t yb, uint8_t flags);
+  void     addOutline(const float *xy, uint16_t n);
+  void     addFan(float cx, float cy, float ax, float ay, float sweep);
+  void     flushOutline(void);
+
+  tftPolyEdge_t *_edge;    // Edge buffer supplied by the sketch
+  uint16_t _size;          // Number of edges in the buffer
+  uint16_t _count;         // Edges used by the path
+  uint16_t _used;          // Edges used by the stroke outline, after the path edges
+
+  int32_t  _sx, _sy;       // Sub-path start point, 1/256 pixel units
+  int32_t  _cx, _cy;       // Current point, 1/256 pixel units
+  float    _tolerance;     // Curve flattening tolerance
+
+  bool     _closing;       // The last edge closes the current sub-path
+  bool     _move;          // The next segment starts a new sub-path
+  bool     _overflow;      // Segments have been lost
+
+  // Stroke parameters
+  TFT_eSPI *_tft;
+  uint32_t _color, _bg_color;
+  float    _step;          // Arc angle step for round joins and ends
+};
@@ -155,6 +155,20 @@ void TFT_eSPI::loadMetrics(void)
   uint32_t headerPtr = 24;
   uint32_t bitmapPtr = headerPtr + gFont.gCount * 28;
 
+  // The metrics are released to the allocator they came from
+  _fontAllocator = _allocator;
+
+  if (_allocator)
+  {
+    gUnicode  = (uint16_t*)_allocator->allocate( gFont.gCount * 2);
+    gHeight   =  (uint8_t*)_allocator->allocate( gFont.gCount );
+    gWidth    =  (uint8_t*)_allocator->allocate( gFont.gCount );
+    gxAdvance =  (uint8_t*)_allocator->allocate( gFont.gCount );
+    gdY       =  (int16_t*)_allocator->allocate( gFont.gCount * 2);
+    gdX       =   (int8_t*)_allocator->allocate( gFont.gCount );
+    gBitmap   = (uint32_t*)_allocator->allocate( gFont.gCount * 4);
+  }
+  else
 #if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
   if ( psramFound() )
   {
@@ -178,6 +192,13 @@ void TFT_eSPI::loadMetrics(void)
     gBitmap   = (uint32_t*)malloc( gFont.gCount * 4); // seek pointer to glyph bitmap in the file
   }
 
+  // The font is not loaded if there is no room for the metrics
+  if (!gUnicode || !gHeight || !gWidth || !gxAdvance || !gdY || !gdX || !gBitmap)
+  {
+    unloadFont();
+    return;
+  }
+
 #ifdef SHOW_ASCENT_DESCENT
   Serial.print("ascent  = "); Serial.println(gFont.ascent);
   Serial.print("descent = "); Serial.println(gFont.descent);
@@ -256,43 +277,43 @@ void TFT_eSPI::unloadFont( void )
 {
   if (gUnicode)
   {
-    free(gUnicode);
+    freeMemory(_fontAllocator, gUnicode);
     gUnicode = NULL;
   }
 
   if (gHeight)
   {
-    free(gHeight);
+    freeMemory(_fontAllocator, gHeight);
     gHeight = NULL;
   }
 
   if (gWidth)
   {
-    free(gWidth);
+    freeMemory(_fontAllocator, gWidth);
     gWidth = NULL;
   }
 
   if (gxAdvance)
   {
-    free(gxAdvance);
+    freeMemory(_fontAllocator, gxAdvance);
     gxAdvance = NULL;
   }
 
   if (gdY)
   {
-    free(gdY);
+    freeMemory(_fontAllocator, gdY);
     gdY = NULL;
   }
 
   if (gdX)
   {
-    free(gdX);
+    freeMemory(_fontAllocator, gdX);
     gdX = NULL;
   }
 
   if (gBitmap)
   {
-    free(gBitmap);
+    freeMemory(_fontAllocator, gBitmap);
     gBitmap = NULL;
   }
 
@@ -359,6 +380,8 @@ bool TFT_eSPI::getUnicodeIndex(uint16_t unicode, uint16_t *index)
 // Expects file to be open
 void TFT_eSPI::drawGlyph(uint16_t code)
 {
+  BUS_STAT_SCOPE(STAT_DRAW_GLYPH);
+
   uint16_t fg = textcolor;
   uint16_t bg = textbgcolor;
 
@@ -411,7 +434,7 @@ void TFT_eSPI::drawGlyph(uint16_t code)
     if (fs_font)
     {
       fontFile.seek(gBitmap[gNum], fs::SeekSet);
-      pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
+      pbuffer =  (uint8_t*)allocMemory(_allocator, gWidth[gNum]);
     }
 #endif
 
@@ -426,6 +449,9 @@ void TFT_eSPI::drawGlyph(uint16_t code)
     int16_t  bxs = cx;
     uint32_t bl = 0;
     int16_t  bx = 0;
+    int16_t  axs = cx;
+    uint32_t al = 0;
+    uint8_t  aBuf[gWidth[gNum] + 1]; // Alpha values of a run of edge pixels
     uint8_t pixel;
 
     startWrite(); // Avoid slow ESP32 transaction overhead for every pixel
@@ -495,17 +521,25 @@ void TFT_eSPI::drawGlyph(uint16_t code)
               else drawFastHLine( fxs, y + cy, fl, fg);
               fl = 0;
             }
-            if (getColor) bg = getColor(x + cx, y + cy);
-            drawPixel(x + cx, y + cy, alphaBlend(pixel, fg, bg));
+            if (getColor) {
+              bg = getColor(x + cx, y + cy);
+              drawPixel(x + cx, y + cy, alphaBlend(pixel, fg, bg));
+            }
+            else {
+              if (al == 0) axs = x + cx;
+              aBuf[al++] = pixel;
+            }
           }
           else
           {
+            if (al) { drawAlphaSpan(axs, y + cy, aBuf, al, fg, bg); al = 0; }
             if (fl==0) fxs = x + cx;
             fl++;
           }
         }
         else
         {
+          if (al) { drawAlphaSpan(axs, y + cy, aBuf, al, fg, bg); al = 0; }
           if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
           if (_fillbg) {
             if (x >= bx) {
@@ -515,6 +549,7 @@ void TFT_eSPI::drawGlyph(uint16_t code)
           }
         }
       }
+      if (al) { drawAlphaSpan(axs, y + cy, aBuf, al, fg, bg); al = 0; }
       if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
       if (bl) { drawFastHLine( bxs, y + cy, bl, bg); bl = 0; }
     }
@@ -527,7 +562,7 @@ void TFT_eSPI::drawGlyph(uint16_t code)
       }
     }
 
-    if (pbuffer) free(pbuffer);
+    freeMemory(_allocator, pbuffer);
     cursor_x += gxAdvance[gNum];
     endWrite();
   }
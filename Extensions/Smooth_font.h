@@ -59,3 +59,5 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
 
   uint8_t* fontPtr = nullptr;
 
+  TFT_eAllocator *_fontAllocator = nullptr; // Allocator holding the glyph metrics, nullptr for the heap
+
@@ -5,6 +5,14 @@
 // graphics are written to the Sprite rather than the TFT.
 // Coded by Bodmer, see license file in root folder
 ***************************************************************************************/
+#if defined (ESP32)
+  #if __has_include("esp_memory_utils.h")
+    #include "esp_memory_utils.h"     // esp_ptr_dma_capable(), esp_ptr_external_ram()
+  #else
+    #include "soc/soc_memory_layout.h"
+  #endif
+#endif
+
 /***************************************************************************************
 // Color bytes are swapped when writing to RAM, this introduces a small overhead but
 // there is a nett performance gain by using swapped bytes.
@@ -37,6 +45,8 @@ TFT_eSprite::TFT_eSprite(TFT_eSPI *tft)
   _colorMap = nullptr;
 
   _psram_enable = true;
+
+  _allocator = tft->_allocator; // Sprite memory comes from the same place as the TFT's
   
   // Ensure end_tft_write() does nothing in inherited functions.
   lockTransaction = true;
@@ -104,6 +114,11 @@ void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
     rotation = 0;
     setViewport(0, 0, _dwidth, _dheight);
     setPivot(_iwidth/2, _iheight/2);
+
+    // The TFT content under a new sprite is unknown
+    _dirtyCount = 0;
+    _spanValid = false;
+    if (_trackDirty) markDirty(0, 0, _dwidth, _dheight);
     return _img8_1;
   }
 
@@ -139,6 +154,7 @@ bool TFT_eSprite::created(void)
 TFT_eSprite::~TFT_eSprite(void)
 {
   deleteSprite();
+  setStaging(false);
 
 #ifdef SMOOTH_FONT
   if(fontLoaded) unloadFont();
@@ -156,44 +172,26 @@ void* TFT_eSprite::callocSprite(int16_t w, int16_t h, uint8_t frames)
   // this means push/writeColor functions do not need additional bounds checks and
   // hence will run faster in normal circumstances.
   uint8_t* ptr8 = nullptr;
+  size_t   bytes;
 
   if (frames > 2) frames = 2; // Currently restricted to 2 frame buffers
   if (frames < 1) frames = 1;
 
   if (_bpp == 16)
   {
-#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable && !_tft->DMA_Enabled)
-    {
-      ptr8 = ( uint8_t*) ps_calloc(frames * w * h + frames, sizeof(uint16_t));
-      //Serial.println("PSRAM");
-    }
-    else
-#endif
-    {
-      ptr8 = ( uint8_t*) calloc(frames * w * h + frames, sizeof(uint16_t));
-      //Serial.println("Normal RAM");
-    }
+    bytes = (frames * w * h + frames) * sizeof(uint16_t);
   }
 
   else if (_bpp == 8)
   {
-#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable ) ptr8 = ( uint8_t*) ps_calloc(frames * w * h + frames, sizeof(uint8_t));
-    else
-#endif
-    ptr8 = ( uint8_t*) calloc(frames * w * h + frames, sizeof(uint8_t));
+    bytes = frames * w * h + frames;
   }
 
   else if (_bpp == 4)
   {
     w = (w+1) & 0xFFFE; // width needs to be multiple of 2, with an extra "off screen" pixel
     _iwidth = w;
-#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable ) ptr8 = ( uint8_t*) ps_calloc(((frames * w * h) >> 1) + frames, sizeof(uint8_t));
-    else
-#endif
-    ptr8 = ( uint8_t*) calloc(((frames * w * h) >> 1) + frames, sizeof(uint8_t));
+    bytes = ((frames * w * h) >> 1) + frames;
   }
 
   else // Must be 1 bpp
@@ -205,18 +203,142 @@ void* TFT_eSprite::callocSprite(int16_t w, int16_t h, uint8_t frames)
     w =  (w+7) & 0xFFF8; // width should be the multiple of 8 bits to be compatible with epdpaint
     _iwidth = w;         // _iwidth is rounded up to be multiple of 8, so might not be = _dwidth
     _bitwidth = w;       // _bitwidth will not be rotated whereas _iwidth may be
+    bytes = frames * (w>>3) * h + frames;
+  }
+
+  // The palette and span list are released to the same allocator as the Sprite
+  _imgAllocator = _allocator;
+
+  if (_allocator)
+  {
+    ptr8 = (uint8_t*) _allocator->allocate(bytes);
+    if (ptr8) memset(ptr8, 0, bytes);
+  }
+
+#if defined (ESP32)
+  else if (_memPlacement != SPRITE_MEM_AUTO)
+  {
+    // Regions are tried in order until one has space, 0 ends the chain
+    uint32_t chain[3] = { 0, 0, 0 };
+    uint32_t internal = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    uint32_t psram    = _psram_enable ? MALLOC_CAP_SPIRAM : 0;
+    if (_memPlacement == SPRITE_MEM_DMA)           { chain[0] = MALLOC_CAP_DMA; chain[1] = internal; chain[2] = psram; }
+    else if (_memPlacement == SPRITE_MEM_INTERNAL) { chain[0] = internal; chain[1] = psram; }
+    else                                           { chain[0] = psram; chain[1] = internal; }
+
+    for (uint8_t i = 0; i < 3 && ptr8 == nullptr; i++) {
+      if (chain[i]) ptr8 = (uint8_t*) heap_caps_calloc(bytes, sizeof(uint8_t), chain[i]);
+    }
+  }
+#endif
 
 #if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable ) ptr8 = ( uint8_t*) ps_calloc(frames * (w>>3) * h + frames, sizeof(uint8_t));
-    else
+  // 16 bpp Sprites stay in RAM if DMA is used
+  else if ( psramFound() && _psram_enable && (_bpp != 16 || !_tft->DMA_Enabled) )
+  {
+    ptr8 = ( uint8_t*) ps_calloc(bytes, sizeof(uint8_t));
+    //Serial.println("PSRAM");
+  }
+#endif
+
+  else
+  {
+    ptr8 = ( uint8_t*) calloc(bytes, sizeof(uint8_t));
+    //Serial.println("Normal RAM");
+  }
+
+  // Record where the memory landed
+  _memBytes    = ptr8 ? bytes : 0;
+  _memLocation = SPRITE_IN_NONE;
+  if (ptr8) {
+    _memLocation = SPRITE_IN_INTERNAL;
+#if defined (ESP32)
+    if (esp_ptr_external_ram(ptr8))     _memLocation = SPRITE_IN_PSRAM;
+    else if (esp_ptr_dma_capable(ptr8)) _memLocation = SPRITE_IN_DMA;
 #endif
-    ptr8 = ( uint8_t*) calloc(frames * (w>>3) * h + frames, sizeof(uint8_t));
   }
 
   return ptr8;
 }
 
 
+/***************************************************************************************
+** Function name:           getMemoryInfo
+** Description:             Report where the Sprite memory is and its read cost
+***************************************************************************************/
+tftSpriteMemory_t TFT_eSprite::getMemoryInfo(void)
+{
+  tftSpriteMemory_t info;
+
+  info.location = _created ? _memLocation : SPRITE_IN_NONE;
+  info.bytes    = _created ? _memBytes : 0;
+
+  // Cached PSRAM reads are several times slower than internal RAM, more so when the
+  // Sprite is read in a different order to the way it is stored
+  info.cost     = (info.location == SPRITE_IN_PSRAM) ? 4 : (info.location == SPRITE_IN_NONE) ? 0 : 1;
+
+  info.staged   = _stageBuf && _bpp == 16 && info.location == SPRITE_IN_PSRAM && _dwidth <= SPRITE_STAGE_PIXELS;
+
+  return info;
+}
+
+
+/***************************************************************************************
+** Function name:           setStaging
+** Description:             Send a PSRAM Sprite through internal DMA buffers
+***************************************************************************************/
+bool TFT_eSprite::setStaging(bool enable)
+{
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if (enable) {
+    if (_stageBuf == nullptr) _stageBuf = (uint16_t*)heap_caps_malloc(SPRITE_STAGE_PIXELS * 2 * 2, MALLOC_CAP_DMA);
+    return _stageBuf != nullptr;
+  }
+  if (_stageBuf) { heap_caps_free(_stageBuf); _stageBuf = nullptr; }
+  return true;
+#else
+  return !enable;
+#endif
+}
+
+
+/***************************************************************************************
+** Function name:           pushSpriteStaged
+** Description:             Push a 16-bit PSRAM Sprite through the staging buffers
+***************************************************************************************/
+void TFT_eSprite::pushSpriteStaged(int32_t x, int32_t y)
+{
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  int32_t  lines = SPRITE_STAGE_PIXELS / _dwidth;
+  uint8_t  b = 0;
+
+  // pushImageDMA() does not use the viewport datum
+  x += _tft->_xDatum;
+  y += _tft->_yDatum;
+
+  bool oldSwapBytes = _tft->getSwapBytes();
+  _tft->setSwapBytes(false); // Sprite pixels are in TFT byte order
+
+  _tft->startWrite();
+  for (int32_t row = 0; row < _dheight; row += lines) {
+    int32_t h = (_dheight - row < lines) ? _dheight - row : lines;
+  #ifdef DMA_QUEUE_SIZE
+    // The buffer used two blocks ago is free once only the last block is left in the queue
+    while (_tft->dmaQueueDepth() > 1) yield();
+  #endif
+    // The lines are copied into the buffer before the DMA of the previous block is waited for
+    _tft->pushImageDMA(x, y + row, _dwidth, h, _img + row * _dwidth, _stageBuf + b * SPRITE_STAGE_PIXELS);
+    b ^= 1;
+  }
+  _tft->endWrite(); // Waits for the DMA to finish
+
+  _tft->setSwapBytes(oldSwapBytes);
+#else
+  (void)x; (void)y;
+#endif
+}
+
+
 /***************************************************************************************
 ** Function name:           createPalette (from RAM array)
 ** Description:             Set a palette for a 4-bit per pixel sprite
@@ -233,7 +355,11 @@ void TFT_eSprite::createPalette(uint16_t colorMap[], uint8_t colors)
   }
 
   // Allocate and clear memory for 16 color map
-  if (_colorMap == nullptr) _colorMap = (uint16_t *)calloc(16, sizeof(uint16_t));
+  if (_colorMap == nullptr) {
+    _colorMap = (uint16_t *)allocMemory(_imgAllocator, 16 * sizeof(uint16_t));
+    if (_colorMap == nullptr) return;
+    memset(_colorMap, 0, 16 * sizeof(uint16_t));
+  }
 
   if (colors > 16) colors = 16;
 
@@ -260,7 +386,11 @@ void TFT_eSprite::createPalette(const uint16_t colorMap[], uint8_t colors)
   }
 
   // Allocate and clear memory for 16 color map
-  if (_colorMap == nullptr) _colorMap = (uint16_t *)calloc(16, sizeof(uint16_t));
+  if (_colorMap == nullptr) {
+    _colorMap = (uint16_t *)allocMemory(_imgAllocator, 16 * sizeof(uint16_t));
+    if (_colorMap == nullptr) return;
+    memset(_colorMap, 0, 16 * sizeof(uint16_t));
+  }
 
   if (colors > 16) colors = 16;
 
@@ -281,8 +411,15 @@ void* TFT_eSprite::frameBuffer(int8_t f)
 {
   if (!_created) return nullptr;
 
-  if ( f == 2 ) _img8 = _img8_2;
-  else          _img8 = _img8_1;
+  uint8_t* img = (f == 2) ? _img8_2 : _img8_1;
+
+  // The span list was made from, and the dirty areas were drawn in, the other frame
+  if (img != _img8) {
+    _spanValid = false;
+    if (_trackDirty) markDirty(0, 0, _dwidth, _dheight);
+  }
+
+  _img8 = img;
 
   if (_bpp == 16) _img = (uint16_t*)_img8;
 
@@ -374,25 +511,33 @@ void TFT_eSprite::deleteSprite(void)
 {
   if (_colorMap != nullptr)
   {
-    free(_colorMap);
+    freeMemory(_imgAllocator, _colorMap);
     _colorMap = nullptr;
   }
 
+  if (_spans != nullptr)
+  {
+    freeMemory(_imgAllocator, _spans);
+    _spans = nullptr;
+  }
+  _spanSize  = 0;
+  _spanValid = false;
+
   if (_created)
   {
-    free(_img8_1);
+    freeMemory(_imgAllocator, _img8_1);
     _img8 = nullptr;
     _created = false;
     _vpOoB   = true;  // TFT_eSPI class write() uses this to check for valid sprite
+    _dirtyCount = 0;
   }
 }
 
 
 /***************************************************************************************
-** Function name:           pushRotated - Fast fixed point integer maths version
+** Function name:           pushRotated
 ** Description:             Push rotated Sprite to TFT screen
 ***************************************************************************************/
-#define FP_SCALE 10
 bool TFT_eSprite::pushRotated(int16_t angle, uint32_t transp)
 {
   if ( !_created || _tft->_vpOoB) return false;
@@ -406,69 +551,28 @@ bool TFT_eSprite::pushRotated(int16_t angle, uint32_t transp)
   // Get the bounding box of this rotated source Sprite relative to Sprite pivot
   if ( !getRotatedBounds(angle, &min_x, &min_y, &max_x, &max_y) ) return false;
 
-  uint16_t sline_buffer[max_x - min_x + 1];
+  BUS_STAT_SCOPE_ON(_tft, STAT_PUSH_ROTATED);
 
-  int32_t xt = min_x - _tft->_xPivot;
-  int32_t yt = min_y - _tft->_yPivot;
-  uint32_t xe = _dwidth << FP_SCALE;
-  uint32_t ye = _dheight << FP_SCALE;
-  uint16_t tpcolor = (uint16_t)transp;
+  // The TFT pivot is not relative to the viewport datum
+  tftAffine_t m;
+  setAffine(&m, angle, 1.0, 1.0, 0.0, _tft->_xPivot - _tft->_xDatum, _tft->_yPivot - _tft->_yDatum);
 
-  if (transp != 0x00FFFFFF) {
-    if (_bpp == 4) tpcolor = _colorMap[transp & 0x0F];
-    tpcolor = tpcolor>>8 | tpcolor<<8; // Working with swapped color bytes
-  }
-  _tft->startWrite(); // Avoid transaction overhead for every tft pixel
-
-  // Scan destination bounding box and fetch transformed pixels from source Sprite
-  for (int32_t y = min_y; y <= max_y; y++, yt++) {
-    int32_t x = min_x;
-    uint32_t xs = (_cosra * xt - (_sinra * yt - (_xPivot << FP_SCALE)) + (1 << (FP_SCALE - 1)));
-    uint32_t ys = (_sinra * xt + (_cosra * yt + (_yPivot << FP_SCALE)) + (1 << (FP_SCALE - 1)));
-
-    while ((xs >= xe || ys >= ye) && x < max_x) { x++; xs += _cosra; ys += _sinra; }
-    if (x == max_x) continue;
-
-    uint32_t pixel_count = 0;
-    do {
-      uint32_t rp;
-      int32_t xp = xs >> FP_SCALE;
-      int32_t yp = ys >> FP_SCALE;
-      if (_bpp == 16) {rp = _img[xp + yp * _iwidth]; }
-      else { rp = readPixel(xp, yp); rp = (uint16_t)(rp>>8 | rp<<8); }
-      if (transp != 0x00FFFFFF && tpcolor == rp) {
-        if (pixel_count) {
-          // TFT window is already clipped, so this is faster than pushImage()
-          _tft->setWindow(x - pixel_count, y, x - 1, y);
-          _tft->pushPixels(sline_buffer, pixel_count);
-          pixel_count = 0;
-        }
-      }
-      else {
-        sline_buffer[pixel_count++] = rp;
-      }
-    } while (++x < max_x && (xs += _cosra) < xe && (ys += _sinra) < ye);
-    if (pixel_count) {
-      // TFT window is already clipped, so this is faster than pushImage()
-      _tft->setWindow(x - pixel_count, y, x - 1, y);
-      _tft->pushPixels(sline_buffer, pixel_count);
-    }
-  }
-
-  _tft->endWrite(); // End transaction
+  _tft->startWrite(); // Avoid transaction overhead for every run of pixels
+  affinePush(nullptr, &m, transp, SCALE_NEAREST);
+  _tft->endWrite();
 
   return true;
 }
 
 
 /***************************************************************************************
-** Function name:           pushRotated - Fast fixed point integer maths version
+** Function name:           pushRotated
 ** Description:             Push a rotated copy of the Sprite to another Sprite
 ***************************************************************************************/
-// Not compatible with 4bpp
+// Not compatible with a 4bpp destination Sprite
 bool TFT_eSprite::pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp)
 {
-  if ( !_created  || _bpp == 4) return false; // Check this Sprite is created
+  if ( !_created ) return false; // Check this Sprite is created
   if ( !spr->_created  || spr->_bpp == 4) return false;  // Ckeck destination Sprite is created
 
   // Bounding box parameters
@@ -480,52 +584,288 @@ bool TFT_eSprite::pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp)
   // Get the bounding box of this rotated source Sprite
   if ( !getRotatedBounds(spr, angle, &min_x, &min_y, &max_x, &max_y) ) return false;
 
-  uint16_t sline_buffer[max_x - min_x + 1];
+  tftAffine_t m;
+  setAffine(&m, angle, 1.0, 1.0, 0.0, spr->_xPivot, spr->_yPivot);
+  affinePush(spr, &m, transp, SCALE_NEAREST);
 
-  int32_t xt = min_x - spr->_xPivot;
-  int32_t yt = min_y - spr->_yPivot;
-  uint32_t xe = _dwidth << FP_SCALE;
-  uint32_t ye = _dheight << FP_SCALE;
-  uint16_t tpcolor = (uint16_t)transp;
-  
-  if (transp != 0x00FFFFFF) {
-    if (_bpp == 4) tpcolor = _colorMap[transp & 0x0F];
-    tpcolor = tpcolor>>8 | tpcolor<<8; // Working with swapped color bytes
-  }
+  return true;
+}
 
-  bool oldSwapBytes = spr->getSwapBytes();
-  spr->setSwapBytes(false);
 
-  // Scan destination bounding box and fetch transformed pixels from source Sprite
-  for (int32_t y = min_y; y <= max_y; y++, yt++) {
-    int32_t x = min_x;
-    uint32_t xs = (_cosra * xt - (_sinra * yt - (_xPivot << FP_SCALE)) + (1 << (FP_SCALE - 1)));
-    uint32_t ys = (_sinra * xt + (_cosra * yt + (_yPivot << FP_SCALE)) + (1 << (FP_SCALE - 1)));
+/***************************************************************************************
+** Function name:           setAffine
+** Description:             Set an affine transform that scales, shears and rotates the Sprite
+***************************************************************************************/
+void TFT_eSprite::setAffine(tftAffine_t *m, float angle, float xScale, float yScale, float xShear,
+                            int32_t x, int32_t y)
+{
+  float radAngle = angle * 0.0174532925; // Convert degrees to radians
+  float sina = sin(radAngle);
+  float cosa = cos(radAngle);
 
-    while ((xs >= xe || ys >= ye) && x < max_x) { x++; xs += _cosra; ys += _sinra; }
-    if (x == max_x) continue;
+  // Rotation x Shear x Scale
+  m->a = cosa * xScale;
+  m->b = (cosa * xShear - sina) * yScale;
+  m->c = sina * xScale;
+  m->d = (sina * xShear + cosa) * yScale;
 
-    uint32_t pixel_count = 0;
-    do {
-      uint32_t rp;
-      int32_t xp = xs >> FP_SCALE;
-      int32_t yp = ys >> FP_SCALE;
-      if (_bpp == 16) rp = _img[xp + yp * _iwidth];
-      else { rp = readPixel(xp, yp); rp = (uint16_t)(rp>>8 | rp<<8); }
-      if (transp != 0x00FFFFFF && tpcolor == rp) {
-        if (pixel_count) {
-          spr->pushImage(x - pixel_count, y, pixel_count, 1, sline_buffer);
-          pixel_count = 0;
+  // Move the Sprite pivot to x,y
+  m->tx = x - (m->a * _xPivot + m->b * _yPivot);
+  m->ty = y - (m->c * _xPivot + m->d * _yPivot);
+}
+
+
+/***************************************************************************************
+** Function name:           pushAffine
+** Description:             Push a transformed copy of the Sprite to the TFT
+***************************************************************************************/
+bool TFT_eSprite::pushAffine(const tftAffine_t *m, uint32_t transp, uint8_t mode)
+{
+  BUS_STAT_SCOPE_ON(_tft, STAT_PUSH_ROTATED);
+
+  _tft->startWrite(); // Avoid transaction overhead for every run of pixels
+  bool drawn = affinePush(nullptr, m, transp, mode);
+  _tft->endWrite();
+
+  return drawn;
+}
+
+
+/***************************************************************************************
+** Function name:           pushAffine
+** Description:             Push a transformed copy of the Sprite to another Sprite
+***************************************************************************************/
+bool TFT_eSprite::pushAffine(TFT_eSprite *spr, const tftAffine_t *m, uint32_t transp, uint8_t mode)
+{
+  if (spr == nullptr) return false;
+
+  return affinePush(spr, m, transp, mode);
+}
+
+
+/***************************************************************************************
+** Function name:           affineFetch16, affineFetch8, affineFetch4, affineFetch1
+** Description:             Return the 565 colour of the Sprite pixel at x,y
+***************************************************************************************/
+// x,y must be inside the Sprite, the viewport and datum are ignored
+inline uint16_t TFT_eSprite::affineFetch16(int32_t x, int32_t y)
+{
+  uint16_t color = _img[x + y * _iwidth];
+  return (color >> 8) | (color << 8);
+}
+
+inline uint16_t TFT_eSprite::affineFetch8(int32_t x, int32_t y)
+{
+  uint16_t color = _img8[x + y * _iwidth];
+  if (color == 0) return 0;
+  uint8_t  blue[] = {0, 11, 21, 31};
+  return   (color & 0xE0)<<8 | (color & 0xC0)<<5
+         | (color & 0x1C)<<6 | (color & 0x1C)<<3
+         | blue[color & 0x03];
+}
+
+inline uint16_t TFT_eSprite::affineFetch4(int32_t x, int32_t y)
+{
+  uint8_t c = _img4[(x + y * _iwidth) >> 1];
+  return _colorMap[(x & 0x01) ? c & 0x0F : c >> 4];
+}
+
+inline uint16_t TFT_eSprite::affineFetch1(int32_t x, int32_t y)
+{
+  // Same mapping as drawPixel()
+  if (rotation == 1)      { int32_t tx = x; x = _dwidth - y - 1; y = tx; }
+  else if (rotation == 2) { x = _dwidth - x - 1; y = _dheight - y - 1; }
+  else if (rotation == 3) { int32_t tx = x; x = y; y = _dheight - tx - 1; }
+
+  if ((_img8[(x + y * _bitwidth)>>3] << (x & 0x7)) & 0x80) return _tft->bitmap_fg;
+  return _tft->bitmap_bg;
+}
+
+inline uint16_t TFT_eSprite::affineFetch(int32_t x, int32_t y)
+{
+  if (_bpp == 16) return affineFetch16(x, y);
+  if (_bpp == 8)  return affineFetch8(x, y);
+  if (_bpp == 4)  return affineFetch4(x, y);
+  return affineFetch1(x, y);
+}
+
+
+/***************************************************************************************
+** Function name:           affineRange - helper function for affinePush
+** Description:             Limit k0-k1 so that 0 <= s + k * d <= lim
+***************************************************************************************/
+static int64_t affineFloorDiv(int64_t a, int64_t b)
+{
+  int64_t q = a / b;
+  if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+  return q;
+}
+
+static void affineRange(int64_t s, int32_t d, int64_t lim, int32_t *k0, int32_t *k1)
+{
+  int64_t lo, hi;
+  if (d == 0) {
+    if (s < 0 || s > lim) *k1 = *k0 - 1;
+    return;
+  }
+  if (d > 0) { lo = -affineFloorDiv(s, d); hi = affineFloorDiv(lim - s, d); }
+  else       { lo = -affineFloorDiv(s - lim, d); hi = affineFloorDiv(-s, d); }
+  if (lo > *k0) *k0 = (lo > *k1) ? *k1 + 1 : lo;
+  if (hi < *k1) *k1 = (hi < *k0) ? *k0 - 1 : hi;
+}
+
+
+/***************************************************************************************
+** Function name:           affinePush
+** Description:             Push a transformed copy of the Sprite to the TFT or a Sprite
+***************************************************************************************/
+// Each destination pixel centre is mapped back into this Sprite with the inverse transform
+// in 16.16 fixed point. The first and last pixel of each row that land inside the Sprite
+// are found by division so only those pixels are sampled. spr is nullptr for the TFT
+bool TFT_eSprite::affinePush(TFT_eSprite *spr, const tftAffine_t *m, uint32_t transp, uint8_t mode)
+{
+  if (!_created || m == nullptr) return false;
+
+  TFT_eSPI *dst = _tft;
+  if (spr) {
+    if (!spr->_created || spr->_bpp == 4) return false;
+    dst = spr;
+  }
+  if (dst->_vpOoB) return false;
+
+  float det = m->a * m->d - m->b * m->c;
+  if (fabsf(det) < 1.0e-6) return false;
+
+  // Source size, a rotated 1bpp Sprite has swapped width and height
+  int32_t sw = _dwidth, sh = _dheight;
+  if (_bpp == 1 && (rotation & 1)) { sw = _dheight; sh = _dwidth; }
+
+  // Destination bounding box of the Sprite pixel area
+  float minx =  1.0e9, maxx = -1.0e9, miny =  1.0e9, maxy = -1.0e9;
+  for (uint8_t k = 0; k < 4; k++) {
+    float px = (k & 1) ? sw - 0.5 : -0.5;
+    float py = (k & 2) ? sh - 0.5 : -0.5;
+    float dx = m->a * px + m->b * py + m->tx;
+    float dy = m->c * px + m->d * py + m->ty;
+    if (dx < minx) minx = dx;
+    if (dx > maxx) maxx = dx;
+    if (dy < miny) miny = dy;
+    if (dy > maxy) maxy = dy;
+  }
+
+  int32_t xDatum = dst->_xDatum, yDatum = dst->_yDatum;
+  int32_t x0 = floorf(minx) + xDatum, x1 = ceilf(maxx) + xDatum;
+  int32_t y0 = floorf(miny) + yDatum, y1 = ceilf(maxy) + yDatum;
+  if (x0 < dst->_vpX) x0 = dst->_vpX;
+  if (y0 < dst->_vpY) y0 = dst->_vpY;
+  if (x1 >= dst->_vpW) x1 = dst->_vpW - 1;
+  if (y1 >= dst->_vpH) y1 = dst->_vpH - 1;
+  if (x0 > x1 || y0 > y1) return false;
+
+  // Inverse transform in 16.16 fixed point. u and v are offset by half a pixel so the
+  // nearest Sprite pixel is u >> 16, v >> 16 and u, v are in range if 0 <= u < sw << 16
+  float ia =  m->d / det, ib = -m->b / det;
+  float ic = -m->c / det, id =  m->a / det;
+  int32_t dux = lroundf(ia * 65536), duy = lroundf(ib * 65536);
+  int32_t dvx = lroundf(ic * 65536), dvy = lroundf(id * 65536);
+  float fx = x0 - xDatum - m->tx, fy = y0 - yDatum - m->ty;
+  int64_t us = llroundf((ia * fx + ib * fy + 0.5) * 65536);
+  int64_t vs = llroundf((ic * fx + id * fy + 0.5) * 65536);
+  int64_t ulim = ((int64_t)sw << 16) - 1;
+  int64_t vlim = ((int64_t)sh << 16) - 1;
+
+  // 16-bit pixels are copied without conversion, so they stay in TFT byte order
+  bool raw = (_bpp == 16) && (mode != SCALE_BILINEAR);
+
+  bool     useTp = (transp != 0x00FFFFFF);
+  uint16_t tp = (uint16_t)transp;
+  if (useTp && _bpp == 4) tp = _colorMap[transp & 0x0F];
+  if (raw) tp = (tp >> 8) | (tp << 8);
+
+  uint16_t lineBuf[x1 - x0 + 1];
+
+  // Other runs are pushed in processor byte order
+  bool oldSwapBytes = dst->getSwapBytes();
+  dst->setSwapBytes(!raw);
+
+  bool drawn = false;
+
+  for (int32_t y = y0; y <= y1; y++, us += duy, vs += dvy) {
+    int32_t k0 = 0, k1 = x1 - x0;
+    affineRange(us, dux, ulim, &k0, &k1);
+    affineRange(vs, dvx, vlim, &k0, &k1);
+    if (k0 > k1) continue;
+
+    int32_t  n = k1 - k0 + 1;
+    int32_t  u = us + (int64_t)k0 * dux;
+    int32_t  v = vs + (int64_t)k0 * dvx;
+    uint16_t *out = lineBuf;
+
+    if (mode == SCALE_BILINEAR) {
+      for (int32_t i = 0; i < n; i++, u += dux, v += dvx) {
+        // Sample position is half a pixel back, weights are rounded to 1/32
+        int32_t  pu = u - 0x8000 + 0x400, pv = v - 0x8000 + 0x400;
+        int32_t  sx = pu < 0x400 ? 0 : pu >> 16;
+        int32_t  sy = pv < 0x400 ? 0 : pv >> 16;
+        uint32_t wx = pu < 0x400 ? 0 : (pu >> 11) & 0x1F;
+        uint32_t wy = pv < 0x400 ? 0 : (pv >> 11) & 0x1F;
+        int32_t  nx = (sx < sw - 1) ? 1 : 0;
+        int32_t  ny = (sy < sh - 1) ? 1 : 0;
+
+        uint16_t c[4] = { affineFetch(sx, sy),      affineFetch(sx + nx, sy),
+                          affineFetch(sx, sy + ny), affineFetch(sx + nx, sy + ny) };
+
+        if (useTp) {
+          // The nearest pixel decides transparency, transparent neighbours take its colour
+          uint16_t near = c[((v >> 16) - sy) * 2 + (u >> 16) - sx];
+          if (near == tp) { *out++ = tp; continue; }
+          for (uint8_t k = 0; k < 4; k++) if (c[k] == tp) c[k] = near;
         }
+
+        uint16_t color = blend565x4(c[0], c[1], c[2], c[3], wx, wy);
+        if (useTp && color == tp) color ^= 0x0001; // A blend must not become transparent
+        *out++ = color;
       }
-      else {
-        sline_buffer[pixel_count++] = rp;
+    }
+    else if (_bpp == 16) {
+      while (n--) { *out++ = _img[(u >> 16) + (v >> 16) * _iwidth]; u += dux; v += dvx; }
+    }
+    else if (_bpp == 8) {
+      while (n--) { *out++ = affineFetch8(u >> 16, v >> 16);  u += dux; v += dvx; }
+    }
+    else if (_bpp == 4) {
+      while (n--) { *out++ = affineFetch4(u >> 16, v >> 16);  u += dux; v += dvx; }
+    }
+    else {
+      while (n--) { *out++ = affineFetch1(u >> 16, v >> 16);  u += dux; v += dvx; }
+    }
+
+    // Push the runs of opaque pixels
+    n = k1 - k0 + 1;
+    int32_t i = 0;
+    while (i < n) {
+      if (useTp) while (i < n && lineBuf[i] == tp) i++;
+      int32_t j = i;
+      if (useTp) while (j < n && lineBuf[j] != tp) j++;
+      else j = n;
+      if (j > i) {
+        int32_t x = x0 + k0 + i;
+        if (spr) spr->pushImage(x - xDatum, y - yDatum, j - i, 1, lineBuf + i);
+        else {
+          // TFT window is already clipped, so this is faster than pushImage()
+          _tft->setWindow(x, y, x + j - i - 1, y);
+          _tft->pushPixels(lineBuf + i, j - i);
+          BUS_STAT_PIXELS_ON(_tft, j - i);
+        }
+        drawn = true;
       }
-    } while (++x < max_x && (xs += _cosra) < xe && (ys += _sinra) < ye);
-    if (pixel_count) spr->pushImage(x - pixel_count, y, pixel_count, 1, sline_buffer);
+      i = j;
+    }
   }
-  spr->setSwapBytes(oldSwapBytes);
-  return true;
+
+  dst->setSwapBytes(oldSwapBytes);
+
+  return drawn;
 }
 
 
@@ -646,9 +986,6 @@ void TFT_eSprite::getRotatedBounds(int16_t angle, int16_t w, int16_t h, int16_t
   if (y1 > *max_y) *max_y = y1+2;
   if (y2 > *max_y) *max_y = y2+2;
   if (y3 > *max_y) *max_y = y3+2;
-
-  _sinra = round(sina * (1<<FP_SCALE));
-  _cosra = round(cosa * (1<<FP_SCALE));
 }
 
 
@@ -660,8 +997,12 @@ void TFT_eSprite::pushSprite(int32_t x, int32_t y)
 {
   if (!_created) return;
 
+  BUS_STAT_SCOPE_ON(_tft, STAT_PUSH_SPRITE);
+
   if (_bpp == 16)
   {
+    if (_tft->DMA_Enabled && getMemoryInfo().staged) { pushSpriteStaged(x, y); return; }
+
     bool oldSwapBytes = _tft->getSwapBytes();
     _tft->setSwapBytes(false);
     _tft->pushImage(x, y, _dwidth, _dheight, _img );
@@ -683,11 +1024,14 @@ void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transp)
 {
   if (!_created) return;
 
+  BUS_STAT_SCOPE_ON(_tft, STAT_PUSH_SPRITE);
+
   if (_bpp == 16)
   {
     bool oldSwapBytes = _tft->getSwapBytes();
     _tft->setSwapBytes(false);
-    _tft->pushImage(x, y, _dwidth, _dheight, _img, transp );
+    if (_spanCache && buildSpanCache(transp)) _tft->pushImageSpans(x, y, _dwidth, _dheight, _img, _spans);
+    else _tft->pushImage(x, y, _dwidth, _dheight, _img, transp );
     _tft->setSwapBytes(oldSwapBytes);
   }
   else if (_bpp == 8)
@@ -703,6 +1047,55 @@ void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transp)
 }
 
 
+/***************************************************************************************
+** Function name:           cacheSpans
+** Description:             Keep a list of the opaque spans for transparent pushes
+***************************************************************************************/
+bool TFT_eSprite::cacheSpans(bool enable)
+{
+  if (!enable || _bpp != 16) {
+    freeMemory(_imgAllocator, _spans);
+    _spans     = nullptr;
+    _spanSize  = 0;
+    _spanValid = false;
+    _spanCache = false;
+    return !enable;
+  }
+
+  _spanCache = true;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           buildSpanCache
+** Description:             Make sure the span list matches the Sprite and transp
+***************************************************************************************/
+bool TFT_eSprite::buildSpanCache(uint16_t transp)
+{
+  if (_spanValid && _spanKey == transp) return true;
+
+  // Sprite pixels are stored in TFT byte order
+  uint16_t key = transp >> 8 | transp << 8;
+
+  // The list is rebuilt in place if the spans still fit
+  uint32_t used = buildSpans(_img, _dwidth, _dheight, key, _spans, _spanSize);
+
+  if (used > _spanSize) {
+    freeMemory(_imgAllocator, _spans);
+    // Allow some extra space so small changes to the Sprite do not need a new list
+    _spanSize = used + used / 4;
+    _spans = (uint16_t*) allocMemory(_imgAllocator, _spanSize * 2);
+    if (_spans == nullptr) { _spanSize = 0; _spanValid = false; return false; }
+    buildSpans(_img, _dwidth, _dheight, key, _spans, _spanSize);
+  }
+
+  _spanKey   = transp;
+  _spanValid = true;
+  return true;
+}
+
+
 /***************************************************************************************
 ** Function name:           pushToSprite
 ** Description:             Push the sprite to another sprite at x, y
@@ -802,8 +1195,13 @@ bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int
 {
   if (!_created) return false;
 
-  // Perform window boundary checks and crop if needed
+  BUS_STAT_SCOPE_ON(_tft, STAT_PUSH_SPRITE);
+
+  // Perform window boundary checks and crop if needed, this is not a write to the sprite
+  bool trackDirty = _trackDirty;
+  _trackDirty = false;
   setWindow(sx, sy, sx + sw - 1, sy + sh - 1);
+  _trackDirty = trackDirty;
 
   /* These global variables are now populated for the sprite
   _xs = x start coordinate
@@ -891,6 +1289,223 @@ bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int
 }
 
 
+/***************************************************************************************
+** Function name:           pushSpriteScaled
+** Description:             Push the sprite to the TFT scaled to dw x dh pixels
+***************************************************************************************/
+bool TFT_eSprite::pushSpriteScaled(int32_t x, int32_t y, int32_t dw, int32_t dh, uint8_t mode)
+{
+  if (!_created || _bpp != 16) return false;
+
+  BUS_STAT_SCOPE_ON(_tft, STAT_PUSH_SPRITE);
+
+  // Sprite pixels are in TFT byte order
+  bool oldSwapBytes = _tft->getSwapBytes();
+  _tft->setSwapBytes(false);
+  _tft->pushImageScaled(x, y, dw, dh, _dwidth, _dheight, _img, mode);
+  _tft->setSwapBytes(oldSwapBytes);
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           trackDirty
+** Description:             Enable or disable recording of the sprite areas drawn
+***************************************************************************************/
+void TFT_eSprite::trackDirty(bool enable)
+{
+  // Areas drawn while tracking was off are not known, so the TFT copy may be stale
+  if (enable && !_trackDirty && _created) markDirty(0, 0, _dwidth, _dheight);
+
+  _trackDirty = enable;
+  if (!enable) _dirtyCount = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           markDirty
+** Description:             Add an area in sprite coordinates to the dirty list
+***************************************************************************************/
+void TFT_eSprite::markDirty(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  if (!_created) return;
+
+  _spanValid = false;
+
+  // Cropped pushSprite() of 1bpp Sprites sends whole lines, and the coordinates
+  // of rotated 1bpp Sprites do not match the memory layout, so widen the area
+  if (_bpp == 1) {
+    if (rotation) { y = 0; h = _dheight; }
+    x = 0; w = _dwidth;
+  }
+
+  int32_t x1 = x + w - 1;
+  int32_t y1 = y + h - 1;
+
+  if (x < 0) x = 0;
+  if (y < 0) y = 0;
+  if (x1 >= _dwidth)  x1 = _dwidth  - 1;
+  if (y1 >= _dheight) y1 = _dheight - 1;
+
+  if ((x > x1) || (y > y1)) return;
+
+  uint8_t i;
+
+  // Done if the area is already in the list, checking the last merged entry first
+  // makes repeated pixel and line plots within one area quick
+  for (i = _dirtyCount; i--; ) {
+    dirtyRect_t *d = &_dirty[i];
+    if ((x >= d->x0) && (x1 <= d->x1) && (y >= d->y0) && (y1 <= d->y1)) return;
+  }
+
+  // Combine with an entry that overlaps or touches the area
+  for (i = 0; i < _dirtyCount; i++) {
+    dirtyRect_t *d = &_dirty[i];
+    if ((x <= d->x1 + 1) && (d->x0 <= x1 + 1) && (y <= d->y1 + 1) && (d->y0 <= y1 + 1)) break;
+  }
+
+  if ((i == _dirtyCount) && (_dirtyCount < SPRITE_DIRTY_RECTS)) {
+    _dirty[_dirtyCount++] = { (int16_t)x, (int16_t)y, (int16_t)x1, (int16_t)y1 };
+    return;
+  }
+
+  // List is full, so merge with the entry that grows by the smallest area
+  if (i == _dirtyCount) {
+    uint32_t best = UINT32_MAX;
+    for (uint8_t j = 0; j < _dirtyCount; j++) {
+      dirtyRect_t *d = &_dirty[j];
+      int32_t ux0 = (x  < d->x0) ? x  : d->x0;
+      int32_t uy0 = (y  < d->y0) ? y  : d->y0;
+      int32_t ux1 = (x1 > d->x1) ? x1 : d->x1;
+      int32_t uy1 = (y1 > d->y1) ? y1 : d->y1;
+      uint32_t growth = (ux1 - ux0 + 1) * (uy1 - uy0 + 1) - (d->x1 - d->x0 + 1) * (d->y1 - d->y0 + 1);
+      if (growth < best) { best = growth; i = j; }
+    }
+  }
+
+  dirtyRect_t *d = &_dirty[i];
+  if (x  < d->x0) d->x0 = x;
+  if (y  < d->y0) d->y0 = y;
+  if (x1 > d->x1) d->x1 = x1;
+  if (y1 > d->y1) d->y1 = y1;
+
+  // The grown entry may now overlap or touch others, so absorb them
+  bool merged;
+  do {
+    merged = false;
+    for (uint8_t j = 0; j < _dirtyCount; j++) {
+      dirtyRect_t *e = &_dirty[j];
+      if (e == d) continue;
+      if ((e->x0 <= d->x1 + 1) && (d->x0 <= e->x1 + 1) && (e->y0 <= d->y1 + 1) && (d->y0 <= e->y1 + 1)) {
+        if (e->x0 < d->x0) d->x0 = e->x0;
+        if (e->y0 < d->y0) d->y0 = e->y0;
+        if (e->x1 > d->x1) d->x1 = e->x1;
+        if (e->y1 > d->y1) d->y1 = e->y1;
+        // Remove entry j by moving the last entry into its place
+        _dirtyCount--;
+        if (d == &_dirty[_dirtyCount]) d = e;
+        *e = _dirty[_dirtyCount];
+        merged = true;
+        break;
+      }
+    }
+  } while (merged);
+}
+
+
+/***************************************************************************************
+** Function name:           pushSpriteDirty
+** Description:             Push only the dirty areas of the sprite to the TFT at x, y
+***************************************************************************************/
+bool TFT_eSprite::pushSpriteDirty(int32_t x, int32_t y)
+{
+  if (!_created || !_dirtyCount) return false;
+
+  _tft->startWrite(); // Hold the transaction over all the areas
+
+  for (uint8_t i = 0; i < _dirtyCount; i++) {
+    dirtyRect_t *d = &_dirty[i];
+    pushSprite(x + d->x0, y + d->y0, d->x0, d->y0, d->x1 - d->x0 + 1, d->y1 - d->y0 + 1);
+  }
+
+  _tft->endWrite();
+
+  _dirtyCount = 0;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           pushBanded
+** Description:             Render an area of the TFT a band at a time using the sprite
+***************************************************************************************/
+bool TFT_eSprite::pushBanded(int32_t x, int32_t y, int32_t h, bandScene_t scene, void *param)
+{
+  if (!_created || scene == nullptr || h < 1) return false;
+
+  resetViewport();
+
+  int32_t bw = width();
+  int32_t bh = height();
+
+  _tft->startWrite();
+
+#if defined (RP2040_DMA) || ((defined (ESP32_DMA) || defined (STM32_DMA)) && !defined (TFT_PARALLEL_8_BIT))
+  // Second frame buffer is needed so the band being sent is not overwritten
+  if ((_bpp == 16) && (_img8_2 != _img8_1) && _tft->DMA_Enabled) {
+    bool oldSwapBytes = _tft->getSwapBytes();
+    _tft->setSwapBytes(false); // Sprite colours are already in TFT byte order
+    uint8_t frame = 1;
+
+    for (int32_t by = y; by < y + h; by += bh) {
+      int32_t rows = y + h - by;
+      if (rows > bh) rows = bh;
+
+  #ifdef DMA_QUEUE_SIZE
+      // With a DMA queue the band sent from this frame may still be queued, only the
+      // band sent from the other frame can be in flight once it has finished
+      while (_tft->dmaQueueDepth() > 1) yield();
+  #endif
+      frameBuffer(frame);
+
+      // Offset the datum so the scene draws in TFT coordinates, drawing outside the band is clipped
+      setViewport(-x, -by, bw + x, rows + by, true);
+      scene(this, param);
+      resetViewport();
+
+      _tft->pushImageDMA(x, by, bw, rows, _img);
+      frame = 3 - frame;
+    }
+
+    _tft->dmaWait();
+    frameBuffer(1);
+    _tft->setSwapBytes(oldSwapBytes);
+
+    _tft->endWrite();
+    return true;
+  }
+#endif
+
+  for (int32_t by = y; by < y + h; by += bh) {
+    int32_t rows = y + h - by;
+    if (rows > bh) rows = bh;
+
+    // Offset the datum so the scene draws in TFT coordinates, drawing outside the band is clipped
+    setViewport(-x, -by, bw + x, rows + by, true);
+    scene(this, param);
+    resetViewport();
+
+    pushSprite(x, by, 0, 0, bw, rows);
+  }
+
+  _tft->endWrite();
+
+  return true;
+}
+
+
 /***************************************************************************************
 ** Function name:           readPixelValue
 ** Description:             Read the color map index of a pixel at defined coordinates
@@ -1034,6 +1649,9 @@ void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_
 
   PI_CLIP;
 
+  _spanValid = false;
+  if (_trackDirty) markDirty(x, y, dw, dh);
+
   if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
   {
     // Pointer within original image
@@ -1177,6 +1795,9 @@ void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const u
 
   PI_CLIP;
 
+  _spanValid = false;
+  if (_trackDirty) markDirty(x, y, dw, dh);
+
   if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
   {
     for (int32_t yp = dy; yp < dy + dh; yp++)
@@ -1245,6 +1866,45 @@ void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const u
 }
 
 
+/***************************************************************************************
+** Function name:           pushImageScaled
+** Description:             push a 16-bit image scaled to a new size into the sprite
+***************************************************************************************/
+void TFT_eSprite::pushImageScaled(int32_t x, int32_t y, int32_t dw, int32_t dh, int32_t sw, int32_t sh,
+                                  const uint16_t *data, uint8_t mode)
+{
+  if (!_created || _vpOoB || data == nullptr || dw < 1 || dh < 1 || sw < 1 || sh < 1) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping, i and j are the first destination pixel and row inside the viewport
+  int32_t i = 0, j = 0, w = dw, h = dh;
+
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { i = _vpX - x; w -= i; x = _vpX; }
+  if (y < _vpY) { j = _vpY - y; h -= j; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  uint16_t lineBuf[w];
+
+  // The rows are made in processor byte order
+  bool swap = _swapBytes; _swapBytes = true;
+
+  for (int32_t row = 0; row < h; row++) {
+    scaleImageRow(lineBuf, data, sw, sh, dw, dh, i, j + row, w, mode, !swap);
+    pushImage(x - _xDatum, y + row - _yDatum, w, 1, lineBuf);
+  }
+
+  _swapBytes = swap;
+}
+
+
 /***************************************************************************************
 ** Function name:           setWindow
 ** Description:             Set the bounds of a window in the sprite
@@ -1255,8 +1915,10 @@ void TFT_eSprite::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
   if (x0 > x1) transpose(x0, x1);
   if (y0 > y1) transpose(y0, y1);
   
-  int32_t w = width();
-  int32_t h = height();
+  // Window is in sprite pixel coordinates so clip to the sprite, not the viewport
+  int32_t w = _dwidth;
+  int32_t h = _dheight;
+  if ((_bpp == 1) && (rotation & 1)) { w = _dheight; h = _dwidth; }
 
   if ((x0 >= w) || (x1 < 0) || (y0 >= h) || (y1 < 0))
   { // Point to that extra "off screen" pixel
@@ -1276,6 +1938,10 @@ void TFT_eSprite::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
     _ys = y0;
     _xe = x1;
     _ye = y1;
+
+    // Pixels will be written to the window with pushColor() or writeColor()
+    _spanValid = false;
+    if (_trackDirty) markDirty(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
   }
 
   _xptr = _xs;
@@ -1283,6 +1949,46 @@ void TFT_eSprite::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
 }
 
 
+/***************************************************************************************
+** Function name:           readSpan
+** Description:             Read a line of colours at a clipped Sprite position
+***************************************************************************************/
+// Coordinates include the datum, colours are returned in 565 format
+void TFT_eSprite::readSpan(int32_t xs, int32_t ys, uint16_t *color, int32_t len)
+{
+  if (_bpp == 16) {
+    const uint16_t *src = _img + xs + ys * _iwidth;
+    for (int32_t i = 0; i < len; i++) color[i] = (src[i] >> 8) | (src[i] << 8);
+  }
+  else {
+    for (int32_t i = 0; i < len; i++) color[i] = readPixel(xs - _xDatum + i, ys - _yDatum);
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushSpan
+** Description:             Write a line of colours at a clipped Sprite position
+***************************************************************************************/
+// Coordinates include the datum, colours are in 565 format
+void TFT_eSprite::pushSpan(int32_t xs, int32_t ys, const uint16_t *color, int32_t len)
+{
+  if (!_created) return;
+
+  if (_bpp == 16 || _bpp == 8) {
+    _spanValid = false;
+    if (_trackDirty) markDirty(xs, ys, len, 1);
+
+    if (_bpp == 16) {
+      uint16_t *dst = _img + xs + ys * _iwidth;
+      for (int32_t i = 0; i < len; i++) dst[i] = (color[i] >> 8) | (color[i] << 8);
+    }
+    else color16to8(color, _img8 + xs + ys * _iwidth, len);
+  }
+  else TFT_eSPI::pushSpan(xs, ys, color, len);
+}
+
+
 /***************************************************************************************
 ** Function name:           pushColor
 ** Description:             Send a new pixel to the set window
@@ -1411,12 +2117,65 @@ void TFT_eSprite::setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint
 }
 
 
+/***************************************************************************************
+** Function name:           scrollBits - helper function for scroll
+** Description:             Copy n bits from src bit sbit to dst bit dbit
+***************************************************************************************/
+// 1 and 4bpp Sprite lines are streams of bits, most significant bit first, so pixels are
+// moved by copying bits. Each destination byte is made from the two source bytes that it
+// overlaps with a funnel shift, or by memmove() if the bit offsets are the same. dst and
+// src may be the same line, the copy then runs backwards if the bits move right
+static void scrollBits(uint8_t *dst, int32_t dbit, const uint8_t *src, int32_t sbit, int32_t n)
+{
+  int32_t k0 = dbit >> 3, k1 = (dbit + n - 1) >> 3; // Destination bytes
+  int32_t s0 = sbit >> 3, s1 = (sbit + n - 1) >> 3; // Source bytes that can be read
+
+  uint8_t mask0 = 0xFF >> (dbit & 7);
+  uint8_t mask1 = 0xFF << (7 - ((dbit + n - 1) & 7));
+  if (k0 == k1) mask0 &= mask1;
+
+  // Destination byte k is made from source bytes k + off and k + off + 1
+  int32_t off = (sbit - dbit) >> 3;
+  uint8_t sh  = (sbit - dbit) & 7;
+
+  // The end bytes are made first as the middle may overwrite their source, only these
+  // can need source bytes outside the bits being copied
+  uint8_t first, last;
+  if (sh == 0) {
+    first = src[k0 + off];
+    last  = src[k1 + off];
+  }
+  else {
+    int32_t i = k0 + off;
+    first = ((i >= s0 ? src[i] << sh : 0) | (i + 1 <= s1 ? src[i + 1] >> (8 - sh) : 0));
+    i = k1 + off;
+    last  = ((i >= s0 ? src[i] << sh : 0) | (i + 1 <= s1 ? src[i + 1] >> (8 - sh) : 0));
+  }
+
+  if (k1 - k0 > 1) {
+    if (sh == 0) memmove(dst + k0 + 1, src + k0 + off + 1, k1 - k0 - 1);
+    else if ((dst == src) && (dbit > sbit)) {
+      for (int32_t k = k1 - 1; k > k0; k--) dst[k] = src[k + off] << sh | src[k + off + 1] >> (8 - sh);
+    }
+    else {
+      for (int32_t k = k0 + 1; k < k1; k++) dst[k] = src[k + off] << sh | src[k + off + 1] >> (8 - sh);
+    }
+  }
+
+  dst[k0] = (dst[k0] & ~mask0) | (first & mask0);
+  if (k1 != k0) dst[k1] = (dst[k1] & ~mask1) | (last & mask1);
+}
+
+
 /***************************************************************************************
 ** Function name:           scroll
 ** Description:             Scroll dx,dy pixels, positive right,down, negative left,up
 ***************************************************************************************/
 void TFT_eSprite::scroll(int16_t dx, int16_t dy)
 {
+  _spanValid = false;
+  if (_trackDirty) markDirty(_sx, _sy, _sw, _sh);
+
   if (abs(dx) >= _sw || abs(dy) >= _sh)
   {
     fillRect (_sx, _sy, _sw, _sh, _scolor);
@@ -1470,10 +2229,25 @@ void TFT_eSprite::scroll(int16_t dx, int16_t dy)
       fyp += iw;
     }
   }
+  else if ((_bpp == 4 || (_bpp == 1 && rotation == 0)) && _xDatum == 0 && _yDatum == 0 &&
+           _vpX == 0 && _vpY == 0 && _vpW >= _dwidth && _vpH >= _dheight)
+  {
+    // Copy packed lines, a pixel is 4 bits or 1 bit of the line
+    uint8_t  shift  = (_bpp == 4) ? 2 : 0;
+    int32_t  stride = (_bpp == 4) ? (_iwidth >> 1) : (_bitwidth >> 3);
+    uint8_t *img    = (_bpp == 4) ? _img4 : _img8;
+    int32_t  ystep  = (dy > 0) ? -1 : 1;
+    while (h--)
+    {
+      scrollBits(img + ty * stride, tx << shift, img + fy * stride, fx << shift, w << shift);
+      ty += ystep;
+      fy += ystep;
+    }
+  }
   else if (_bpp == 4)
   {
-    // could optimize for scrolling by even # pixels using memove (later)
-    if (dx >  0) { tx += w; fx += w; } // Start from right edge
+    // Pixel by pixel when a viewport or the datum has been set
+    if (dx >  0) { tx += w - 1; fx += w - 1; } // Start from right edge
     while (h--)
     { // move pixels one by one
       for (uint16_t xp = 0; xp < w; xp++)
@@ -1487,7 +2261,8 @@ void TFT_eSprite::scroll(int16_t dx, int16_t dy)
   }
   else if (_bpp == 1 )
   {
-    if (dx >  0) { tx += w; fx += w; } // Start from right edge
+    // Pixel by pixel when rotated, or a viewport or the datum has been set
+    if (dx >  0) { tx += w - 1; fx += w - 1; } // Start from right edge
     while (h--)
     { // move pixels one by one
       for (uint16_t xp = 0; xp < w; xp++)
@@ -1520,6 +2295,9 @@ void TFT_eSprite::fillSprite(uint32_t color)
   // Use memset if possible as it is super fast
   if(_xDatum == 0 && _yDatum == 0  &&  _xWidth == width())
   {
+    _spanValid = false;
+    if (_trackDirty) markDirty(_vpX, _vpY, _xWidth, _yHeight);
+
     if(_bpp == 16) {
       if ( (uint8_t)color == (uint8_t)(color>>8) ) {
         memset(_img,  (uint8_t)color, _iwidth * _yHeight * 2);
@@ -1637,6 +2415,9 @@ void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color)
   // Range checking
   if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return;
 
+  _spanValid = false;
+  if (_trackDirty) markDirty(x, y, 1, 1);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
@@ -1761,6 +2542,9 @@ void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
 
   if (h < 1) return;
 
+  _spanValid = false;
+  if (_trackDirty) markDirty(x, y, 1, h);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
@@ -1822,6 +2606,9 @@ void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
 
   if (w < 1) return;
 
+  _spanValid = false;
+  if (_trackDirty) markDirty(x, y, w, 1);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
@@ -1887,6 +2674,9 @@ void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t
 
   if ((w < 1) || (h < 1)) return;
 
+  _spanValid = false;
+  if (_trackDirty) markDirty(x, y, w, h);
+
   int32_t yp = _iwidth * y + x;
 
   if (_bpp == 16)
@@ -1977,6 +2767,120 @@ void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t
 }
 
 
+/***************************************************************************************
+** Function name:           fillRectGradient
+** Description:             fill a rectangle with a linear, radial or conic gradient
+***************************************************************************************/
+void TFT_eSprite::fillRectGradient(int32_t x, int32_t y, int32_t w, int32_t h, const tftGradient_t *g)
+{
+  if (!_created || _vpOoB || g == nullptr) return;
+
+  // The ramp holds 565 colours, which have no meaning in a palette Sprite
+  if (_bpp < 8) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  _spanValid = false;
+  if (_trackDirty) markDirty(x, y, w, h);
+
+  if (_bpp == 16)
+  {
+    // Sprite pixels are held in the same byte order as the gradient ramp
+    for (int32_t yp = 0; yp < h; yp++)
+      gradientSpan(g, _img + x + (y + yp) * _iwidth, x - _xDatum, y + yp - _yDatum, w);
+    return;
+  }
+
+  // 8-bit Sprite, the ramp colours are converted a line at a time
+  uint16_t lineBuf[w];
+  for (int32_t yp = 0; yp < h; yp++) {
+    gradientSpan(g, lineBuf, x - _xDatum, y + yp - _yDatum, w);
+    color16to8(lineBuf, _img8 + x + (y + yp) * _iwidth, w, true);
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           drawPixels
+** Description:             draw n pixels, each with its own colour
+***************************************************************************************/
+void TFT_eSprite::drawPixels(const tftPoint_t *point, const uint16_t *colors, uint32_t n)
+{
+  if (!_created || _vpOoB || point == nullptr || colors == nullptr) return;
+
+  // 4 and 1 bit pixels are packed in bytes and may be rotated
+  if (_bpp != 16 && _bpp != 8) {
+    for (uint32_t i = 0; i < n; i++) drawPixel(point[i].x, point[i].y, colors[i]);
+    return;
+  }
+
+  _spanValid = false;
+
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t x = point[i].x + _xDatum;
+    int32_t y = point[i].y + _yDatum;
+
+    if ((x < _vpX) || (y < _vpY) || (x >= _vpW) || (y >= _vpH)) continue;
+
+    if (_trackDirty) markDirty(x, y, 1, 1);
+
+    uint16_t color = colors[i];
+    if (_bpp == 16) _img[x + y * _iwidth] = (color >> 8) | (color << 8);
+    else _img8[x + y * _iwidth] = (uint8_t)((color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3);
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           drawPolyline
+** Description:             draw lines joining n points
+***************************************************************************************/
+void TFT_eSprite::drawPolyline(const tftPoint_t *point, uint32_t n, uint32_t color)
+{
+  if (!_created || _vpOoB || point == nullptr || n == 0) return;
+
+  if (n == 1) drawPixel(point[0].x, point[0].y, color);
+
+  for (uint32_t i = 1; i < n; i++) drawLine(point[i - 1].x, point[i - 1].y, point[i].x, point[i].y, color);
+}
+
+
+/***************************************************************************************
+** Function name:           fillRects
+** Description:             fill n rectangles with one colour
+***************************************************************************************/
+void TFT_eSprite::fillRects(const tftRect_t *rect, uint32_t n, uint32_t color)
+{
+  if (!_created || _vpOoB || rect == nullptr) return;
+
+  for (uint32_t i = 0; i < n; i++) fillRect(rect[i].x, rect[i].y, rect[i].w, rect[i].h, color);
+}
+
+
+/***************************************************************************************
+** Function name:           drawHLines
+** Description:             draw n horizontal lines, each with its own colour
+***************************************************************************************/
+void TFT_eSprite::drawHLines(const tftSpan_t *span, uint32_t n)
+{
+  if (!_created || _vpOoB || span == nullptr) return;
+
+  for (uint32_t i = 0; i < n; i++) drawFastHLine(span[i].x, span[i].y, span[i].w, span[i].color);
+}
+
+
 /***************************************************************************************
 ** Function name:           drawChar
 ** Description:             draw a single character in the Adafruit GLCD or freefont
@@ -2190,7 +3094,7 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
 
   int32_t width  = 0;
   int32_t height = 0;
-  uint32_t flash_address = 0;
+  uintptr_t flash_address = 0;
   uniCode -= 32;
 
 #ifdef LOAD_FONT2
@@ -2496,6 +3400,9 @@ void TFT_eSprite::drawGlyph(uint16_t code)
     int16_t  bxs = cx;
     uint32_t bl = 0;
     int16_t  bx = 0;
+    int16_t  axs = cx;
+    uint32_t al = 0;
+    uint8_t  aBuf[gWidth[gNum] + 1]; // Alpha values of a run of edge pixels
     uint8_t pixel = 0;
 
     int16_t fillwidth  = 0;
@@ -2551,17 +3458,19 @@ void TFT_eSprite::drawGlyph(uint16_t code)
               else drawFastHLine( fxs, y + cy, fl, fg);
               fl = 0;
             }
-            if (getBG) bg = readPixel(x + cx, y + cy);
-            drawPixel(x + cx, y + cy, alphaBlend(pixel, fg, bg));
+            if (al == 0) axs = x + cx;
+            aBuf[al++] = pixel;
           }
           else
           {
+            if (al) { drawAlphaSpan(axs, y + cy, aBuf, al, fg, getBG ? 0x00FFFFFF : bg); al = 0; }
             if (fl==0) fxs = x + cx;
             fl++;
           }
         }
         else
         {
+          if (al) { drawAlphaSpan(axs, y + cy, aBuf, al, fg, getBG ? 0x00FFFFFF : bg); al = 0; }
           if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
           if (_fillbg) {
             if (x >= bx) {
@@ -2571,6 +3480,7 @@ void TFT_eSprite::drawGlyph(uint16_t code)
           }
         }
       }
+      if (al) { drawAlphaSpan(axs, y + cy, aBuf, al, fg, getBG ? 0x00FFFFFF : bg); al = 0; }
       if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
       if (bl) { drawFastHLine( bxs, y + cy, bl, bg); bl = 0; }
     }
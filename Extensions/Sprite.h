@@ -5,6 +5,46 @@
 // graphics are written to the Sprite rather than the TFT.
 ***************************************************************************************/
 
+// Maximum number of separate dirty areas tracked, overlapping and adjacent areas are
+// combined and when the list is full the new area is merged with the closest one
+#ifndef SPRITE_DIRTY_RECTS
+  #define SPRITE_DIRTY_RECTS 8
+#endif
+
+// 2x3 affine transform for pushAffine(), maps Sprite pixel x,y to the destination at
+//   a * x + b * y + tx, c * x + d * y + ty
+// so it can rotate, scale and shear the Sprite. Pixel centres are at whole coordinates
+typedef struct {
+  float a, b, tx;
+  float c, d, ty;
+} tftAffine_t;
+
+// Sprite memory placement hints for setMemoryPlacement(), the memory is taken from the
+// first region in the chain that has space. Hints other than SPRITE_MEM_AUTO only change
+// the placement on an ESP32, other processors use the heap
+#define SPRITE_MEM_AUTO     0 // PSRAM if enabled (except 16bpp with DMA), else internal RAM
+#define SPRITE_MEM_DMA      1 // DMA capable internal RAM, then internal RAM, then PSRAM
+#define SPRITE_MEM_INTERNAL 2 // Internal RAM, then PSRAM
+#define SPRITE_MEM_PSRAM    3 // PSRAM, then internal RAM
+
+// Where the Sprite memory is, see getMemoryInfo()
+#define SPRITE_IN_NONE      0 // Sprite not created
+#define SPRITE_IN_DMA       1 // Internal RAM that DMA can read (ESP32)
+#define SPRITE_IN_INTERNAL  2 // Internal RAM
+#define SPRITE_IN_PSRAM     3 // External PSRAM
+
+// Pixels in each of the two DMA buffers used by setStaging()
+#ifndef SPRITE_STAGE_PIXELS
+  #define SPRITE_STAGE_PIXELS 1024
+#endif
+
+typedef struct {
+  uint8_t  location; // SPRITE_IN_xxx
+  uint8_t  cost;     // Approximate relative cost of reading the memory, 1 for internal RAM
+  bool     staged;   // pushSprite() sends the Sprite through the internal DMA buffers
+  uint32_t bytes;    // Size of the Sprite memory including both frames
+} tftSpriteMemory_t;
+
 class TFT_eSprite : public TFT_eSPI {
 
  public:
@@ -21,6 +61,18 @@ class TFT_eSprite : public TFT_eSPI {
            //  - 2 bytes per pixel for 16-bit color depth (565 RGB format)
   void*    createSprite(int16_t width, int16_t height, uint8_t frames = 1);
 
+           // Set where the memory of the next createSprite() comes from, hint is SPRITE_MEM_xxx.
+           // An allocator set with setAllocator() takes priority over the hint
+  void     setMemoryPlacement(uint8_t hint) { _memPlacement = hint; }
+           // Report where the Sprite memory is and the relative cost of reading it
+  tftSpriteMemory_t getMemoryInfo(void);
+
+           // When enabled, pushSprite(x, y) of a 16-bit Sprite in PSRAM copies blocks of lines
+           // into two internal DMA buffers and sends each with DMA while the next is copied.
+           // DMA must be initialised with initDMA(). Returns false if not supported (ESP32
+           // with PSRAM only) or there is no memory for the buffers
+  bool     setStaging(bool enable);
+
            // Returns a pointer to the sprite or nullptr if not created, user must cast to pointer type
   void*    getPointer(void);
 
@@ -87,6 +139,16 @@ class TFT_eSprite : public TFT_eSPI {
            // Fill a rectangular area with a color (aka draw a filled rectangle)
            fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
 
+           // Fill a rectangle with a gradient set up as for the TFT. 16 and 8 bit Sprites only,
+           // 4 and 1 bit Sprites hold palette indexes so nothing is drawn
+  void     fillRectGradient(int32_t x, int32_t y, int32_t w, int32_t h, const tftGradient_t *g);
+
+           // Batched drawing, as for the TFT but the Sprite memory is written directly
+  void     drawPixels(const tftPoint_t *point, const uint16_t *colors, uint32_t n),
+           drawPolyline(const tftPoint_t *point, uint32_t n, uint32_t color),
+           fillRects(const tftRect_t *rect, uint32_t n, uint32_t color),
+           drawHLines(const tftSpan_t *span, uint32_t n);
+
            // Set the coordinate rotation of the Sprite (for 1bpp Sprites only)
            // Note: this uses coordinate rotation and is primarily for ePaper which does not support
            // CGRAM rotation (like TFT drivers do) within the displays internal hardware
@@ -98,6 +160,17 @@ class TFT_eSprite : public TFT_eSPI {
            // Push a rotated copy of Sprite to another different Sprite with optional transparent colour
   bool     pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp = 0x00FFFFFF);
 
+           // Set m to scale the Sprite by xScale and yScale, shear it by xShear (x moves by
+           // xShear * y) then rotate it clockwise by angle degrees, with the Sprite pivot placed
+           // at x,y on the destination
+  void     setAffine(tftAffine_t *m, float angle, float xScale = 1.0, float yScale = 1.0, float xShear = 0.0,
+                     int32_t x = 0, int32_t y = 0);
+           // Push a copy of the Sprite transformed by m to the TFT or to another Sprite with optional
+           // transparent colour, mode is SCALE_NEAREST or SCALE_BILINEAR. The destination must not
+           // be a 4bpp Sprite. Returns false if nothing could be drawn
+  bool     pushAffine(const tftAffine_t *m, uint32_t transp = 0x00FFFFFF, uint8_t mode = SCALE_NEAREST);
+  bool     pushAffine(TFT_eSprite *spr, const tftAffine_t *m, uint32_t transp = 0x00FFFFFF, uint8_t mode = SCALE_NEAREST);
+
            // Get the TFT bounding box for a rotated copy of this Sprite
   bool     getRotatedBounds(int16_t angle, int16_t *min_x, int16_t *min_y, int16_t *max_x, int16_t *max_y);
            // Get the destination Sprite bounding box for a rotated copy of this Sprite
@@ -117,15 +190,48 @@ class TFT_eSprite : public TFT_eSPI {
            // Write an image (colour bitmap) to the sprite.
   void     pushImage(int32_t x0, int32_t y0, int32_t w, int32_t h, uint16_t *data, uint8_t sbpp = 0);
   void     pushImage(int32_t x0, int32_t y0, int32_t w, int32_t h, const uint16_t *data);
+           // Scale a 16-bit image into the Sprite, see the TFT_eSPI function
+  void     pushImageScaled(int32_t x, int32_t y, int32_t dw, int32_t dh, int32_t sw, int32_t sh,
+                           const uint16_t *data, uint8_t mode = SCALE_NEAREST);
 
            // Push the sprite to the TFT screen, this fn calls pushImage() in the TFT class.
            // Optionally a "transparent" colour can be defined, pixels of that colour will not be rendered
   void     pushSprite(int32_t x, int32_t y);
   void     pushSprite(int32_t x, int32_t y, uint16_t transparent);
 
+           // Keep a list of the opaque spans of a 16-bit Sprite so repeated pushSprite(x, y, transparent)
+           // calls do not test every pixel. The list is rebuilt by the next push after the Sprite is
+           // drawn to, call markDirty() after writing to the Sprite memory directly. Returns false if
+           // the Sprite is not 16-bit
+  bool     cacheSpans(bool enable = true);
+
            // Push a windowed area of the sprite to the TFT at tx, ty
   bool     pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
 
+           // Push the sprite to the TFT at x, y scaled to dw x dh pixels, mode is SCALE_NEAREST or
+           // SCALE_BILINEAR. Only 16-bit Sprites can be scaled, for 1, 4 and 8-bit Sprites nothing
+           // is drawn and false is returned
+  bool     pushSpriteScaled(int32_t x, int32_t y, int32_t dw, int32_t dh, uint8_t mode = SCALE_NEAREST);
+
+           // Dirty area tracking, when enabled the drawing functions record the sprite areas
+           // changed in a short list and pushSpriteDirty() only sends those areas to the TFT.
+           // Selecting the other frame with frameBuffer() marks the whole sprite dirty
+  void     trackDirty(bool enable = true);
+           // Add an area to the dirty list, e.g. after writing to the sprite memory directly
+  void     markDirty(int32_t x, int32_t y, int32_t w, int32_t h);
+  void     clearDirty(void) { _dirtyCount = 0; }
+  bool     isDirty(void)    { return _dirtyCount > 0; }
+           // Push the dirty areas of a sprite drawn at x, y on the TFT, then clear the list
+  bool     pushSpriteDirty(int32_t x, int32_t y);
+
+           // Banded rendering of an area larger than the sprite. The area is x, y, h on the TFT
+           // with the sprite width, it is split into bands of the sprite height and scene() is
+           // called for each band with the sprite datum set so it draws in TFT coordinates. Each
+           // band is pushed as it is completed. With DMA enabled on the TFT, a 16bpp sprite
+           // created with 2 frames renders the next band while the last one is sent by DMA.
+  typedef  void (*bandScene_t)(TFT_eSprite *band, void *param);
+  bool     pushBanded(int32_t x, int32_t y, int32_t h, bandScene_t scene, void *param = nullptr);
+
            // Push the sprite to another sprite at x,y. This fn calls pushImage() in the destination sprite (dspr) class.
   bool     pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y);
   bool     pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t transparent);
@@ -155,10 +261,27 @@ class TFT_eSprite : public TFT_eSPI {
            // Reserve memory for the Sprite and return a pointer
   void*    callocSprite(int16_t width, int16_t height, uint8_t frames = 1);
 
+           // Transform engine for pushAffine() and pushRotated(), spr is nullptr for the TFT
+  bool     affinePush(TFT_eSprite *spr, const tftAffine_t *m, uint32_t transp, uint8_t mode);
+           // Return the 565 colour of the Sprite pixel at x,y for each colour depth
+  uint16_t affineFetch16(int32_t x, int32_t y), affineFetch8(int32_t x, int32_t y),
+           affineFetch4(int32_t x, int32_t y),  affineFetch1(int32_t x, int32_t y),
+           affineFetch(int32_t x, int32_t y);
+
+           // Push a 16-bit Sprite in PSRAM through the staging buffers
+  void     pushSpriteStaged(int32_t x, int32_t y);
+
+           // Rebuild the opaque span list if the Sprite or transparent colour has changed
+  bool     buildSpanCache(uint16_t transp);
+
            // Override the non-inlined TFT_eSPI functions
   void     begin_nin_write(void) { ; }
   void     end_nin_write(void) { ; }
 
+           // Override the TFT_eSPI span helpers to read and write the Sprite memory
+  void     readSpan(int32_t xs, int32_t ys, uint16_t *color, int32_t len),
+           pushSpan(int32_t xs, int32_t ys, const uint16_t *color, int32_t len);
+
  protected:
 
   uint8_t  _bpp;     // bits per pixel (1, 4, 8 or 16)
@@ -170,8 +293,12 @@ class TFT_eSprite : public TFT_eSPI {
 
   uint16_t *_colorMap; // color map pointer: 16 entries, used with 4-bit color map.
 
-  int32_t  _sinra;   // Sine of rotation angle in fixed point
-  int32_t  _cosra;   // Cosine of rotation angle in fixed point
+  TFT_eAllocator *_imgAllocator = nullptr; // Allocator holding the Sprite memory, nullptr for the heap
+
+  uint8_t  _memPlacement = SPRITE_MEM_AUTO; // Placement hint for callocSprite()
+  uint8_t  _memLocation  = SPRITE_IN_NONE;  // Where the Sprite memory is
+  uint32_t _memBytes     = 0;               // Size of the Sprite memory
+  uint16_t *_stageBuf    = nullptr;         // Two DMA buffers of SPRITE_STAGE_PIXELS for setStaging()
 
   bool     _created; // A Sprite has been created and memory reserved
   bool     _gFont = false; 
@@ -185,4 +312,16 @@ class TFT_eSprite : public TFT_eSPI {
   int32_t  _dwidth, _dheight; // Real sprite width and height (for <8bpp Sprites)
   int32_t  _bitwidth;         // Sprite image bit width for drawPixel (for <8bpp Sprites, not swapped)
 
+  typedef struct { int16_t x0, y0, x1, y1; } dirtyRect_t; // Inclusive corner coordinates
+
+  bool     _trackDirty = false; // Drawing functions add the area changed to the dirty list
+  uint8_t  _dirtyCount = 0;     // Number of dirty rectangles in the list
+  dirtyRect_t _dirty[SPRITE_DIRTY_RECTS];
+
+  bool     _spanCache = false;  // pushSprite() with a transparent colour uses a span list
+  bool     _spanValid = false;  // Span list matches the Sprite content and _spanKey
+  uint16_t _spanKey   = 0;      // Transparent colour used to build the span list
+  uint16_t *_spans    = nullptr;// Span list, see TFT_eSPI::createSpanList()
+  uint32_t _spanSize  = 0;      // Size of the span list buffer in 16-bit words
+
 };
@@ -48,6 +48,20 @@
       spi_host_device_t spi_host = (spi_host_device_t) SPI2_HOST; // Draws once then freezes
     #endif
   #endif
+
+  // Number of pixel transfers queued or in progress
+  uint8_t dmaImages = 0;
+
+  // Colour block repeated by fill blocks and the number of fill transactions in flight
+  uint16_t *dmaFillBuffer = nullptr;
+  uint8_t dmaFills = 0;
+
+  #if (DMA_QUEUE_SIZE > 1)
+    // A queued image is sent as CASET, x range, PASET, y range, RAMWR and pixel transactions
+    #define DMA_TRANS_SIZE 6
+    spi_transaction_t dmaTrans[DMA_QUEUE_SIZE][DMA_TRANS_SIZE];
+    uint8_t dmaSlot = 0; // Next set of transactions to use
+  #endif
 #endif
 
 #if !defined (TFT_PARALLEL_8_BIT)
@@ -494,10 +508,25 @@ void TFT_eSPI::pushBlock(uint16_t color, uint32_t len)
 ***************************************************************************************/
 void TFT_eSPI::pushPixels(const void* data_in, uint32_t len){
 
-  uint16_t *data = (uint16_t*)data_in;
-  // ILI9488 write macro is not endianess dependant, hence !_swapBytes
-  if(!_swapBytes) { while ( len-- ) {tft_Write_16S(*data); data++;} }
-  else { while ( len-- ) {tft_Write_16(*data); data++;} }
+  const uint16_t *data = (const uint16_t*)data_in;
+  uint32_t rgb[15]; // 20 pixels of 3 bytes fill the 64 byte SPI buffer
+
+  while (len)
+  {
+    uint32_t n = (len < 20) ? len : 20;
+
+    // Convert the next pixels while the last ones are sent, the bytes need swapping
+    // when the image is in TFT byte order, hence !_swapBytes
+    color16to18(data, (uint8_t*)rgb, n, !_swapBytes);
+    data += n;
+    len  -= n;
+
+    while (READ_PERI_REG(SPI_CMD_REG(SPI_PORT))&SPI_USR);
+    SET_PERI_REG_BITS(SPI_MOSI_DLEN_REG(SPI_PORT), SPI_USR_MOSI_DBITLEN, (n * 24) - 1, SPI_USR_MOSI_DBITLEN_S);
+    for (uint32_t i = 0; i < (n * 3 + 3) >> 2; i++) WRITE_PERI_REG((SPI_W0_REG(SPI_PORT) + (i << 2)), rgb[i]);
+    SET_PERI_REG_MASK(SPI_CMD_REG(SPI_PORT), SPI_USR);
+  }
+  while (READ_PERI_REG(SPI_CMD_REG(SPI_PORT))&SPI_USR);
 }
 
 /***************************************************************************************
@@ -570,6 +599,29 @@ void TFT_eSPI::pushPixels(const void* data_in, uint32_t len){
 #if defined (ESP32_DMA) && !defined (TFT_PARALLEL_8_BIT) //       DMA FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////
 
+/***************************************************************************************
+** Function name:           dmaResult
+** Description:             Collect a finished transaction, false if none before timeout
+***************************************************************************************/
+static bool dmaResult(TFT_eSPI *tft, TickType_t wait)
+{
+  spi_transaction_t *rtrans;
+  if (spi_device_get_trans_result(dmaHAL, &rtrans, wait) != ESP_OK) return false;
+
+  tft->spiBusyCheck--;
+
+  // Address window commands use tx_data, image transfers hold their buffer in user
+  if (rtrans->tx_buffer == dmaFillBuffer) dmaFills--;
+  else if (!(rtrans->flags & SPI_TRANS_USE_TXDATA)) {
+    dmaImages--;
+    dmaDoneCallback dmaDone = tft->getDMACallback();
+    if (dmaDone) dmaDone((uint16_t*)rtrans->user);
+  }
+
+  return true;
+}
+
+
 /***************************************************************************************
 ** Function name:           dmaBusy
 ** Description:             Check if DMA is busy
@@ -578,13 +630,11 @@ bool TFT_eSPI::dmaBusy(void)
 {
   if (!DMA_Enabled || !spiBusyCheck) return false;
 
-  spi_transaction_t *rtrans;
-  esp_err_t ret;
+  // Transactions complete in order, so stop at the first one still in progress
   uint8_t checks = spiBusyCheck;
   for (int i = 0; i < checks; ++i)
   {
-    ret = spi_device_get_trans_result(dmaHAL, &rtrans, 0);
-    if (ret == ESP_OK) spiBusyCheck--;
+    if (!dmaResult(this, 0)) break;
   }
 
   //Serial.print("spiBusyCheck=");Serial.println(spiBusyCheck);
@@ -600,46 +650,133 @@ bool TFT_eSPI::dmaBusy(void)
 void TFT_eSPI::dmaWait(void)
 {
   if (!DMA_Enabled || !spiBusyCheck) return;
-  spi_transaction_t *rtrans;
-  esp_err_t ret;
-  for (int i = 0; i < spiBusyCheck; ++i)
+
+  while (spiBusyCheck)
   {
-    ret = spi_device_get_trans_result(dmaHAL, &rtrans, portMAX_DELAY);
-    assert(ret == ESP_OK);
+    bool ret = dmaResult(this, portMAX_DELAY);
+    assert(ret);
   }
-  spiBusyCheck = 0;
 }
 
 
 /***************************************************************************************
-** Function name:           pushPixelsDMA
-** Description:             Push pixels to TFT (len must be less than 32767)
+** Function name:           dmaQueueDepth
+** Description:             Number of pixel transfers queued or in progress
 ***************************************************************************************/
-// This will byte swap the original image if setSwapBytes(true) was called by sketch.
-void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
+uint8_t TFT_eSPI::dmaQueueDepth(void)
 {
-  if ((len == 0) || (!DMA_Enabled)) return;
+  dmaBusy(); // Collect finished transfers first
 
-  dmaWait();
+  return dmaImages;
+}
 
-  if(_swapBytes) {
-    for (uint32_t i = 0; i < len; i++) (image[i] = image[i] << 8 | image[i] >> 8);
+
+/***************************************************************************************
+** Function name:           dmaQueueFill
+** Description:             Queue the transactions for a solid colour block
+***************************************************************************************/
+// The same block of colour is sent by each transaction so the fill needs little RAM
+static void dmaQueueFill(TFT_eSPI *tft, uint16_t color, uint32_t len)
+{
+  if (dmaFillBuffer == nullptr) {
+    dmaFillBuffer = (uint16_t*)heap_caps_malloc(DMA_FILL_PIXELS * 2, MALLOC_CAP_DMA);
+    if (dmaFillBuffer == nullptr) { tft->dmaWait(); tft->pushBlock(color, len); return; }
   }
 
-  esp_err_t ret;
-  static spi_transaction_t trans;
+  // The colour buffer and the transactions are shared, so an earlier fill must end first
+  while (dmaFills) dmaResult(tft, portMAX_DELAY);
+
+  // DMA sends the bytes in memory order
+  color = (color >> 8) | (color << 8);
+  for (uint32_t i = 0; i < DMA_FILL_PIXELS; i++) dmaFillBuffer[i] = color;
+
+  static spi_transaction_t block, tail;
+
+  memset(&block, 0, sizeof(spi_transaction_t));
+  block.user = (void *)1;
+  block.tx_buffer = dmaFillBuffer;
+  block.length = DMA_FILL_PIXELS * 16;
+
+  tail = block;
+  tail.length = (len % DMA_FILL_PIXELS) * 16;
+
+  uint32_t blocks = len / DMA_FILL_PIXELS;
+  uint32_t count  = blocks + (tail.length != 0);
+
+  for (uint32_t i = 0; i < count; i++) {
+    // Results must be collected to free a place in the queue
+    while (tft->spiBusyCheck >= DMA_FILL_QUEUE) dmaResult(tft, portMAX_DELAY);
+
+    spi_transaction_t *trans = (i < blocks) ? &block : &tail;
+
+    esp_err_t ret = spi_device_queue_trans(dmaHAL, trans, portMAX_DELAY);
+    assert(ret == ESP_OK);
+
+    tft->spiBusyCheck++;
+    dmaFills++;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushListDMA
+** Description:             Send a list of image and fill blocks to the window
+***************************************************************************************/
+// Transactions for all the blocks are queued behind any already in flight before this
+// returns. Image transactions are used in turn, so up to DMA_LIST_SIZE image blocks can be
+// in flight at once. The image buffers must not be changed until they are reported
+void TFT_eSPI::pushListDMA(const tftDmaBlock_t *list, uint32_t count)
+{
+  if ((list == nullptr) || (!DMA_Enabled)) return;
+
+  // The slot is kept between calls as earlier transactions may still be in flight
+  static spi_transaction_t trans[DMA_LIST_SIZE];
+  static uint8_t slot = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    const tftDmaBlock_t *block = list + i;
+
+    if (block->len == 0) continue;
+
+    if (block->data == nullptr) {
+      dmaQueueFill(this, block->color, block->len);
+      continue;
+    }
+
+    if (block->flags & DMA_BLOCK_SWAP) {
+      uint16_t *data = block->data;
+      for (uint32_t j = 0; j < block->len; j++) (data[j] = data[j] << 8 | data[j] >> 8);
+    }
 
-  memset(&trans, 0, sizeof(spi_transaction_t));
+    // Transfers end in order, so the oldest transaction is free once fewer are in flight
+    while (dmaImages >= DMA_LIST_SIZE) dmaResult(this, portMAX_DELAY);
 
-  trans.user = (void *)1;
-  trans.tx_buffer = image;  //finally send the line data
-  trans.length = len * 16;        //Data length, in bits
-  trans.flags = 0;                //SPI_TRANS_USE_TXDATA flag
+    spi_transaction_t *t = &trans[slot];
+    if (++slot >= DMA_LIST_SIZE) slot = 0;
 
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->user = block->data;        //Reported by dmaResult(), not null so DC is high
+    t->tx_buffer = block->data;   //Data pointer
+    t->length = block->len * 16;  //Data length, in bits
 
-  spiBusyCheck++;
+    esp_err_t ret = spi_device_queue_trans(dmaHAL, t, portMAX_DELAY);
+    assert(ret == ESP_OK);
+
+    spiBusyCheck++;
+    dmaImages++;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushPixelsDMA
+** Description:             Push pixels to TFT
+***************************************************************************************/
+// This will byte swap the original image if setSwapBytes(true) was called by sketch.
+void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
+{
+  tftDmaBlock_t block = { image, len, 0, _swapBytes ? (uint8_t)DMA_BLOCK_SWAP : (uint8_t)0 };
+  pushListDMA(&block, 1);
 }
 
 
@@ -658,20 +795,8 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
 
   setAddrWindow(x, y, w, h);
 
-  esp_err_t ret;
-  static spi_transaction_t trans;
-
-  memset(&trans, 0, sizeof(spi_transaction_t));
-
-  trans.user = (void *)1;
-  trans.tx_buffer = image;   //Data pointer
-  trans.length = len * 16;   //Data length, in bits
-  trans.flags = 0;           //SPI_TRANS_USE_TXDATA flag
-
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
-
-  spiBusyCheck++;
+  tftDmaBlock_t block = { (uint16_t*)image, len, 0, 0 };
+  pushListDMA(&block, 1);
 }
 
 
@@ -701,6 +826,10 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
 
   if (buffer == nullptr) {
     buffer = image;
+  #if (DMA_QUEUE_SIZE > 1)
+    // The image is only altered if clipped or swapped, otherwise it can be queued as it is
+    if ( (dw != w) || (dh != h) || _swapBytes)
+  #endif
     dmaWait();
   }
 
@@ -730,24 +859,101 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
     }
   }
 
+#if (DMA_QUEUE_SIZE > 1)
+  // Wait for a free slot, transfers end in order so the oldest set of transactions is then free
+  while (dmaImages >= DMA_QUEUE_SIZE) dmaResult(this, portMAX_DELAY);
+
+  spi_transaction_t *t = dmaTrans[dmaSlot];
+  if (++dmaSlot >= DMA_QUEUE_SIZE) dmaSlot = 0;
+  memset(t, 0, sizeof(spi_transaction_t) * DMA_TRANS_SIZE);
+
+  // The address window is queued behind the transfers in progress instead of being
+  // written directly, the DC line is set for each transaction by dc_callback()
+  int32_t x1 = x + dw - 1;
+  int32_t y1 = y + dh - 1;
+  #ifdef CGRAM_OFFSET
+    x  += colstart;
+    x1 += colstart;
+    y  += rowstart;
+    y1 += rowstart;
+  #endif
+
+  #if defined (MULTI_TFT_SUPPORT) || defined (GC9A01_DRIVER)
+    addr_row = 0xFFFF;
+    addr_col = 0xFFFF;
+  #endif
+
+  uint32_t xw = ((uint32_t)x << 16) | (uint16_t)x1;
+  uint32_t yw = ((uint32_t)y << 16) | (uint16_t)y1;
+
+  uint8_t n = 0;
+  if (addr_col != xw) {
+    t[n].flags = SPI_TRANS_USE_TXDATA; t[n].length = 8; t[n++].tx_data[0] = TFT_CASET;
+    t[n].flags = SPI_TRANS_USE_TXDATA; t[n].length = 32; t[n].user = (void *)1;
+    t[n].tx_data[0] = x >> 8; t[n].tx_data[1] = x; t[n].tx_data[2] = x1 >> 8; t[n++].tx_data[3] = x1;
+    addr_col = xw;
+  }
+  if (addr_row != yw) {
+    t[n].flags = SPI_TRANS_USE_TXDATA; t[n].length = 8; t[n++].tx_data[0] = TFT_PASET;
+    t[n].flags = SPI_TRANS_USE_TXDATA; t[n].length = 32; t[n].user = (void *)1;
+    t[n].tx_data[0] = y >> 8; t[n].tx_data[1] = y; t[n].tx_data[2] = y1 >> 8; t[n++].tx_data[3] = y1;
+    addr_row = yw;
+  }
+  t[n].flags = SPI_TRANS_USE_TXDATA; t[n].length = 8; t[n++].tx_data[0] = TFT_RAMWR;
+
+  t[n].user = buffer;       //Reported by dmaResult(), not null so DC is high
+  t[n].tx_buffer = buffer;  //finally send the line data
+  t[n++].length = len * 16; //Data length, in bits
+
+  for (uint8_t i = 0; i < n; i++) {
+    esp_err_t ret = spi_device_queue_trans(dmaHAL, &t[i], portMAX_DELAY);
+    assert(ret == ESP_OK);
+    spiBusyCheck++;
+  }
+  dmaImages++;
+#else
   if (spiBusyCheck) dmaWait(); // In case we did not wait earlier
 
   setAddrWindow(x, y, dw, dh);
 
-  esp_err_t ret;
-  static spi_transaction_t trans;
+  tftDmaBlock_t block = { buffer, len, 0, 0 }; // Bytes already swapped
+  pushListDMA(&block, 1);
+#endif
+}
 
-  memset(&trans, 0, sizeof(spi_transaction_t));
 
-  trans.user = (void *)1;
-  trans.tx_buffer = buffer;  //finally send the line data
-  trans.length = len * 16;   //Data length, in bits
-  trans.flags = 0;           //SPI_TRANS_USE_TXDATA flag
+/***************************************************************************************
+** Function name:           pushBlockDMA
+** Description:             Fill the window set by setAddrWindow() with a colour
+***************************************************************************************/
+void TFT_eSPI::pushBlockDMA(uint16_t color, uint32_t len)
+{
+  tftDmaBlock_t block = { nullptr, len, color, 0 };
+  pushListDMA(&block, 1);
+}
 
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
 
-  spiBusyCheck++;
+/***************************************************************************************
+** Function name:           fillRectDMA
+** Description:             Fill a rectangle using DMA, returns before the fill ends
+***************************************************************************************/
+void TFT_eSPI::fillRectDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  if ((x >= _vpW) || (y >= _vpH) || (!DMA_Enabled)) return;
+
+  if (x < _vpX) { w -= _vpX - x; x = _vpX; }
+  if (y < _vpY) { h -= _vpY - y; y = _vpY; }
+
+  if ((x + w) > _vpW ) w = _vpW - x;
+  if ((y + h) > _vpH ) h = _vpH - y;
+
+  if (w < 1 || h < 1) return;
+
+  dmaWait();
+
+  setAddrWindow(x, y, w, h);
+
+  pushBlockDMA(color, w * h);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -819,8 +1025,13 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
     .input_delay_ns = 0,
     .spics_io_num = pin,
     .flags = SPI_DEVICE_NO_DUMMY, //0,
-    .queue_size = 1,
+  #if (DMA_QUEUE_SIZE > 1)
+    .queue_size = DMA_QUEUE_SIZE * DMA_TRANS_SIZE + DMA_LIST_SIZE + DMA_FILL_QUEUE,
+    .pre_cb = dc_callback, //Callback to handle D/C line for queued address windows
+  #else
+    .queue_size = DMA_LIST_SIZE + DMA_FILL_QUEUE,
     .pre_cb = 0, //dc_callback, //Callback to handle D/C line
+  #endif
     #ifdef CONFIG_IDF_TARGET_ESP32
       .post_cb = 0
     #else
@@ -834,6 +1045,8 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
 
   DMA_Enabled = true;
   spiBusyCheck = 0;
+  dmaImages = 0;
+  dmaFills = 0;
   return true;
 }
 
@@ -844,8 +1057,10 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
 void TFT_eSPI::deInitDMA(void)
 {
   if (!DMA_Enabled) return;
+  dmaWait();
   spi_bus_remove_device(dmaHAL);
   spi_bus_free(spi_host);
+  if (dmaFillBuffer) { heap_caps_free(dmaFillBuffer); dmaFillBuffer = nullptr; }
   DMA_Enabled = false;
 }
 
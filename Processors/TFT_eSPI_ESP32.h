@@ -121,6 +121,27 @@ SPI3_HOST = 2
   #define ESP32_DMA
   // Code to check if DMA is busy, used by SPI DMA + transaction + endWrite functions
   #define DMA_BUSY_CHECK  dmaWait()
+
+  // pushBlockDMA() repeats a buffer of DMA_FILL_PIXELS, allocated on first use, with one
+  // transaction per block. Fills up to DMA_FILL_PIXELS * DMA_FILL_QUEUE return immediately
+  #ifndef DMA_FILL_PIXELS
+    #define DMA_FILL_PIXELS 1024
+  #endif
+  #ifndef DMA_FILL_QUEUE
+    #define DMA_FILL_QUEUE 80 // Transactions, large enough for a 320 x 240 screen
+  #endif
+
+  // Number of pushListDMA() image blocks that can be in flight at once
+  #ifndef DMA_LIST_SIZE
+    #define DMA_LIST_SIZE 8
+  #endif
+
+  // Number of pushImageDMA() transfers that can be in flight, the default of 1 waits
+  // for the last DMA to end. Drivers with a non-standard address window are limited to 1
+  #if !defined (DMA_QUEUE_SIZE) || defined (ILI9225_DRIVER) || defined (SSD1351_DRIVER) || defined (RM68120_DRIVER)
+    #undef  DMA_QUEUE_SIZE
+    #define DMA_QUEUE_SIZE 1
+  #endif
 #else
   #define DMA_BUSY_CHECK
 #endif
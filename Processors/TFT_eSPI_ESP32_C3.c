@@ -50,6 +50,13 @@
       spi_host_device_t spi_host = (spi_host_device_t) DMA_CHANNEL; // Draws once then freezes
     #endif
   #endif
+
+  // Number of pixel transfers queued or in progress
+  uint8_t dmaImages = 0;
+
+  // Colour block repeated by fill blocks and the number of fill transactions in flight
+  uint16_t *dmaFillBuffer = nullptr;
+  uint8_t dmaFills = 0;
 #endif
 
 #if !defined (TFT_PARALLEL_8_BIT)
@@ -594,6 +601,29 @@ void TFT_eSPI::pushPixels(const void* data_in, uint32_t len){
 #if defined (ESP32_DMA) && !defined (TFT_PARALLEL_8_BIT) //       DMA FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////
 
+/***************************************************************************************
+** Function name:           dmaResult
+** Description:             Collect a finished transaction, false if none before timeout
+***************************************************************************************/
+static bool dmaResult(TFT_eSPI *tft, TickType_t wait)
+{
+  spi_transaction_t *rtrans;
+  if (spi_device_get_trans_result(dmaHAL, &rtrans, wait) != ESP_OK) return false;
+
+  tft->spiBusyCheck--;
+
+  // Image transfers hold their buffer in user
+  if (rtrans->tx_buffer == dmaFillBuffer) dmaFills--;
+  else {
+    dmaImages--;
+    dmaDoneCallback dmaDone = tft->getDMACallback();
+    if (dmaDone) dmaDone((uint16_t*)rtrans->user);
+  }
+
+  return true;
+}
+
+
 /***************************************************************************************
 ** Function name:           dmaBusy
 ** Description:             Check if DMA is busy
@@ -602,13 +632,11 @@ bool TFT_eSPI::dmaBusy(void)
 {
   if (!DMA_Enabled || !spiBusyCheck) return false;
 
-  spi_transaction_t *rtrans;
-  esp_err_t ret;
+  // Transactions complete in order, so stop at the first one still in progress
   uint8_t checks = spiBusyCheck;
   for (int i = 0; i < checks; ++i)
   {
-    ret = spi_device_get_trans_result(dmaHAL, &rtrans, 0);
-    if (ret == ESP_OK) spiBusyCheck--;
+    if (!dmaResult(this, 0)) break;
   }
 
   //Serial.print("spiBusyCheck=");Serial.println(spiBusyCheck);
@@ -624,52 +652,130 @@ bool TFT_eSPI::dmaBusy(void)
 void TFT_eSPI::dmaWait(void)
 {
   if (!DMA_Enabled || !spiBusyCheck) return;
-  spi_transaction_t *rtrans;
-  esp_err_t ret;
-  for (int i = 0; i < spiBusyCheck; ++i)
+
+  while (spiBusyCheck)
   {
-    ret = spi_device_get_trans_result(dmaHAL, &rtrans, portMAX_DELAY);
-    assert(ret == ESP_OK);
+    bool ret = dmaResult(this, portMAX_DELAY);
+    assert(ret);
   }
-  spiBusyCheck = 0;
 }
 
 
 /***************************************************************************************
-** Function name:           pushPixelsDMA
-** Description:             Push pixels to TFT (len must be less than 32767)
+** Function name:           dmaQueueFill
+** Description:             Queue the transactions for a solid colour block
 ***************************************************************************************/
-// This will byte swap the original image if setSwapBytes(true) was called by sketch.
-void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
+// The same block of colour is sent by each transaction so the fill needs little RAM
+static void dmaQueueFill(TFT_eSPI *tft, uint16_t color, uint32_t len)
 {
-  if ((len == 0) || (!DMA_Enabled)) return;
+  if (dmaFillBuffer == nullptr) {
+    dmaFillBuffer = (uint16_t*)heap_caps_malloc(DMA_FILL_PIXELS * 2, MALLOC_CAP_DMA);
+    if (dmaFillBuffer == nullptr) { tft->dmaWait(); tft->pushBlock(color, len); return; }
+  }
 
-  dmaWait();
+  // The colour buffer and the transactions are shared, so an earlier fill must end first
+  while (dmaFills) dmaResult(tft, portMAX_DELAY);
 
-  if(_swapBytes) {
-    for (uint32_t i = 0; i < len; i++) (image[i] = image[i] << 8 | image[i] >> 8);
+  // DMA sends the bytes in memory order
+  color = (color >> 8) | (color << 8);
+  for (uint32_t i = 0; i < DMA_FILL_PIXELS; i++) dmaFillBuffer[i] = color;
+
+  static spi_transaction_t block, tail;
+
+  memset(&block, 0, sizeof(spi_transaction_t));
+  block.user = (void *)1;
+  block.tx_buffer = dmaFillBuffer;
+  block.length = DMA_FILL_PIXELS * 16;
+
+  tail = block;
+  tail.length = (len % DMA_FILL_PIXELS) * 16;
+
+  uint32_t blocks = len / DMA_FILL_PIXELS;
+  uint32_t count  = blocks + (tail.length != 0);
+
+  for (uint32_t i = 0; i < count; i++) {
+    // Results must be collected to free a place in the queue
+    while (tft->spiBusyCheck >= DMA_FILL_QUEUE) dmaResult(tft, portMAX_DELAY);
+
+    spi_transaction_t *trans = (i < blocks) ? &block : &tail;
+
+    esp_err_t ret = spi_device_queue_trans(dmaHAL, trans, portMAX_DELAY);
+    assert(ret == ESP_OK);
+
+    tft->spiBusyCheck++;
+    dmaFills++;
   }
+}
 
-  esp_err_t ret;
-  static spi_transaction_t trans;
 
-  memset(&trans, 0, sizeof(spi_transaction_t));
+/***************************************************************************************
+** Function name:           pushListDMA
+** Description:             Send a list of image and fill blocks to the window
+***************************************************************************************/
+// Transactions for all the blocks are queued behind any already in flight before this
+// returns. Image transactions are used in turn, so up to DMA_LIST_SIZE image blocks can be
+// in flight at once. The image buffers must not be changed until they are reported
+void TFT_eSPI::pushListDMA(const tftDmaBlock_t *list, uint32_t count)
+{
+  if ((list == nullptr) || (!DMA_Enabled)) return;
+
+  // The slot is kept between calls as earlier transactions may still be in flight
+  static spi_transaction_t trans[DMA_LIST_SIZE];
+  static uint8_t slot = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    const tftDmaBlock_t *block = list + i;
 
-  trans.user = (void *)1;
-  trans.tx_buffer = image;  //finally send the line data
-  trans.length = len * 16;        //Data length, in bits
-  trans.flags = 0;                //SPI_TRANS_USE_TXDATA flag
+    if (block->len == 0) continue;
+
+    if (block->data == nullptr) {
+      dmaQueueFill(this, block->color, block->len);
+      continue;
+    }
+
+    if (block->flags & DMA_BLOCK_SWAP) {
+      uint16_t *data = block->data;
+      for (uint32_t j = 0; j < block->len; j++) (data[j] = data[j] << 8 | data[j] >> 8);
+    }
+
+    uint16_t *data = block->data;
+    uint32_t len = block->len;
+
+    // Transfers end in order, so the oldest transaction is free once fewer are in flight
+    while (dmaImages >= DMA_LIST_SIZE) dmaResult(this, portMAX_DELAY);
+
+    spi_transaction_t *t = &trans[slot];
+    if (++slot >= DMA_LIST_SIZE) slot = 0;
+
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->user = block->data;  //Reported by dmaResult(), not null so DC is high
+    t->tx_buffer = data;    //Data pointer
+    t->length = len * 16;   //Data length, in bits
+
+    esp_err_t ret = spi_device_queue_trans(dmaHAL, t, portMAX_DELAY);
+    assert(ret == ESP_OK);
+
+    spiBusyCheck++;
+    dmaImages++;
+  }
+}
 
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
 
-  spiBusyCheck++;
+/***************************************************************************************
+** Function name:           pushPixelsDMA
+** Description:             Push pixels to TFT
+***************************************************************************************/
+// This will byte swap the original image if setSwapBytes(true) was called by sketch.
+void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
+{
+  tftDmaBlock_t block = { image, len, 0, _swapBytes ? (uint8_t)DMA_BLOCK_SWAP : (uint8_t)0 };
+  pushListDMA(&block, 1);
 }
 
 
 /***************************************************************************************
 ** Function name:           pushImageDMA
-** Description:             Push image to a window (w*h must be less than 65536)
+** Description:             Push image to a window
 ***************************************************************************************/
 // Fixed const data assumed, will NOT clip or swap bytes
 void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t const* image)
@@ -682,26 +788,14 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
 
   setAddrWindow(x, y, w, h);
 
-  esp_err_t ret;
-  static spi_transaction_t trans;
-
-  memset(&trans, 0, sizeof(spi_transaction_t));
-
-  trans.user = (void *)1;
-  trans.tx_buffer = image;   //Data pointer
-  trans.length = len * 16;   //Data length, in bits
-  trans.flags = 0;           //SPI_TRANS_USE_TXDATA flag
-
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
-
-  spiBusyCheck++;
+  tftDmaBlock_t block = { (uint16_t*)image, len, 0, 0 };
+  pushListDMA(&block, 1);
 }
 
 
 /***************************************************************************************
 ** Function name:           pushImageDMA
-** Description:             Push image to a window (w*h must be less than 65536)
+** Description:             Push image to a window
 ***************************************************************************************/
 // This will clip and also swap bytes if setSwapBytes(true) was called by sketch
 void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* image, uint16_t* buffer)
@@ -758,20 +852,43 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
 
   setAddrWindow(x, y, dw, dh);
 
-  esp_err_t ret;
-  static spi_transaction_t trans;
+  tftDmaBlock_t block = { buffer, len, 0, 0 }; // Bytes already swapped
+  pushListDMA(&block, 1);
+}
 
-  memset(&trans, 0, sizeof(spi_transaction_t));
 
-  trans.user = (void *)1;
-  trans.tx_buffer = buffer;  //finally send the line data
-  trans.length = len * 16;   //Data length, in bits
-  trans.flags = 0;           //SPI_TRANS_USE_TXDATA flag
+/***************************************************************************************
+** Function name:           pushBlockDMA
+** Description:             Fill the window set by setAddrWindow() with a colour
+***************************************************************************************/
+void TFT_eSPI::pushBlockDMA(uint16_t color, uint32_t len)
+{
+  tftDmaBlock_t block = { nullptr, len, color, 0 };
+  pushListDMA(&block, 1);
+}
 
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
 
-  spiBusyCheck++;
+/***************************************************************************************
+** Function name:           fillRectDMA
+** Description:             Fill a rectangle using DMA, returns before the fill ends
+***************************************************************************************/
+void TFT_eSPI::fillRectDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  if ((x >= _vpW) || (y >= _vpH) || (!DMA_Enabled)) return;
+
+  if (x < _vpX) { w -= _vpX - x; x = _vpX; }
+  if (y < _vpY) { h -= _vpY - y; y = _vpY; }
+
+  if ((x + w) > _vpW ) w = _vpW - x;
+  if ((y + h) > _vpH ) h = _vpH - y;
+
+  if (w < 1 || h < 1) return;
+
+  dmaWait();
+
+  setAddrWindow(x, y, w, h);
+
+  pushBlockDMA(color, w * h);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -830,7 +947,7 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
     .input_delay_ns = 0,
     .spics_io_num = pin,
     .flags = SPI_DEVICE_NO_DUMMY, //0,
-    .queue_size = 1,
+    .queue_size = DMA_LIST_SIZE + DMA_FILL_QUEUE, // pushListDMA() image and fill blocks
     .pre_cb = 0, //dc_callback, //Callback to handle D/C line
     .post_cb = 0
   };
@@ -841,6 +958,8 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
 
   DMA_Enabled = true;
   spiBusyCheck = 0;
+  dmaImages = 0;
+  dmaFills = 0;
   return true;
 }
 
@@ -851,8 +970,10 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
 void TFT_eSPI::deInitDMA(void)
 {
   if (!DMA_Enabled) return;
+  dmaWait();
   spi_bus_remove_device(dmaHAL);
   spi_bus_free(spi_host);
+  if (dmaFillBuffer) { heap_caps_free(dmaFillBuffer); dmaFillBuffer = nullptr; }
   DMA_Enabled = false;
 }
 
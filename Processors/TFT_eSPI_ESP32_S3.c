@@ -50,6 +50,13 @@
       spi_host_device_t spi_host = SPI2_HOST;
     #endif
   #endif
+
+  // Number of pixel transfers queued or in progress
+  uint8_t dmaImages = 0;
+
+  // Colour block repeated by fill blocks and the number of fill transactions in flight
+  uint16_t *dmaFillBuffer = nullptr;
+  uint8_t dmaFills = 0;
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -584,6 +591,29 @@ void TFT_eSPI::pushPixels(const void* data_in, uint32_t len){
 #if defined (ESP32_DMA) && !defined (TFT_PARALLEL_8_BIT) //       DMA FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////
 
+/***************************************************************************************
+** Function name:           dmaResult
+** Description:             Collect a finished transaction, false if none before timeout
+***************************************************************************************/
+static bool dmaResult(TFT_eSPI *tft, TickType_t wait)
+{
+  spi_transaction_t *rtrans;
+  if (spi_device_get_trans_result(dmaHAL, &rtrans, wait) != ESP_OK) return false;
+
+  tft->spiBusyCheck--;
+
+  // Image transfers hold their buffer in user, or 1 if more of the buffer follows
+  if (rtrans->tx_buffer == dmaFillBuffer) dmaFills--;
+  else {
+    dmaImages--;
+    dmaDoneCallback dmaDone = tft->getDMACallback();
+    if (dmaDone && (rtrans->user != (void *)1)) dmaDone((uint16_t*)rtrans->user);
+  }
+
+  return true;
+}
+
+
 /***************************************************************************************
 ** Function name:           dmaBusy
 ** Description:             Check if DMA is busy
@@ -592,13 +622,11 @@ bool TFT_eSPI::dmaBusy(void)
 {
   if (!DMA_Enabled || !spiBusyCheck) return false;
 
-  spi_transaction_t *rtrans;
-  esp_err_t ret;
+  // Transactions complete in order, so stop at the first one still in progress
   uint8_t checks = spiBusyCheck;
   for (int i = 0; i < checks; ++i)
   {
-    ret = spi_device_get_trans_result(dmaHAL, &rtrans, 0);
-    if (ret == ESP_OK) spiBusyCheck--;
+    if (!dmaResult(this, 0)) break;
   }
 
   //Serial.print("spiBusyCheck=");Serial.println(spiBusyCheck);
@@ -614,108 +642,159 @@ bool TFT_eSPI::dmaBusy(void)
 void TFT_eSPI::dmaWait(void)
 {
   if (!DMA_Enabled || !spiBusyCheck) return;
-  spi_transaction_t *rtrans;
-  esp_err_t ret;
-  for (int i = 0; i < spiBusyCheck; ++i)
+
+  while (spiBusyCheck)
   {
-    ret = spi_device_get_trans_result(dmaHAL, &rtrans, portMAX_DELAY);
-    assert(ret == ESP_OK);
+    bool ret = dmaResult(this, portMAX_DELAY);
+    assert(ret);
   }
-  spiBusyCheck = 0;
 }
 
 
 /***************************************************************************************
-** Function name:           pushPixelsDMA
-** Description:             Push pixels to TFT (len must be less than 32767)
+** Function name:           dmaQueueFill
+** Description:             Queue the transactions for a solid colour block
 ***************************************************************************************/
-// This will byte swap the original image if setSwapBytes(true) was called by sketch.
-void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
+// The same block of colour is sent by each transaction so the fill needs little RAM
+static void dmaQueueFill(TFT_eSPI *tft, uint16_t color, uint32_t len)
 {
-  if ((len == 0) || (!DMA_Enabled)) return;
+  if (dmaFillBuffer == nullptr) {
+    dmaFillBuffer = (uint16_t*)heap_caps_malloc(DMA_FILL_PIXELS * 2, MALLOC_CAP_DMA);
+    if (dmaFillBuffer == nullptr) { tft->dmaWait(); tft->pushBlock(color, len); return; }
+  }
 
-  dmaWait();
+  // The colour buffer and the transactions are shared, so an earlier fill must end first
+  while (dmaFills) dmaResult(tft, portMAX_DELAY);
 
-  if(_swapBytes) {
-    for (uint32_t i = 0; i < len; i++) (image[i] = image[i] << 8 | image[i] >> 8);
-  }
+  // DMA sends the bytes in memory order
+  color = (color >> 8) | (color << 8);
+  for (uint32_t i = 0; i < DMA_FILL_PIXELS; i++) dmaFillBuffer[i] = color;
+
+  static spi_transaction_t block, tail;
+
+  memset(&block, 0, sizeof(spi_transaction_t));
+  block.user = (void *)1;
+  block.tx_buffer = dmaFillBuffer;
+  block.length = DMA_FILL_PIXELS * 16;
+
+  tail = block;
+  tail.length = (len % DMA_FILL_PIXELS) * 16;
+
+  uint32_t blocks = len / DMA_FILL_PIXELS;
+  uint32_t count  = blocks + (tail.length != 0);
+
+  for (uint32_t i = 0; i < count; i++) {
+    // Results must be collected to free a place in the queue
+    while (tft->spiBusyCheck >= DMA_FILL_QUEUE) dmaResult(tft, portMAX_DELAY);
+
+    spi_transaction_t *trans = (i < blocks) ? &block : &tail;
 
-  // DMA byte count for transmit is 64Kbytes maximum, so to avoid this constraint
-  // small transfers are performed using a blocking call until DMA capacity is reached.
-  // User sketch can prevent blocking by managing pixel count and splitting into blocks
-  // of 32768 pixels maximum. (equivalent to an area of ~320 x 100 pixels)
-  bool temp = _swapBytes;
-  _swapBytes = false;
-  while(len>0x4000) { // Transfer 16-bit pixels in blocks if len*2 over 65536 bytes
-    pushPixels(image, 0x400);
-    len -= 0x400; image+= 0x400; // Arbitrarily send 1K pixel blocks (2Kbytes)
+    esp_err_t ret = spi_device_queue_trans(dmaHAL, trans, portMAX_DELAY);
+    assert(ret == ESP_OK);
+
+    tft->spiBusyCheck++;
+    dmaFills++;
   }
-  _swapBytes = temp;
+}
 
-  esp_err_t ret;
-  static spi_transaction_t trans;
 
-  memset(&trans, 0, sizeof(spi_transaction_t));
+/***************************************************************************************
+** Function name:           pushListDMA
+** Description:             Send a list of image and fill blocks to the window
+***************************************************************************************/
+// Transactions for all the blocks are queued behind any already in flight before this
+// returns. Image transactions are used in turn, so up to DMA_LIST_SIZE image transactions
+// can be in flight at once. The image buffers must not be changed until they are reported
+void TFT_eSPI::pushListDMA(const tftDmaBlock_t *list, uint32_t count)
+{
+  if ((list == nullptr) || (!DMA_Enabled)) return;
+
+  // The slot is kept between calls as earlier transactions may still be in flight
+  static spi_transaction_t trans[DMA_LIST_SIZE];
+  static uint8_t slot = 0;
 
-  trans.user = (void *)1;
-  trans.tx_buffer = image;  //finally send the line data
-  trans.length = len * 16;        //Data length, in bits
-  trans.flags = 0;                //SPI_TRANS_USE_TXDATA flag
+  for (uint32_t i = 0; i < count; i++) {
+    const tftDmaBlock_t *block = list + i;
 
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
+    if (block->len == 0) continue;
 
-  spiBusyCheck++;
+    if (block->data == nullptr) {
+      dmaQueueFill(this, block->color, block->len);
+      continue;
+    }
+
+    if (block->flags & DMA_BLOCK_SWAP) {
+      uint16_t *data = block->data;
+      for (uint32_t j = 0; j < block->len; j++) (data[j] = data[j] << 8 | data[j] >> 8);
+    }
+
+    uint16_t *data = block->data;
+    uint32_t len = block->len;
+
+    // DMA byte count for transmit is 64Kbytes maximum, so a large block is sent as
+    // several transactions of 16384 pixels maximum. Only the last reports the buffer.
+    while (len) {
+      uint32_t part = (len > 0x4000) ? 0x4000 : len;
+
+      // Transfers end in order, so the oldest transaction is free once fewer are in flight
+      while (dmaImages >= DMA_LIST_SIZE) dmaResult(this, portMAX_DELAY);
+
+      spi_transaction_t *t = &trans[slot];
+      if (++slot >= DMA_LIST_SIZE) slot = 0;
+
+      memset(t, 0, sizeof(spi_transaction_t));
+      t->user = (part == len) ? (void *)block->data : (void *)1; //Not null so DC is high
+      t->tx_buffer = data;    //Data pointer
+      t->length = part * 16;  //Data length, in bits
+
+      esp_err_t ret = spi_device_queue_trans(dmaHAL, t, portMAX_DELAY);
+      assert(ret == ESP_OK);
+
+      spiBusyCheck++;
+      dmaImages++;
+
+      data += part;
+      len  -= part;
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushPixelsDMA
+** Description:             Push pixels to TFT
+***************************************************************************************/
+// This will byte swap the original image if setSwapBytes(true) was called by sketch.
+void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
+{
+  tftDmaBlock_t block = { image, len, 0, _swapBytes ? (uint8_t)DMA_BLOCK_SWAP : (uint8_t)0 };
+  pushListDMA(&block, 1);
 }
 
 
 /***************************************************************************************
 ** Function name:           pushImageDMA
-** Description:             Push image to a window (w*h must be less than 65536)
+** Description:             Push image to a window
 ***************************************************************************************/
 // Fixed const data assumed, will NOT clip or swap bytes
 void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t const* image)
 {
   if ((w == 0) || (h == 0) || (!DMA_Enabled)) return;
 
-  uint16_t *buffer = (uint16_t*)image;
   uint32_t len = w*h;
 
   dmaWait();
 
   setAddrWindow(x, y, w, h);
-  // DMA byte count for transmit is 64Kbytes maximum, so to avoid this constraint
-  // small transfers are performed using a blocking call until DMA capacity is reached.
-  // User sketch can prevent blocking by managing pixel count and splitting into blocks
-  // of 32768 pixels maximum. (equivalent to an area of ~320 x 100 pixels)
-  bool temp = _swapBytes;
-  _swapBytes = false;
-  while(len>0x4000) { // Transfer 16-bit pixels in blocks if len*2 over 65536 bytes
-    pushPixels(buffer, 0x400);
-    len -= 0x400; buffer+= 0x400; // Arbitrarily send 1K pixel blocks (2Kbytes)
-  }
-  _swapBytes = temp;
-
-  esp_err_t ret;
-  static spi_transaction_t trans;
 
-  memset(&trans, 0, sizeof(spi_transaction_t));
-
-  trans.user = (void *)1;
-  trans.tx_buffer = buffer;   //Data pointer
-  trans.length = len * 16;   //Data length, in bits
-  trans.flags = 0;           //SPI_TRANS_USE_TXDATA flag
-
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
-
-  spiBusyCheck++;
+  tftDmaBlock_t block = { (uint16_t*)image, len, 0, 0 };
+  pushListDMA(&block, 1);
 }
 
 
 /***************************************************************************************
 ** Function name:           pushImageDMA
-** Description:             Push image to a window (w*h must be less than 65536)
+** Description:             Push image to a window
 ***************************************************************************************/
 // This will clip and also swap bytes if setSwapBytes(true) was called by sketch
 void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* image, uint16_t* buffer)
@@ -772,32 +851,43 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
 
   setAddrWindow(x, y, dw, dh);
 
-  // DMA byte count for transmit is 64Kbytes maximum, so to avoid this constraint
-  // small transfers are performed using a blocking call until DMA capacity is reached.
-  // User sketch can prevent blocking by managing pixel count and splitting into blocks
-  // of 32768 pixels maximum. (equivalent to an area of ~320 x 100 pixels)
-  bool temp = _swapBytes;
-  _swapBytes = false;
-  while(len>0x4000) { // Transfer 16-bit pixels in blocks if len*2 over 65536 bytes
-    pushPixels(buffer, 0x400);
-    len -= 0x400; buffer+= 0x400; // Arbitrarily send 1K pixel blocks (2Kbytes)
-  }
-  _swapBytes = temp;
+  tftDmaBlock_t block = { buffer, len, 0, 0 }; // Bytes already swapped
+  pushListDMA(&block, 1);
+}
 
-  esp_err_t ret;
-  static spi_transaction_t trans;
 
-  memset(&trans, 0, sizeof(spi_transaction_t));
+/***************************************************************************************
+** Function name:           pushBlockDMA
+** Description:             Fill the window set by setAddrWindow() with a colour
+***************************************************************************************/
+void TFT_eSPI::pushBlockDMA(uint16_t color, uint32_t len)
+{
+  tftDmaBlock_t block = { nullptr, len, color, 0 };
+  pushListDMA(&block, 1);
+}
+
 
-  trans.user = (void *)1;
-  trans.tx_buffer = buffer;  //finally send the line data
-  trans.length = len * 16;   //Data length, in bits
-  trans.flags = 0;           //SPI_TRANS_USE_TXDATA flag
+/***************************************************************************************
+** Function name:           fillRectDMA
+** Description:             Fill a rectangle using DMA, returns before the fill ends
+***************************************************************************************/
+void TFT_eSPI::fillRectDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  if ((x >= _vpW) || (y >= _vpH) || (!DMA_Enabled)) return;
+
+  if (x < _vpX) { w -= _vpX - x; x = _vpX; }
+  if (y < _vpY) { h -= _vpY - y; y = _vpY; }
+
+  if ((x + w) > _vpW ) w = _vpW - x;
+  if ((y + h) > _vpH ) h = _vpH - y;
 
-  ret = spi_device_queue_trans(dmaHAL, &trans, portMAX_DELAY);
-  assert(ret == ESP_OK);
+  if (w < 1 || h < 1) return;
 
-  spiBusyCheck++;
+  dmaWait();
+
+  setAddrWindow(x, y, w, h);
+
+  pushBlockDMA(color, w * h);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -867,7 +957,7 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
     .input_delay_ns = 0,
     .spics_io_num = pin,
     .flags = SPI_DEVICE_NO_DUMMY, //0,
-    .queue_size = 1,            // Not using queues
+    .queue_size = DMA_LIST_SIZE + DMA_FILL_QUEUE, // pushListDMA() image and fill blocks
     .pre_cb = 0, //dc_callback, //Callback to handle D/C line (not used)
     .post_cb = dma_end_callback //Callback to end transmission
   };
@@ -878,6 +968,8 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
 
   DMA_Enabled = true;
   spiBusyCheck = 0;
+  dmaImages = 0;
+  dmaFills = 0;
   return true;
 }
 
@@ -888,8 +980,10 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
 void TFT_eSPI::deInitDMA(void)
 {
   if (!DMA_Enabled) return;
+  dmaWait();
   spi_bus_remove_device(dmaHAL);
   spi_bus_free(spi_host);
+  if (dmaFillBuffer) { heap_caps_free(dmaFillBuffer); dmaFillBuffer = nullptr; }
   DMA_Enabled = false;
 }
 
@@ -0,0 +1,377 @@
+        ////////////////////////////////////////////////////
+        //       TFT_eSPI host (PC) driver functions      //
+        ////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Global variables
+////////////////////////////////////////////////////////////////////////////////////////
+
+// The TFT controller model stands in for the SPI port
+TFT_eSPI_HostPanel spi;
+
+// Controller commands decoded by the model, other commands are accepted and
+// counted but their parameters are ignored
+#define HOST_SWRESET 0x01
+#define HOST_CASET   0x2A
+#define HOST_PASET   0x2B
+#define HOST_RAMWR   0x2C
+#define HOST_RAMRD   0x2E
+#define HOST_MADCTL  0x36
+#define HOST_COLMOD  0x3A
+#define HOST_RAMWRC  0x3C
+#define HOST_RAMRDC  0x3E
+
+// MADCTL bits that change the graphics RAM addressing
+#define HOST_MAD_MY  0x80
+#define HOST_MAD_MX  0x40
+#define HOST_MAD_MV  0x20
+
+/***************************************************************************************
+** Function name:           TFT_eSPI_HostPanel
+** Description:             Constructor, allocate the graphics RAM
+***************************************************************************************/
+TFT_eSPI_HostPanel::TFT_eSPI_HostPanel(void)
+{
+  gram = (uint16_t*)calloc(TFT_HOST_GRAM_WIDTH * TFT_HOST_GRAM_HEIGHT, sizeof(uint16_t));
+  frequency = 0;
+  resetCounters();
+  reset();
+}
+
+/***************************************************************************************
+** Function name:           ~TFT_eSPI_HostPanel
+** Description:             Destructor, release the graphics RAM
+***************************************************************************************/
+TFT_eSPI_HostPanel::~TFT_eSPI_HostPanel(void)
+{
+  if (gram) free(gram);
+  gram = nullptr;
+}
+
+/***************************************************************************************
+** Function name:           reset
+** Description:             Put the controller in the power on reset state
+***************************************************************************************/
+void TFT_eSPI_HostPanel::reset(void)
+{
+  csActive   = false;
+  dcData     = true;
+  command    = 0;
+  paramCount = 0;
+  pixCount   = 0;
+  madctl     = 0;
+  bits18     = true; // ILI9341 and ST7789 power up in 18-bit mode
+  xs = 0; xe = TFT_HOST_GRAM_WIDTH  - 1;
+  ys = 0; ye = TFT_HOST_GRAM_HEIGHT - 1;
+  col = xs;
+  page = ys;
+}
+
+/***************************************************************************************
+** Function name:           transfer
+** Description:             Clock one byte to or from the controller
+***************************************************************************************/
+uint8_t TFT_eSPI_HostPanel::transfer(uint8_t data)
+{
+  if (!csActive) return 0xFF; // Not selected so MISO floats
+
+  if (!dcData) {
+    commandByte(data);
+    return 0;
+  }
+
+  if (command == HOST_RAMRD || command == HOST_RAMRDC) return readByte();
+
+  dataByte(data);
+  return 0;
+}
+
+/***************************************************************************************
+** Function name:           transfer16
+** Description:             Clock two bytes to or from the controller, MS byte first
+***************************************************************************************/
+uint16_t TFT_eSPI_HostPanel::transfer16(uint16_t data)
+{
+  // Fast path for 16-bit pixels, avoids decoding each byte
+  if (csActive && dcData && !bits18 && !pixCount && (command == HOST_RAMWR || command == HOST_RAMWRC)) {
+    counters.dataBytes += 2;
+    storePixel(data);
+    return 0;
+  }
+
+  uint16_t ret = transfer(data >> 8) << 8;
+  return ret | transfer(data & 0xFF);
+}
+
+/***************************************************************************************
+** Function name:           writeBlock
+** Description:             Write a block of pixels of the same colour
+***************************************************************************************/
+void TFT_eSPI_HostPanel::writeBlock(uint16_t color, uint32_t len)
+{
+  if (csActive && dcData && !bits18 && !pixCount && (command == HOST_RAMWR || command == HOST_RAMWRC)) {
+    counters.dataBytes += len << 1;
+    while (len--) storePixel(color);
+    return;
+  }
+
+  while (len--) transfer16(color);
+}
+
+/***************************************************************************************
+** Function name:           writePixels
+** Description:             Write a sequence of pixels, optionally byte swapped
+***************************************************************************************/
+void TFT_eSPI_HostPanel::writePixels(const uint16_t* data, uint32_t len, bool swap)
+{
+  if (csActive && dcData && !bits18 && !pixCount && (command == HOST_RAMWR || command == HOST_RAMWRC)) {
+    counters.dataBytes += len << 1;
+    if (swap) while (len--) { storePixel((*data >> 8) | (*data << 8)); data++; }
+    else      while (len--) { storePixel(*data++); }
+    return;
+  }
+
+  if (swap) while (len--) { transfer16((*data >> 8) | (*data << 8)); data++; }
+  else      while (len--) { transfer16(*data++); }
+}
+
+/***************************************************************************************
+** Function name:           getPixel
+** Description:             Get a graphics RAM pixel in native orientation
+***************************************************************************************/
+uint16_t TFT_eSPI_HostPanel::getPixel(int32_t x, int32_t y)
+{
+  if (!gram || (x < 0) || (y < 0) || (x >= TFT_HOST_GRAM_WIDTH) || (y >= TFT_HOST_GRAM_HEIGHT)) return 0;
+  return gram[x + y * TFT_HOST_GRAM_WIDTH];
+}
+
+/***************************************************************************************
+** Function name:           fillFrame
+** Description:             Set the whole graphics RAM to one colour (no bus traffic)
+***************************************************************************************/
+void TFT_eSPI_HostPanel::fillFrame(uint16_t color)
+{
+  if (!gram) return;
+  for (uint32_t i = 0; i < TFT_HOST_GRAM_WIDTH * TFT_HOST_GRAM_HEIGHT; i++) gram[i] = color;
+}
+
+/***************************************************************************************
+** Function name:           commandByte
+** Description:             Decode a command byte (DC low)
+***************************************************************************************/
+void TFT_eSPI_HostPanel::commandByte(uint8_t c)
+{
+  counters.commands++;
+
+  command    = c;
+  paramCount = 0;
+  pixCount   = 0;
+
+  switch (c) {
+    case HOST_SWRESET:
+      reset();
+      csActive = true; // Still selected
+      break;
+    case HOST_CASET:
+    case HOST_PASET:
+      counters.windows++;
+      break;
+    case HOST_RAMWR:
+    case HOST_RAMRD:
+      // Address pointer returns to the window start
+      col  = xs;
+      page = ys;
+      break;
+    default:
+      break;
+  }
+}
+
+/***************************************************************************************
+** Function name:           dataByte
+** Description:             Decode a data byte (DC high) written to the controller
+***************************************************************************************/
+void TFT_eSPI_HostPanel::dataByte(uint8_t d)
+{
+  counters.dataBytes++;
+
+  switch (command) {
+    case HOST_CASET:
+    case HOST_PASET:
+      if (paramCount < 4) param[paramCount++] = d;
+      if (paramCount == 4) {
+        uint16_t s = (param[0] << 8) | param[1];
+        uint16_t e = (param[2] << 8) | param[3];
+        if (command == HOST_CASET) { xs = s; xe = e; }
+        else                       { ys = s; ye = e; }
+        paramCount++; // Ignore any further bytes
+      }
+      break;
+
+    case HOST_MADCTL:
+      if (paramCount++ == 0) madctl = d;
+      break;
+
+    case HOST_COLMOD:
+      if (paramCount++ == 0) bits18 = ((d & 0x07) == 0x06);
+      break;
+
+    case HOST_RAMWR:
+    case HOST_RAMWRC:
+      pixByte[pixCount++] = d;
+      if (bits18) {
+        if (pixCount == 3) {
+          storePixel(((pixByte[0] & 0xF8) << 8) | ((pixByte[1] & 0xFC) << 3) | (pixByte[2] >> 3));
+          pixCount = 0;
+        }
+      }
+      else if (pixCount == 2) {
+        storePixel((pixByte[0] << 8) | pixByte[1]);
+        pixCount = 0;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/***************************************************************************************
+** Function name:           readByte
+** Description:             Clock a byte out of graphics RAM after RAMRD
+***************************************************************************************/
+uint8_t TFT_eSPI_HostPanel::readByte(void)
+{
+  counters.readBytes++;
+
+  // First byte after the RAMRD command is a dummy read
+  if (paramCount == 0) { paramCount = 1; return 0; }
+
+  // Pixels are always read as 3 bytes, colour in the top 6 bits of each
+  if (pixCount == 0) {
+    uint16_t color = fetchPixel();
+    pixByte[0] = (color & 0xF800) >> 8;
+    pixByte[1] = (color & 0x07E0) >> 3;
+    pixByte[2] = (color & 0x001F) << 3;
+  }
+
+  uint8_t ret = pixByte[pixCount++];
+  if (pixCount == 3) pixCount = 0;
+
+  return ret;
+}
+
+/***************************************************************************************
+** Function name:           gramIndex
+** Description:             Map the address pointer to a graphics RAM index
+***************************************************************************************/
+int32_t TFT_eSPI_HostPanel::gramIndex(void)
+{
+  int32_t x = col;
+  int32_t y = page;
+
+  if (madctl & HOST_MAD_MV) { int32_t t = x; x = y; y = t; }
+  if (madctl & HOST_MAD_MX) x = TFT_HOST_GRAM_WIDTH  - 1 - x;
+  if (madctl & HOST_MAD_MY) y = TFT_HOST_GRAM_HEIGHT - 1 - y;
+
+  if ((x < 0) || (y < 0) || (x >= TFT_HOST_GRAM_WIDTH) || (y >= TFT_HOST_GRAM_HEIGHT)) return -1;
+
+  return x + y * TFT_HOST_GRAM_WIDTH;
+}
+
+/***************************************************************************************
+** Function name:           nextAddress
+** Description:             Advance the address pointer within the window
+***************************************************************************************/
+void TFT_eSPI_HostPanel::nextAddress(void)
+{
+  if (col++ >= xe) {
+    col = xs;
+    if (page++ >= ye) page = ys;
+  }
+}
+
+/***************************************************************************************
+** Function name:           storePixel
+** Description:             Write a pixel at the address pointer and advance it
+***************************************************************************************/
+void TFT_eSPI_HostPanel::storePixel(uint16_t color)
+{
+  int32_t i = gramIndex();
+  if (gram && i >= 0) gram[i] = color;
+  counters.pixelsWritten++;
+  nextAddress();
+}
+
+/***************************************************************************************
+** Function name:           fetchPixel
+** Description:             Read a pixel at the address pointer and advance it
+***************************************************************************************/
+uint16_t TFT_eSPI_HostPanel::fetchPixel(void)
+{
+  int32_t i = gramIndex();
+  uint16_t color = (gram && i >= 0) ? gram[i] : 0;
+  counters.pixelsRead++;
+  nextAddress();
+  return color;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////
+#if defined (SPI_18BIT_DRIVER) // SPI 18-bit colour
+////////////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************************
+** Function name:           pushBlock - for host and 3 byte RGB display
+** Description:             Write a block of pixels of the same colour
+***************************************************************************************/
+void TFT_eSPI::pushBlock(uint16_t color, uint32_t len)
+{
+  while ( len-- ) {tft_Write_16(color);}
+}
+
+/***************************************************************************************
+** Function name:           pushPixels - for host and 3 byte RGB display
+** Description:             Write a sequence of pixels
+***************************************************************************************/
+void TFT_eSPI::pushPixels(const void* data_in, uint32_t len){
+
+  uint16_t *data = (uint16_t*)data_in;
+  // 18-bit write macro is not endianess dependant, hence !_swapBytes
+  if (!_swapBytes) while ( len-- ) {tft_Write_16S(*data); data++;}
+  else while ( len-- ) {tft_Write_16(*data); data++;}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+#else //                   Standard SPI 16-bit colour TFT
+////////////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************************
+** Function name:           pushBlock - for host
+** Description:             Write a block of pixels of the same colour
+***************************************************************************************/
+void TFT_eSPI::pushBlock(uint16_t color, uint32_t len){
+
+  spi.writeBlock(color, len);
+}
+
+/***************************************************************************************
+** Function name:           pushPixels - for host
+** Description:             Write a sequence of pixels
+***************************************************************************************/
+void TFT_eSPI::pushPixels(const void* data_in, uint32_t len){
+
+  // Pixels are sent byte swapped unless the sketch has set swap bytes
+  spi.writePixels((const uint16_t*)data_in, len, !_swapBytes);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+#endif // End of display interface specific functions
+////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////
+//                                DMA FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////
+
+//                No DMA on the host, the DMA functions are not built
@@ -0,0 +1,224 @@
+        ////////////////////////////////////////////////////
+        //       TFT_eSPI host (PC) driver functions      //
+        ////////////////////////////////////////////////////
+
+// This is a driver for building the library on a desktop host (e.g. x86 Linux)
+// so rendering can be profiled and checked in CI without a board or a scope.
+// The TFT is replaced by a model of an ILI9341/ST7789 class controller that
+// decodes the command stream (CASET, PASET, RAMWR, RAMRD, MADCTL, COLMOD...)
+// into a RAM framebuffer and counts the bus traffic.
+
+// Enable by adding -DTFT_ESPI_HOST to the compiler command line, the sketch
+// tft_setup.h is read too late to select the processor. test/host has the
+// Arduino.h and Print.h needed (SPI.h is not used), a setup and a test.
+
+// 8-bit parallel interface to TFT is not supported by the host model
+
+#ifndef _TFT_eSPI_HOSTH_
+#define _TFT_eSPI_HOSTH_
+
+// Processor ID reported by getSetup()
+#define PROCESSOR_ID 0x0F0F
+
+// Include processor specific header
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Font tables hold pointers that are read with pgm_read_dword, so read a
+// full pointer width on 64-bit hosts. memcpy keeps strict aliasing intact
+static inline uintptr_t tft_host_read_ptr(const void *addr)
+{
+  uintptr_t v;
+  memcpy(&v, addr, sizeof(v));
+  return v;
+}
+#undef pgm_read_dword
+#define pgm_read_dword(addr) tft_host_read_ptr(addr)
+
+// Processor specific code used by SPI bus transaction startWrite and endWrite functions
+#define SET_BUS_WRITE_MODE // Not used
+#define SET_BUS_READ_MODE  // Not used
+
+// Code to check if DMA is busy, used by SPI bus transaction startWrite and endWrite functions
+#define DMA_BUSY_CHECK // Not used so leave blank
+
+// To be safe, SUPPORT_TRANSACTIONS is assumed mandatory
+#if !defined (SUPPORT_TRANSACTIONS)
+  #define SUPPORT_TRANSACTIONS
+#endif
+
+// Initialise processor specific SPI functions, used by init()
+#define INIT_TFT_DATA_BUS
+
+// Size of the controller graphics RAM, ILI9341 and ST7789 are both 240 x 320
+// The model clips writes outside this area in the same way as the real chip
+#ifndef TFT_HOST_GRAM_WIDTH
+  #define TFT_HOST_GRAM_WIDTH  240
+#endif
+#ifndef TFT_HOST_GRAM_HEIGHT
+  #define TFT_HOST_GRAM_HEIGHT 320
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Model of the TFT controller, this takes the place of the SPI port
+////////////////////////////////////////////////////////////////////////////////////////
+class TFT_eSPI_HostPanel {
+
+ public:
+
+  TFT_eSPI_HostPanel(void);
+  ~TFT_eSPI_HostPanel(void);
+
+  // SPI port functions called by the library
+  void     begin(void)                { }
+  void     end(void)                  { }
+  void     setFrequency(uint32_t freq) { frequency = freq; }
+  uint8_t  transfer(uint8_t data);
+  uint16_t transfer16(uint16_t data);
+
+  // Control lines, driven by the CS_L/CS_H and DC_C/DC_D macros
+  void     csLow(void)  { if (!csActive) { csActive = true; counters.selects++; } }
+  void     csHigh(void) { csActive = false; }
+  void     dcLow(void)  { dcData = false; }
+  void     dcHigh(void) { dcData = true; }
+
+  // Block transfers used by pushBlock() and pushPixels(), bus accounting is the
+  // same as the equivalent sequence of transfer16() calls
+  void     writeBlock(uint16_t color, uint32_t len);
+  void     writePixels(const uint16_t* data, uint32_t len, bool swap);
+
+  // Reset the controller state, the graphics RAM content is retained
+  void     reset(void);
+
+  // Graphics RAM access for test and benchmark code, coordinates are the
+  // controller native (rotation 0, MADCTL = 0) orientation
+  uint16_t* frameBuffer(void) { return gram; }
+  uint16_t gramWidth(void)    { return TFT_HOST_GRAM_WIDTH; }
+  uint16_t gramHeight(void)   { return TFT_HOST_GRAM_HEIGHT; }
+  uint16_t getPixel(int32_t x, int32_t y);
+  void     fillFrame(uint16_t color);
+
+  // Bus traffic counters, all are cumulative until resetCounters() is called
+  typedef struct
+  {
+    uint32_t selects;      // Number of CS low transitions
+    uint32_t commands;     // Command bytes (DC low)
+    uint32_t dataBytes;    // Data bytes written (DC high), includes pixels
+    uint32_t readBytes;    // Bytes clocked in from the TFT, includes dummy bytes
+    uint32_t windows;      // CASET + PASET commands
+    uint32_t pixelsWritten;// Pixels written to graphics RAM (including clipped)
+    uint32_t pixelsRead;   // Pixels read from graphics RAM
+  } counters_t;
+
+  counters_t counters;
+  void     resetCounters(void) { memset(&counters, 0, sizeof(counters)); }
+
+  uint32_t frequency;      // Last SPI clock rate set, for reference only
+
+ private:
+
+  void     commandByte(uint8_t c);
+  void     dataByte(uint8_t d);
+  uint8_t  readByte(void);
+  void     storePixel(uint16_t color);
+  uint16_t fetchPixel(void);
+  void     nextAddress(void);
+  int32_t  gramIndex(void);
+
+  uint16_t* gram;          // Graphics RAM, one 565 colour per pixel
+
+  bool     csActive;
+  bool     dcData;
+
+  uint8_t  command;        // Command being processed, 0 = none
+  uint8_t  param[4];       // Parameter bytes received for the command
+  uint8_t  paramCount;
+
+  uint8_t  madctl;         // Memory access control (MY, MX, MV)
+  bool     bits18;         // COLMOD 18-bit (3 bytes/pixel) else 16-bit (2 bytes/pixel)
+
+  uint16_t xs, xe, ys, ye; // Column and page address window
+  uint16_t col, page;      // Current graphics RAM address pointer
+
+  uint8_t  pixByte[3];     // Partial pixel being assembled or read out
+  uint8_t  pixCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Define the DC (TFT Data/Command or Register Select (RS))pin drive code
+////////////////////////////////////////////////////////////////////////////////////////
+#define DC_C spi.dcLow()
+#define DC_D spi.dcHigh()
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Define the CS (TFT chip select) pin drive code
+////////////////////////////////////////////////////////////////////////////////////////
+#define CS_L spi.csLow()
+#define CS_H spi.csHigh()
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Make sure TFT_RD is defined if not used to avoid an error message
+////////////////////////////////////////////////////////////////////////////////////////
+#ifndef TFT_RD
+  #define TFT_RD -1
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Define the touch screen chip select pin drive code
+////////////////////////////////////////////////////////////////////////////////////////
+#define T_CS_L // No macro allocated so it generates no code
+#define T_CS_H // No macro allocated so it generates no code
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Make sure TFT_MISO is defined if not used to avoid an error message
+////////////////////////////////////////////////////////////////////////////////////////
+#ifndef TFT_MISO
+  #define TFT_MISO -1
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Macros to write commands/pixel colour data to the TFT model
+////////////////////////////////////////////////////////////////////////////////////////
+#if  defined (SPI_18BIT_DRIVER) // SPI 18-bit colour
+
+  // Write 8 bits to TFT
+  #define tft_Write_8(C)   spi.transfer(C)
+
+  // Convert 16-bit colour to 18-bit and write in 3 bytes
+  #define tft_Write_16(C)  spi.transfer(((C) & 0xF800)>>8); \
+                           spi.transfer(((C) & 0x07E0)>>3); \
+                           spi.transfer(((C) & 0x001F)<<3)
+
+  // Convert swapped byte 16-bit colour to 18-bit and write in 3 bytes
+  #define tft_Write_16S(C) spi.transfer((C) & 0xF8); \
+                           spi.transfer(((C) & 0xE000)>>11 | ((C) & 0x07)<<5); \
+                           spi.transfer(((C) & 0x1F00)>>5)
+
+#else
+
+  #define tft_Write_8(C)   spi.transfer(C)
+  #define tft_Write_16(C)  spi.transfer16(C)
+  #define tft_Write_16S(C) spi.transfer16(((C)>>8) | ((C)<<8))
+
+#endif
+
+  // Write 32 bits to TFT
+  #define tft_Write_32(C)  spi.transfer16((C)>>16); spi.transfer16((uint16_t)(C))
+
+  // Write two address coordinates
+  #define tft_Write_32C(C,D) spi.transfer16(C); spi.transfer16(D)
+
+  // Write same value twice
+  #define tft_Write_32D(C) spi.transfer16(C); spi.transfer16(C)
+
+#ifndef tft_Write_16N
+  #define tft_Write_16N tft_Write_16
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Macros to read from display
+////////////////////////////////////////////////////////////////////////////////////////
+#define tft_Read_8() spi.transfer(0)
+
+#endif // Header end
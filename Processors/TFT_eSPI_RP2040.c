@@ -70,6 +70,20 @@
 #ifdef RP2040_DMA
   int32_t            dma_tx_channel;
   dma_channel_config dma_tx_config;
+
+  // Used by the DMA interrupt to report finished buffers
+  TFT_eSPI *dmaTFT = nullptr;
+
+  // Block list being sent, each block is started in turn by the DMA interrupt
+  const tftDmaBlock_t * volatile dmaList = nullptr; // Block being sent, nullptr when idle
+  volatile uint32_t dmaListCount = 0;            // Blocks following this one
+
+  // List queued behind the one being sent, started by the DMA interrupt
+  const tftDmaBlock_t * volatile dmaNext = nullptr;
+  volatile uint32_t dmaNextCount = 0;
+
+  // Fill colour, the DMA read address does not increment so it is read repeatedly
+  uint16_t dmaFillColor;
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -570,6 +584,79 @@ These are created in header file:
   dma_channel_config dma_tx_config;
 */
 
+/***************************************************************************************
+** Function name:           dmaSend
+** Description:             Start the DMA transfer of one block
+***************************************************************************************/
+static void dmaSend(const tftDmaBlock_t *block)
+{
+  dma_channel_config config = dma_tx_config;
+  const uint16_t *data = block->data;
+
+  if (data == nullptr) {
+    dmaFillColor = block->color;
+    data = &dmaFillColor;
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_bswap(&config, false);
+  }
+  else channel_config_set_bswap(&config, !(block->flags & DMA_BLOCK_SWAP));
+
+#if !defined (RP2040_PIO_INTERFACE)
+  dma_channel_configure(dma_tx_channel, &config, &spi_get_hw(SPI_X)->dr, data, block->len, true);
+#else
+  dma_channel_configure(dma_tx_channel, &config, &tft_pio->txf[pio_sm], data, block->len, true);
+#endif
+}
+
+/***************************************************************************************
+** Function name:           dmaStart
+** Description:             Start sending a block list, the window must be set
+***************************************************************************************/
+static void dmaStart(const tftDmaBlock_t *list, uint32_t count)
+{
+  // Empty blocks are skipped as a zero length transfer does not raise an interrupt
+  while (count && (list->len == 0)) { list++; count--; }
+  if (count == 0) return;
+
+  dmaListCount = count - 1;
+  dmaList = list;
+  dmaSend(list);
+}
+
+/***************************************************************************************
+** Function name:           dmaIrq
+** Description:             DMA end interrupt, starts the next block of the list
+***************************************************************************************/
+// Shared with other users of DMA_IRQ_0 so check the interrupt is for this channel
+static void dmaIrq(void)
+{
+  if (!(dma_hw->ints0 & (1u << dma_tx_channel))) return;
+  dma_hw->ints0 = 1u << dma_tx_channel; // Clear the interrupt
+
+  const tftDmaBlock_t *done = dmaList;
+  if (done == nullptr) return;
+
+  // Start the next block with pixels to send
+  const tftDmaBlock_t *next = done;
+  do {
+    if (dmaListCount == 0) { next = nullptr; break; }
+    next++;
+    dmaListCount--;
+  } while (next->len == 0);
+
+  dmaList = next;
+  if (next) dmaSend(next);
+  else if (dmaNext) {
+    const tftDmaBlock_t *list = dmaNext;
+    dmaNext = nullptr;
+    dmaStart(list, dmaNextCount);
+  }
+
+  // Buffer can now be re-used, callback runs in the interrupt so must be short
+  dmaDoneCallback dmaDone = dmaTFT->getDMACallback();
+  if (done->data && dmaDone) dmaDone(done->data);
+}
+
 /***************************************************************************************
 ** Function name:           dmaBusy
 ** Description:             Check if DMA is busy
@@ -577,7 +664,7 @@ These are created in header file:
 bool TFT_eSPI::dmaBusy(void) {
   if (!DMA_Enabled) return false;
 
-  if (dma_channel_is_busy(dma_tx_channel)) return true;
+  if ((dmaList != nullptr) || dma_channel_is_busy(dma_tx_channel)) return true;
 
 #if !defined (RP2040_PIO_INTERFACE)
   // For SPI must also wait for FIFO to flush and reset format
@@ -594,7 +681,7 @@ bool TFT_eSPI::dmaBusy(void) {
 ***************************************************************************************/
 void TFT_eSPI::dmaWait(void)
 {
-  while (dma_channel_is_busy(dma_tx_channel));
+  while ((dmaList != nullptr) || dma_channel_is_busy(dma_tx_channel));
 
 #if !defined (RP2040_PIO_INTERFACE)
   // For SPI must also wait for FIFO to flush and reset format
@@ -603,23 +690,42 @@ void TFT_eSPI::dmaWait(void)
 #endif
 }
 
+/***************************************************************************************
+** Function name:           pushListDMA
+** Description:             Send a list of image and fill blocks to the window
+***************************************************************************************/
+// The DMA interrupt starts each block in turn, bytes are swapped during the transfer.
+// One list can be queued behind the list being sent, the list must stay valid until the
+// DMA ends and the image buffers must not be changed until they are reported
+void TFT_eSPI::pushListDMA(const tftDmaBlock_t *list, uint32_t count)
+{
+  if ((list == nullptr) || (!DMA_Enabled)) return;
+
+  // Wait for the queued list to start
+  while (dmaNext != nullptr);
+
+  // The interrupt must not end the list being sent between the check and the queueing
+  uint32_t irq = save_and_disable_interrupts();
+  if (dmaList == nullptr) dmaStart(list, count);
+  else {
+    dmaNextCount = count;
+    dmaNext = list;
+  }
+  restore_interrupts(irq);
+}
+
 /***************************************************************************************
 ** Function name:           pushPixelsDMA
 ** Description:             Push pixels to TFT
 ***************************************************************************************/
 void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
 {
-  if ((len == 0) || (!DMA_Enabled)) return;
+  static tftDmaBlock_t block; // Must stay valid until the DMA ends
 
   dmaWait();
 
-  channel_config_set_bswap(&dma_tx_config, !_swapBytes);
-
-#if !defined (RP2040_PIO_INTERFACE)
-  dma_channel_configure(dma_tx_channel, &dma_tx_config, &spi_get_hw(SPI_X)->dr, (uint16_t*)image, len, true);
-#else
-  dma_channel_configure(dma_tx_channel, &dma_tx_config, &tft_pio->txf[pio_sm], (uint16_t*)image, len, true);
-#endif
+  block = { image, len, 0, _swapBytes ? (uint8_t)DMA_BLOCK_SWAP : (uint8_t)0 };
+  pushListDMA(&block, 1);
 }
 
 /***************************************************************************************
@@ -662,17 +768,51 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
     memcpy(buffer, image, len*2);
   }
 
+  static tftDmaBlock_t block; // Must stay valid until the DMA ends
+
   dmaWait(); // In case we did not wait earlier
 
   setAddrWindow(x, y, dw, dh);
 
-  channel_config_set_bswap(&dma_tx_config, !_swapBytes);
+  block = { buffer, len, 0, _swapBytes ? (uint8_t)DMA_BLOCK_SWAP : (uint8_t)0 };
+  dmaStart(&block, 1);
+}
 
-#if !defined (RP2040_PIO_INTERFACE)
-  dma_channel_configure(dma_tx_channel, &dma_tx_config, &spi_get_hw(SPI_X)->dr, (uint16_t*)buffer, len, true);
-#else
-  dma_channel_configure(dma_tx_channel, &dma_tx_config, &tft_pio->txf[pio_sm], (uint16_t*)buffer, len, true);
-#endif
+/***************************************************************************************
+** Function name:           pushBlockDMA
+** Description:             Fill the window set by setAddrWindow() with a colour
+***************************************************************************************/
+void TFT_eSPI::pushBlockDMA(uint16_t color, uint32_t len)
+{
+  static tftDmaBlock_t block; // Must stay valid until the DMA ends
+
+  dmaWait();
+
+  block = { nullptr, len, color, 0 };
+  pushListDMA(&block, 1);
+}
+
+/***************************************************************************************
+** Function name:           fillRectDMA
+** Description:             Fill a rectangle using DMA, returns before the fill ends
+***************************************************************************************/
+void TFT_eSPI::fillRectDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  if ((x >= _vpW) || (y >= _vpH) || (!DMA_Enabled)) return;
+
+  if (x < _vpX) { w -= _vpX - x; x = _vpX; }
+  if (y < _vpY) { h -= _vpY - y; y = _vpY; }
+
+  if ((x + w) > _vpW ) w = _vpW - x;
+  if ((y + h) > _vpH ) h = _vpH - y;
+
+  if (w < 1 || h < 1) return;
+
+  dmaWait();
+
+  setAddrWindow(x, y, w, h);
+
+  pushBlockDMA(color, w * h);
 }
 
 /***************************************************************************************
@@ -698,6 +838,14 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
   channel_config_set_dreq(&dma_tx_config, pio_get_dreq(tft_pio, pio_sm, true));
 #endif
 
+  // The interrupt at the end of each block starts the next block of a list
+  dmaTFT = this;
+  dmaList = nullptr;
+  dmaNext = nullptr;
+  dma_channel_set_irq0_enabled(dma_tx_channel, true);
+  irq_add_shared_handler(DMA_IRQ_0, dmaIrq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(DMA_IRQ_0, true);
+
   DMA_Enabled = true;
   return true;
 }
@@ -709,6 +857,9 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
 void TFT_eSPI::deInitDMA(void)
 {
   if (!DMA_Enabled) return;
+  dmaWait();
+  dma_channel_set_irq0_enabled(dma_tx_channel, false);
+  irq_remove_handler(DMA_IRQ_0, dmaIrq);
   dma_channel_unclaim(dma_tx_channel);
   DMA_Enabled = false;
 }
@@ -22,6 +22,39 @@
 #ifdef STM32_DMA
   // DMA HAL handle
   DMA_HandleTypeDef dmaHal;
+
+  // Used by the DMA end interrupt to report finished buffers
+  TFT_eSPI *dmaTFT = nullptr;
+
+  // Block list being sent, each part is started in turn by the DMA end interrupt
+  const tftDmaBlock_t * volatile dmaList = nullptr; // Block being sent, nullptr when idle
+  volatile uint32_t dmaListCount = 0;            // Blocks following this one
+  volatile uint32_t dmaListPos   = 0;            // Pixels of the block already started
+
+  // List queued behind the transfer in progress, started by the DMA end interrupt
+  const tftDmaBlock_t * volatile dmaNext = nullptr;
+  volatile uint32_t dmaNextCount = 0;
+
+  // Colour block repeated for fill blocks
+  uint16_t dmaFillBuffer[DMA_FILL_PIXELS];
+
+  #if (DMA_QUEUE_SIZE > 1)
+    // Transfers waiting behind the one in progress, started in turn by the DMA end interrupt.
+    // The window is prepared when the transfer is queued as CASET, x range, PASET, y range
+    // and RAMWR bytes, unchanged ranges are left out. Commands are 1 byte, ranges 4 bytes
+    typedef struct { tftDmaBlock_t block; uint8_t win[11]; uint8_t winLen; } dmaJob_t;
+    dmaJob_t dmaJob[DMA_QUEUE_SIZE - 1];
+    volatile uint8_t dmaHead  = 0; // Oldest waiting transfer
+    volatile uint8_t dmaCount = 0; // Number of waiting transfers
+
+    // Transfer whose window bytes are being sent, dmaWinLen is 0 when none
+    dmaJob_t dmaWinJob;
+    volatile uint8_t dmaWinPos = 0;
+    volatile uint8_t dmaWinLen = 0;
+    #define DMA_WIN_BUSY (dmaWinLen != 0)
+  #else
+    #define DMA_WIN_BUSY false
+  #endif
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -442,6 +475,136 @@ void TFT_eSPI::pushPixels(const void* data_in, uint32_t len)
 #if defined STM32_DMA && !defined (TFT_PARALLEL_8_BIT) //       DMA FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////
 
+/***************************************************************************************
+** Function name:           dmaListNext
+** Description:             Start the next part of the block list, false at the end
+***************************************************************************************/
+static bool dmaListNext(void)
+{
+  // Move on to the next block with pixels to send
+  while (dmaListPos >= dmaList->len) {
+    if (dmaListCount == 0) return false;
+    dmaList++;
+    dmaListCount--;
+    dmaListPos = 0;
+  }
+
+  const tftDmaBlock_t *block = dmaList;
+  uint32_t len = block->len - dmaListPos;
+  uint16_t *data;
+
+  if (block->data == nullptr) {
+    if (dmaListPos == 0) {
+      // DMA sends the bytes in memory order
+      uint16_t color = (block->color >> 8) | (block->color << 8);
+      for (uint32_t i = 0; i < DMA_FILL_PIXELS; i++) dmaFillBuffer[i] = color;
+    }
+    if (len > DMA_FILL_PIXELS) len = DMA_FILL_PIXELS;
+    data = dmaFillBuffer;
+  }
+  else {
+    // DMA byte count for transmit is only 16 bits maximum
+    if (len > 0x7FFF) len = 0x7FFF;
+    data = block->data + dmaListPos;
+  }
+
+  dmaListPos += len;
+  HAL_SPI_Transmit_DMA(&spiHal, (uint8_t*)data, len << 1);
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           dmaStart
+** Description:             Start sending a block list, the window must be set
+***************************************************************************************/
+static void dmaStart(const tftDmaBlock_t *list, uint32_t count)
+{
+  dmaListCount = count - 1;
+  dmaListPos = 0;
+  dmaList = list;
+
+  if (!dmaListNext()) dmaList = nullptr; // Nothing to send
+}
+
+
+#if (DMA_QUEUE_SIZE > 1)
+/***************************************************************************************
+** Function name:           dmaWinNext
+** Description:             Send the next window command or range, then the pixels
+***************************************************************************************/
+static void dmaWinNext(void)
+{
+  uint8_t pos = dmaWinPos;
+
+  if (pos < dmaWinLen) {
+    // Ranges follow their command byte, DC can change here as the SPI has finished
+    uint8_t len = (pos % 5) ? 4 : 1;
+    if (len == 1) { DC_C; }
+    else { DC_D; }
+    dmaWinPos = pos + len;
+    HAL_SPI_Transmit_DMA(&spiHal, dmaWinJob.win + pos, len);
+    return;
+  }
+
+  DC_D;
+  dmaWinLen = 0;
+  dmaStart(&dmaWinJob.block, 1);
+}
+#endif
+
+
+/***************************************************************************************
+** Function name:           dmaEnd
+** Description:             Called by the DMA interrupt, starts the next part or transfer
+***************************************************************************************/
+// Only DMA transfers are started here, the window of a queued transfer was prepared by
+// pushImageDMA() so the interrupt does not write to the SPI or change the TFT_eSPI state
+static void dmaEnd(void)
+{
+  // Half transfer interrupts also arrive here, SPI is ready once the last byte is sent
+  if (spiHal.State != HAL_SPI_STATE_READY) return;
+
+#if (DMA_QUEUE_SIZE > 1)
+  if (dmaWinLen) { dmaWinNext(); return; }
+#endif
+
+  if (dmaList == nullptr) return;
+
+  // Image block just finished, reported once the next part has been started
+  uint16_t *done = (dmaListPos >= dmaList->len) ? dmaList->data : nullptr;
+
+  if (!dmaListNext()) {
+    dmaList = nullptr;
+
+    // A queued list was pushed before any of the waiting transfers
+    if (dmaNext) {
+      const tftDmaBlock_t *list = dmaNext;
+      dmaNext = nullptr;
+      dmaStart(list, dmaNextCount);
+    }
+#if (DMA_QUEUE_SIZE > 1)
+    else if (dmaCount) {
+      // The job slot can be re-used once dmaCount is decremented so take a copy
+      dmaWinJob = dmaJob[dmaHead];
+
+      if (++dmaHead >= DMA_QUEUE_SIZE - 1) dmaHead = 0;
+      dmaCount--;
+
+      dmaWinPos = 0;
+      dmaWinLen = dmaWinJob.winLen;
+      dmaWinNext();
+    }
+#endif
+  }
+
+  // Buffer can now be re-used, callback runs in the interrupt so must be short
+  dmaDoneCallback dmaDone = dmaTFT->getDMACallback();
+  if (done && dmaDone) dmaDone(done);
+}
+
+
 /***************************************************************************************
 ** Function name:           dmaBusy
 ** Description:             Check if DMA is busy (usefully non-blocking!)
@@ -450,7 +613,7 @@ void TFT_eSPI::pushPixels(const void* data_in, uint32_t len)
 bool TFT_eSPI::dmaBusy(void)
 {
   //return (dmaHal.State == HAL_DMA_STATE_BUSY);  // Do not use, SPI may still be busy
-  return (spiHal.State == HAL_SPI_STATE_BUSY_TX); // Check if SPI Tx is busy
+  return (dmaList != nullptr) || DMA_WIN_BUSY || (spiHal.State == HAL_SPI_STATE_BUSY_TX); // Check if SPI Tx is busy
 }
 
 
@@ -461,27 +624,86 @@ bool TFT_eSPI::dmaBusy(void)
 void TFT_eSPI::dmaWait(void)
 {
   //return (dmaHal.State == HAL_DMA_STATE_BUSY);  // Do not use, SPI may still be busy
-  while (spiHal.State == HAL_SPI_STATE_BUSY_TX); // Check if SPI Tx is busy
+  while ((dmaList != nullptr) || DMA_WIN_BUSY || (spiHal.State == HAL_SPI_STATE_BUSY_TX)); // Check if SPI Tx is busy
+}
+
+
+/***************************************************************************************
+** Function name:           dmaQueueDepth
+** Description:             Number of pixel transfers queued or in progress
+***************************************************************************************/
+uint8_t TFT_eSPI::dmaQueueDepth(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  uint8_t depth = (dmaList != nullptr) || DMA_WIN_BUSY || (spiHal.State == HAL_SPI_STATE_BUSY_TX);
+  depth += (dmaNext != nullptr);
+#if (DMA_QUEUE_SIZE > 1)
+  depth += dmaCount;
+#endif
+
+  __set_PRIMASK(primask);
+
+  return depth;
+}
+
+
+/***************************************************************************************
+** Function name:           pushListDMA
+** Description:             Send a list of image and fill blocks to the window
+***************************************************************************************/
+// The DMA end interrupt starts each block in turn, large blocks are sent in parts.
+// One list can be queued behind the transfer in progress, the list must stay valid until
+// the DMA ends and the image buffers must not be changed until they are reported
+void TFT_eSPI::pushListDMA(const tftDmaBlock_t *list, uint32_t count)
+{
+  if ((list == nullptr) || (count == 0) || (!DMA_Enabled)) return;
+
+  // Bytes are swapped before the transfer starts
+  for (uint32_t i = 0; i < count; i++) {
+    if ((list[i].data == nullptr) || !(list[i].flags & DMA_BLOCK_SWAP)) continue;
+    uint16_t *data = list[i].data;
+    for (uint32_t j = 0; j < list[i].len; j++) (data[j] = data[j] << 8 | data[j] >> 8);
+  }
+
+  // Wait for the queued list to start, and for waiting transfers as they were pushed first
+#if (DMA_QUEUE_SIZE > 1)
+  while ((dmaNext != nullptr) || dmaCount);
+#else
+  while (dmaNext != nullptr);
+#endif
+
+  // The interrupt must not end the transfer in progress between the check and the queueing
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  bool queued = (dmaList != nullptr) || DMA_WIN_BUSY;
+  if (queued) {
+    dmaNextCount = count;
+    dmaNext = list;
+  }
+  __set_PRIMASK(primask);
+
+  if (queued) return;
+
+  dmaWait(); // For the SPI to finish the last byte
+  dmaStart(list, count);
 }
 
 
 /***************************************************************************************
 ** Function name:           pushPixelsDMA
-** Description:             Push pixels to TFT (len must be less than 32767)
+** Description:             Push pixels to TFT
 ***************************************************************************************/
 // This will byte swap the original image if setSwapBytes(true) was called by sketch.
 void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
 {
-  if (len == 0) return;
-
-  // Wait for any current DMA transaction to end
-  while (spiHal.State == HAL_SPI_STATE_BUSY_TX); // Check if SPI Tx is busy
+  static tftDmaBlock_t block; // Must stay valid until the DMA ends
 
-  if(_swapBytes) {
-    for (uint32_t i = 0; i < len; i++) (image[i] = image[i] << 8 | image[i] >> 8);
-  }
+  dmaWait();
 
-  HAL_SPI_Transmit_DMA(&spiHal, (uint8_t*)image, len << 1);
+  block = { image, len, 0, _swapBytes ? (uint8_t)DMA_BLOCK_SWAP : (uint8_t)0 };
+  pushListDMA(&block, 1);
 }
 
 
@@ -511,7 +733,11 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
 
   if (buffer == nullptr) {
     buffer = image;
-    while (spiHal.State == HAL_SPI_STATE_BUSY_TX); // Check if SPI Tx is busy
+  #if (DMA_QUEUE_SIZE > 1)
+    // The image is only altered if clipped or swapped, otherwise it can be queued as it is
+    if ( (dw != w) || (dh != h) || _swapBytes)
+  #endif
+    dmaWait();
   }
 
   // If image is clipped, copy pixels into a contiguous block
@@ -540,18 +766,114 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
     }
   }
 
-  setWindow(x, y, x + dw - 1, y + dh - 1);
+#if (DMA_QUEUE_SIZE > 1)
+  while (dmaQueueDepth() >= DMA_QUEUE_SIZE); // Wait for space in the queue
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if ((dmaList != nullptr) || dmaWinLen) {
+    // Queue behind the transfer in progress, the DMA end interrupt will start it. The
+    // slot is free as the queue depth is below DMA_QUEUE_SIZE, interrupts are enabled
+    // while the window is prepared
+    __set_PRIMASK(primask);
+    dmaJob_t *job = &dmaJob[(dmaHead + dmaCount) % (DMA_QUEUE_SIZE - 1)];
+    job->block = { buffer, len, 0, 0 };
+
+    int32_t x1 = x + dw - 1;
+    int32_t y1 = y + dh - 1;
+    #ifdef CGRAM_OFFSET
+      x  += colstart;
+      x1 += colstart;
+      y  += rowstart;
+      y1 += rowstart;
+    #endif
+
+    #if defined (MULTI_TFT_SUPPORT) || defined (GC9A01_DRIVER)
+      addr_row = 0xFFFF;
+      addr_col = 0xFFFF;
+    #endif
+
+    // The window shadow is updated here, in queue order, so it matches the TFT once
+    // the queue has been sent
+    uint32_t xw = ((uint32_t)x << 16) | (uint16_t)x1;
+    uint32_t yw = ((uint32_t)y << 16) | (uint16_t)y1;
+
+    uint8_t *win = job->win;
+    if (addr_col != xw) {
+      *win++ = TFT_CASET; *win++ = x >> 8; *win++ = x; *win++ = x1 >> 8; *win++ = x1;
+      addr_col = xw;
+    }
+    if (addr_row != yw) {
+      *win++ = TFT_PASET; *win++ = y >> 8; *win++ = y; *win++ = y1 >> 8; *win++ = y1;
+      addr_row = yw;
+    }
+    *win++ = TFT_RAMWR;
+    job->winLen = win - job->win;
 
-  // DMA byte count for transmit is only 16 bits maximum, so to avoid this constraint
-  // small transfers are performed using a blocking call until DMA capacity is reached.
-  // User sketch can prevent blocking by managing pixel count and splitting into blocks
-  // of 32767 pixels maximum. (equivalent to an area of ~320 x 100 pixels)
-  while(len>0x7FFF) { // Transfer 16-bit pixels in blocks if len*2 over 65534 bytes
-    HAL_SPI_Transmit(&spiHal, (uint8_t*)buffer, 0x800<<1, HAL_MAX_DELAY);
-    len -= 0x800; buffer+= 0x800; // Arbitrarily send 1K pixel blocks (2Kbytes)
+    __disable_irq();
+    if ((dmaList != nullptr) || dmaWinLen) dmaCount++;
+    else {
+      // The transfer in progress has ended meanwhile so start this one now
+      dmaWinJob = *job;
+      dmaWinPos = 0;
+      dmaWinLen = dmaWinJob.winLen;
+      dmaWinNext();
+    }
+    __set_PRIMASK(primask);
+    return;
   }
-  // Send remaining pixels using DMA (max 65534 bytes)
-  HAL_SPI_Transmit_DMA(&spiHal, (uint8_t*)buffer, len << 1);
+  __set_PRIMASK(primask);
+#endif
+
+  static tftDmaBlock_t block; // Must stay valid until the DMA ends
+
+  // Wait in case a buffer was provided and the last DMA has not finished
+  dmaWait();
+
+  setWindow(x, y, x + dw - 1, y + dh - 1);
+
+  // Images over 32767 pixels are sent in parts by the DMA end interrupt
+  block = { buffer, len, 0, 0 }; // Bytes already swapped
+  dmaStart(&block, 1);
+}
+
+/***************************************************************************************
+** Function name:           pushBlockDMA
+** Description:             Fill the window set by setAddrWindow() with a colour
+***************************************************************************************/
+// A short block of colour is sent repeatedly, the DMA end interrupt starts each block
+void TFT_eSPI::pushBlockDMA(uint16_t color, uint32_t len)
+{
+  static tftDmaBlock_t block; // Must stay valid until the DMA ends
+
+  dmaWait();
+
+  block = { nullptr, len, color, 0 };
+  pushListDMA(&block, 1);
+}
+
+
+/***************************************************************************************
+** Function name:           fillRectDMA
+** Description:             Fill a rectangle using DMA, returns before the fill ends
+***************************************************************************************/
+void TFT_eSPI::fillRectDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  if ((x >= _vpW) || (y >= _vpH) || (!DMA_Enabled)) return;
+
+  if (x < _vpX) { w -= _vpX - x; x = _vpX; }
+  if (y < _vpY) { h -= _vpY - y; y = _vpY; }
+
+  if ((x + w) > _vpW ) w = _vpW - x;
+  if ((y + h) > _vpH ) h = _vpH - y;
+
+  if (w < 1 || h < 1) return;
+
+  dmaWait();
+
+  setWindow(x, y, x + w - 1, y + h - 1);
+
+  pushBlockDMA(color, w * h);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -577,6 +899,7 @@ void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t
   {
     // Call the default end of buffer handler
     HAL_DMA_IRQHandler(&dmaHal);
+    dmaEnd();
   }
 
 /***************************************************************************************
@@ -623,6 +946,8 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
 
   __HAL_LINKDMA(&spiHal, hdmatx, dmaHal);   // Attach DMA engine to SPI peripheral
 
+  dmaTFT = this;
+
   return DMA_Enabled = true;
 }
 
@@ -641,6 +966,7 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
   {
     // Call the default end of buffer handler
     HAL_DMA_IRQHandler(&dmaHal);
+    dmaEnd();
   }
 
 //*/
@@ -677,6 +1003,8 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
     HAL_NVIC_EnableIRQ(DMA1_Channel5_IRQn);  // Enable DMA end interrupt handler
   #endif
 
+  dmaTFT = this;
+
   return DMA_Enabled = true;
 }
 #endif // End of STM32F1/2/4/7xx
@@ -212,6 +212,19 @@
 #ifdef STM32_DMA
   // Code to check if DMA is busy, used by SPI DMA + transaction + endWrite functions
   #define DMA_BUSY_CHECK { if (DMA_Enabled) while(dmaBusy()); }
+
+  // Number of pushImageDMA() transfers that can be in flight, the default of 1 waits
+  // for the last DMA to end. Queued transfers are started by the DMA end interrupt.
+  // Drivers with a non-standard address window are limited to 1
+  #if !defined (DMA_QUEUE_SIZE) || defined (ILI9225_DRIVER) || defined (SSD1351_DRIVER) || defined (RPI_DISPLAY_TYPE)
+    #undef  DMA_QUEUE_SIZE
+    #define DMA_QUEUE_SIZE 1
+  #endif
+
+  // pushBlockDMA() repeats a buffer of DMA_FILL_PIXELS, restarted by the DMA end interrupt
+  #ifndef DMA_FILL_PIXELS
+    #define DMA_FILL_PIXELS 128
+  #endif
 #else
   #define DMA_BUSY_CHECK
 #endif
@@ -37,6 +37,8 @@
   #include "Processors/TFT_eSPI_nRF52840.c"
 #elif defined (EFR32MG24B220F1536IM48)
   #include "Processors/TFT_eSPI_MG24.cpp"
+#elif defined (TFT_ESPI_HOST)
+  #include "Processors/TFT_eSPI_Host.c"
 #else
   #include "Processors/TFT_eSPI_Generic.c"
 #endif
@@ -66,6 +68,49 @@
                                                        \
   if (dw < 1 || dh < 1) return;
 
+// Bus traffic accounting, compiled out unless TFT_BUS_STATS is defined
+#ifdef TFT_BUS_STATS
+  #if defined (SPI_18BIT_DRIVER) || (defined (SSD1963_DRIVER) && defined (TFT_PARALLEL_8_BIT))
+    #define BUS_STAT_PIXEL_BYTES 3
+  #else
+    #define BUS_STAT_PIXEL_BYTES 2
+  #endif
+
+  // Charge bus traffic to a drawing function until the end of the enclosing scope,
+  // nested calls are charged to the outermost function
+  class TFT_eSPI_BusStat {
+   public:
+    TFT_eSPI_BusStat(TFT_eSPI *tft, uint8_t id) : _tft(tft), _prev(tft->_busStat) {
+      if (_prev == STAT_NONE) { _tft->_busStat = id; _tft->_busStats[id].calls++; }
+    }
+    ~TFT_eSPI_BusStat() { _tft->_busStat = _prev; }
+   private:
+    TFT_eSPI *_tft;
+    uint8_t   _prev;
+  };
+
+  #define BUS_STAT(T)                (T)->_busStats[(T)->_busStat]
+  #define BUS_STAT_SCOPE_ON(T, ID)   TFT_eSPI_BusStat busStatScope(T, ID)
+  #define BUS_STAT_PIXELS_ON(T, N)   { BUS_STAT(T).pixelRuns++; BUS_STAT(T).dataBytes += (N) * BUS_STAT_PIXEL_BYTES; }
+  #define BUS_STAT_SCOPE(ID)         BUS_STAT_SCOPE_ON(this, ID)
+  #define BUS_STAT_PIXELS(N)         BUS_STAT_PIXELS_ON(this, N)
+  #define BUS_STAT_BLOCK(N)          { BUS_STAT(this).blocks++; BUS_STAT(this).dataBytes += (N) * BUS_STAT_PIXEL_BYTES; }
+  #define BUS_STAT_WRITE(N)          BUS_STAT(this).dataBytes += (N) * BUS_STAT_PIXEL_BYTES
+  #define BUS_STAT_CMD(C, D)         { BUS_STAT(this).commands += (C); BUS_STAT(this).dataBytes += (D); }
+  #define BUS_STAT_WINDOW(C, D)      { BUS_STAT(this).windows++; BUS_STAT_CMD(C, D); }
+  #define BUS_STAT_READ              BUS_STAT(this).reads++
+#else
+  #define BUS_STAT_SCOPE_ON(T, ID)
+  #define BUS_STAT_PIXELS_ON(T, N)
+  #define BUS_STAT_SCOPE(ID)
+  #define BUS_STAT_PIXELS(N)
+  #define BUS_STAT_BLOCK(N)
+  #define BUS_STAT_WRITE(N)
+  #define BUS_STAT_CMD(C, D)
+  #define BUS_STAT_WINDOW(C, D)
+  #define BUS_STAT_READ
+#endif
+
 /***************************************************************************************
 ** Function name:           Legacy - deprecated
 ** Description:             Start/end transaction
@@ -185,6 +230,11 @@ inline void TFT_eSPI::end_tft_read(void){
 ***************************************************************************************/
 void TFT_eSPI::setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum)
 {
+#ifdef TFT_DISPLAY_LIST
+  // Records are replayed with the viewport they were drawn in
+  if (_dlRecord) flush();
+#endif
+
   // Viewport metrics (not clipped)
   _xDatum  = x; // Datum x position in screen coordinates
   _yDatum  = y; // Datum y position in screen coordinates
@@ -277,6 +327,11 @@ bool TFT_eSPI::checkViewport(int32_t x, int32_t y, int32_t w, int32_t h)
 ***************************************************************************************/
 void TFT_eSPI::resetViewport(void)
 {
+#ifdef TFT_DISPLAY_LIST
+  // Records are replayed with the viewport they were drawn in
+  if (_dlRecord) flush();
+#endif
+
   // Reset viewport to the whole screen (or sprite) area
   _vpDatum = false;
   _vpOoB   = false;
@@ -434,8 +489,8 @@ bool TFT_eSPI::clipWindow(int32_t *xs, int32_t *ys, int32_t *xe, int32_t *ye)
   if (*xs < _vpX) *xs = _vpX;
   if (*ys < _vpY) *ys = _vpY;
 
-  if (*xe > _vpW) *xe = _vpW - 1;
-  if (*ye > _vpH) *ye = _vpH - 1;
+  if (*xe >= _vpW) *xe = _vpW - 1;
+  if (*ye >= _vpH) *ye = _vpH - 1;
 
   return true;  // Area is wholly or partially inside viewport
 }
@@ -494,6 +549,10 @@ TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
   _xPivot = 0;
   _yPivot = 0;
 
+#ifdef TFT_BUS_STATS
+  resetBusStats();
+#endif
+
 // Legacy support for bit GPIO masks
   cspinmask = 0;
   dcpinmask = 0;
@@ -1013,6 +1072,7 @@ void TFT_eSPI::spiwrite(uint8_t c)
 {
   begin_tft_write();
   tft_Write_8(c);
+  BUS_STAT_CMD(0, 1);
   end_tft_write();
 }
 
@@ -1024,11 +1084,16 @@ void TFT_eSPI::spiwrite(uint8_t c)
 #ifndef RM68120_DRIVER
 void TFT_eSPI::writecommand(uint8_t c)
 {
+  // The command may change the window, so it must be resent by setWindow()
+  addr_row = 0xFFFF;
+  addr_col = 0xFFFF;
+
   begin_tft_write();
 
   DC_C;
 
   tft_Write_8(c);
+  BUS_STAT_CMD(1, 0);
 
   DC_D;
 
@@ -1037,11 +1102,16 @@ void TFT_eSPI::writecommand(uint8_t c)
 #else
 void TFT_eSPI::writecommand(uint16_t c)
 {
+  // The command may change the window, so it must be resent by setWindow()
+  addr_row = 0xFFFF;
+  addr_col = 0xFFFF;
+
   begin_tft_write();
 
   DC_C;
 
   tft_Write_16(c);
+  BUS_STAT_CMD(1, 0);
 
   DC_D;
 
@@ -1059,6 +1129,7 @@ void TFT_eSPI::writeRegister8(uint16_t c, uint8_t d)
   DC_D;
 
   tft_Write_8(d);
+  BUS_STAT_CMD(1, 1);
 
   end_tft_write();
 
@@ -1074,6 +1145,7 @@ void TFT_eSPI::writeRegister16(uint16_t c, uint16_t d)
   DC_D;
 
   tft_Write_16(d);
+  BUS_STAT_CMD(1, 2);
 
   end_tft_write();
 
@@ -1092,6 +1164,7 @@ void TFT_eSPI::writedata(uint8_t d)
   DC_D;        // Play safe, but should already be in data mode
 
   tft_Write_8(d);
+  BUS_STAT_CMD(0, 1);
 
   CS_L;        // Allow more hold time for low VDI rail
 
@@ -1188,6 +1261,8 @@ uint16_t TFT_eSPI::readPixel(int32_t x0, int32_t y0)
   // Range checking
   if ((x0 < _vpX) || (y0 < _vpY) ||(x0 >= _vpW) || (y0 >= _vpH)) return 0;
 
+  BUS_STAT_SCOPE(STAT_READ_PIXEL);
+
 #if defined(TFT_PARALLEL_8_BIT) || defined(RP2040_PIO_INTERFACE)
 
   if (!inTransaction) { CS_L; } // CS_L can be multi-statement
@@ -1319,6 +1394,8 @@ void TFT_eSPI::readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *da
 {
   PI_CLIP ;
 
+  BUS_STAT_SCOPE(STAT_READ_PIXEL);
+
 #if defined(TFT_PARALLEL_8_BIT) || defined(RP2040_PIO_INTERFACE)
 
   CS_L;
@@ -1492,8 +1569,14 @@ void TFT_eSPI::pushRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *da
 ***************************************************************************************/
 void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data)
 {
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord && dlImage(x, y, w, h, data, false)) return;
+#endif
+
   PI_CLIP;
 
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
   begin_tft_write();
   inTransaction = true;
 
@@ -1502,12 +1585,12 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *d
   data += dx + dy * w;
 
   // Check if whole image can be pushed
-  if (dw == w) pushPixels(data, dw * dh);
+  if (dw == w) { pushPixels(data, dw * dh); BUS_STAT_PIXELS(dw * dh); }
   else {
     // Push line segments to crop image
     while (dh--)
     {
-      pushPixels(data, dw);
+      pushPixels(data, dw); BUS_STAT_PIXELS(dw);
       data += w;
     }
   }
@@ -1516,6 +1599,77 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *d
   end_tft_write();
 }
 
+/***************************************************************************************
+** Function name:           spanLength
+** Description:             length of an opaque or transparent run of 16-bit pixels
+***************************************************************************************/
+// Returns the number of pixels from p (up to len) that differ from the key colour when
+// opaque is true, or match it when opaque is false. Aligned pixel pairs are tested with
+// one 32-bit compare, single pixels use pgm_read_word() so FLASH images can be scanned
+static int32_t spanLength(const uint16_t *p, int32_t len, uint16_t key, bool opaque)
+{
+  int32_t n = 0;
+
+  // Test a leading pixel on its own to get 32-bit alignment
+  if (((uintptr_t)p & 2) && len) {
+    if ((pgm_read_word(p) != key) != opaque) return 0;
+    n = 1;
+  }
+
+  const uint32_t *wp = (const uint32_t *)(p + n);
+  uint32_t key2 = (uint32_t)key * 0x00010001;
+
+  if (opaque) {
+    // Stop at a pair where either half matches the key (a zero half after the XOR)
+    while (n + 2 <= len) {
+      uint32_t diff = *wp ^ key2;
+      if ((diff - 0x00010001) & ~diff & 0x80008000) break;
+      wp++; n += 2;
+    }
+  }
+  else {
+    while ((n + 2 <= len) && (*wp == key2)) { wp++; n += 2; }
+  }
+
+  // Finish the run a pixel at a time
+  while ((n < len) && ((pgm_read_word(p + n) != key) == opaque)) n++;
+
+  return n;
+}
+
+/***************************************************************************************
+** Function name:           buildSpans
+** Description:             build the opaque span list of a 16-bit image
+***************************************************************************************/
+// The key must be in the same byte order as the image data. Each line is stored as the
+// number of spans followed by an x offset and length pair for each span. Returns the
+// number of 16-bit words the list needs, the list is only written if size is large enough
+static uint32_t buildSpans(const uint16_t *data, int32_t w, int32_t h, uint16_t key, uint16_t *spans, uint32_t size)
+{
+  uint32_t used = 0;
+
+  for (int32_t j = 0; j < h; j++) {
+    uint32_t count = used++;
+    uint16_t n = 0;
+    int32_t  px = 0;
+
+    while (px < w) {
+      px += spanLength(data + px, w - px, key, false);
+      if (px >= w) break;
+      int32_t np = spanLength(data + px, w - px, key, true);
+      if (spans && used + 2 <= size) { spans[used] = px; spans[used + 1] = np; }
+      used += 2;
+      px += np;
+      n++;
+    }
+
+    if (spans && count < size) spans[count] = n;
+    data += w;
+  }
+
+  return used;
+}
+
 /***************************************************************************************
 ** Function name:           pushImage
 ** Description:             plot 16-bit sprite or image with 1 colour being transparent
@@ -1524,47 +1678,30 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *d
 {
   PI_CLIP;
 
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
   begin_tft_write();
   inTransaction = true;
 
   data += dx + dy * w;
 
-
-  uint16_t  lineBuf[dw]; // Use buffer to minimise setWindow call count
-
   // The little endian transp color must be byte swapped if the image is big endian
   if (!_swapBytes) transp = transp >> 8 | transp << 8;
 
+  // Opaque runs are found a pixel pair at a time and sent straight from the image
   while (dh--)
   {
-    int32_t len = dw;
-    uint16_t* ptr = data;
-    int32_t px = x, sx = x;
-    bool move = true;
-    uint16_t np = 0;
+    int32_t px = 0;
 
-    while (len--)
+    while (px < dw)
     {
-      if (transp != *ptr)
-      {
-        if (move) { move = false; sx = px; }
-        lineBuf[np] = *ptr;
-        np++;
-      }
-      else
-      {
-        move = true;
-        if (np)
-        {
-          setWindow(sx, y, sx + np - 1, y);
-          pushPixels((uint16_t*)lineBuf, np);
-          np = 0;
-        }
-      }
-      px++;
-      ptr++;
+      px += spanLength(data + px, dw - px, transp, false);
+      if (px >= dw) break;
+      int32_t np = spanLength(data + px, dw - px, transp, true);
+      setWindow(x + px, y, x + px + np - 1, y);
+      pushPixels(data + px, np); BUS_STAT_PIXELS(np);
+      px += np;
     }
-    if (np) { setWindow(sx, y, sx + np - 1, y); pushPixels((uint16_t*)lineBuf, np); }
 
     y++;
     data += w;
@@ -1581,9 +1718,15 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *d
 ***************************************************************************************/
 void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data)
 {
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord && dlImage(x, y, w, h, data, true)) return;
+#endif
+
   // Requires 32-bit aligned access, so use PROGMEM 16-bit word functions
   PI_CLIP;
 
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
   begin_tft_write();
   inTransaction = true;
 
@@ -1598,7 +1741,7 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint1
     for (int32_t j = 0; j < dw; j++) {
       buffer[j] = pgm_read_word(&data[i * w + j]);
     }
-    pushPixels(buffer, dw);
+    pushPixels(buffer, dw); BUS_STAT_PIXELS(dw);
   }
 
   inTransaction = lockTransaction;
@@ -1614,6 +1757,8 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint1
   // Requires 32-bit aligned access, so use PROGMEM 16-bit word functions
   PI_CLIP;
 
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
   begin_tft_write();
   inTransaction = true;
 
@@ -1626,32 +1771,17 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint1
   if (!_swapBytes) transp = transp >> 8 | transp << 8;
 
   while (dh--) {
-    int32_t len = dw;
-    uint16_t* ptr = (uint16_t*)data;
-    int32_t px = x, sx = x;
-    bool move = true;
-
-    uint16_t np = 0;
-
-    while (len--) {
-      uint16_t color = pgm_read_word(ptr);
-      if (transp != color) {
-        if (move) { move = false; sx = px; }
-        lineBuf[np] = color;
-        np++;
-      }
-      else {
-        move = true;
-        if (np) {
-          setWindow(sx, y, sx + np - 1, y);
-          pushPixels(lineBuf, np);
-          np = 0;
-        }
-      }
-      px++;
-      ptr++;
+    int32_t px = 0;
+
+    while (px < dw) {
+      px += spanLength(data + px, dw - px, transp, false);
+      if (px >= dw) break;
+      int32_t np = spanLength(data + px, dw - px, transp, true);
+      for (int32_t i = 0; i < np; i++) lineBuf[i] = pgm_read_word(data + px + i);
+      setWindow(x + px, y, x + px + np - 1, y);
+      pushPixels(lineBuf, np); BUS_STAT_PIXELS(np);
+      px += np;
     }
-    if (np) { setWindow(sx, y, sx + np - 1, y); pushPixels(lineBuf, np); }
 
     y++;
     data += w;
@@ -1662,146 +1792,279 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint1
 }
 
 /***************************************************************************************
-** Function name:           pushImage
-** Description:             plot 8-bit or 4-bit or 1 bit image or sprite using a line buffer
+** Function name:           createSpanList
+** Description:             build the opaque span list of a 16-bit image
 ***************************************************************************************/
-void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *data, bool bpp8,  uint16_t *cmap)
+// Returns the number of 16-bit words needed, the list is only written if size is enough
+uint32_t TFT_eSPI::createSpanList(int32_t w, int32_t h, const uint16_t *data, uint16_t transp, uint16_t *spans, uint32_t size)
+{
+  if ((w < 1) || (h < 1) || (w > 0xFFFF) || !data) return 0;
+
+  // The little endian transp color must be byte swapped if the image is big endian
+  if (!_swapBytes) transp = transp >> 8 | transp << 8;
+
+  return buildSpans(data, w, h, transp, spans, size);
+}
+
+/***************************************************************************************
+** Function name:           pushImageSpans
+** Description:             plot 16-bit image using a list of the opaque spans
+***************************************************************************************/
+void TFT_eSPI::pushImageSpans(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data, const uint16_t *spans)
 {
+  if (!spans) return;
+
   PI_CLIP;
 
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
   begin_tft_write();
   inTransaction = true;
-  bool swap = _swapBytes;
 
-  setWindow(x, y, x + dw - 1, y + dh - 1); // Sets CS low and sent RAMWR
+  // Skip the span lists of lines clipped at the top
+  for (int32_t j = 0; j < dy; j++) spans += 1 + 2 * spans[0];
 
-  // Line buffer makes plotting faster
-  uint16_t  lineBuf[dw];
+  data += dy * w;
+  x -= dx;
 
-  if (bpp8)
+#if defined (ESP8266)
+  uint16_t  lineBuf[dw]; // Image may be in FLASH, which needs 32-bit aligned access
+#endif
+
+  int32_t xe = dx + dw; // Clip limit in image coordinates
+
+  while (dh--)
   {
-    _swapBytes = false;
+    uint16_t n = *spans++;
 
-    uint8_t  blue[] = {0, 11, 21, 31}; // blue 2 to 5-bit colour lookup table
+    while (n--)
+    {
+      int32_t xs = *spans++;
+      int32_t xf = xs + *spans++;
+      if (xs < dx) xs = dx;
+      if (xf > xe) xf = xe;
+      if (xs >= xf) continue;
+
+      int32_t np = xf - xs;
+      setWindow(x + xs, y, x + xf - 1, y);
+#if defined (ESP8266)
+      for (int32_t i = 0; i < np; i++) lineBuf[i] = pgm_read_word(data + xs + i);
+      pushPixels(lineBuf, np);
+#else
+      pushPixels(data + xs, np);
+#endif
+      BUS_STAT_PIXELS(np);
+    }
 
-    _lastColor = -1; // Set to illegal value
+    y++;
+    data += w;
+  }
 
-    // Used to store last shifted colour
-    uint8_t msbColor = 0;
-    uint8_t lsbColor = 0;
+  inTransaction = lockTransaction;
+  end_tft_write();
+}
 
-    data += dx + dy * w;
-    while (dh--) {
-      uint32_t len = dw;
-      uint8_t* ptr = (uint8_t*)data;
-      uint8_t* linePtr = (uint8_t*)lineBuf;
-
-      while(len--) {
-        uint32_t color = pgm_read_byte(ptr++);
-
-        // Shifts are slow so check if colour has changed first
-        if (color != _lastColor) {
-          //          =====Green=====     ===============Red==============
-          msbColor = (color & 0x1C)>>2 | (color & 0xC0)>>3 | (color & 0xE0);
-          //          =====Green=====    =======Blue======
-          lsbColor = (color & 0x1C)<<3 | blue[color & 0x03];
-          _lastColor = color;
-        }
+/***************************************************************************************
+** Function name:           blend565x4 - helper function for bilinear sampling
+** Description:             blend 4 neighbouring 565 colours, fx and fy are 0-31
+***************************************************************************************/
+// The 565 colours are blended in packed form as 0b00000gggggg00000rrrrr000000bbbbb, with
+// 5 bit weights none of the fields can overflow into the next. Each blend adds a half in
+// every field before the shift so the result is rounded. Colours are in processor order
+static inline uint16_t blend565x4(uint16_t c00, uint16_t c10, uint16_t c01, uint16_t c11, uint32_t fx, uint32_t fy)
+{
+  uint32_t p00 = (c00 | (uint32_t)c00 << 16) & 0x07E0F81F;
+  uint32_t p10 = (c10 | (uint32_t)c10 << 16) & 0x07E0F81F;
+  uint32_t p01 = (c01 | (uint32_t)c01 << 16) & 0x07E0F81F;
+  uint32_t p11 = (c11 | (uint32_t)c11 << 16) & 0x07E0F81F;
 
-       *linePtr++ = msbColor;
-       *linePtr++ = lsbColor;
-      }
+  uint32_t top = ((p00 * (32 - fx) + p10 * fx + 0x02008010) >> 5) & 0x07E0F81F;
+  uint32_t bot = ((p01 * (32 - fx) + p11 * fx + 0x02008010) >> 5) & 0x07E0F81F;
+  uint32_t mix = ((top * (32 - fy) + bot * fy + 0x02008010) >> 5) & 0x07E0F81F;
+  return mix | (mix >> 16);
+}
 
-      pushPixels(lineBuf, dw);
 
-      data += w;
-    }
-    _swapBytes = swap; // Restore old value
-  }
-  else if (cmap != nullptr) // Must be 4bpp
-  {
-    _swapBytes = true;
+/***************************************************************************************
+** Function name:           scaleImageRow - helper function for pushImageScaled
+** Description:             make n pixels of destination row j of a scaled image
+***************************************************************************************/
+// The sw x sh image is scaled to dw x dh pixels, i is the first pixel. Pixels are
+// sampled at their centres, bilinear positions are 16.16 fixed point and are clamped at
+// the image edges. The row is made in processor byte order, swap is true if the image
+// is in TFT byte order
+static void scaleImageRow(uint16_t *out, const uint16_t *data, int32_t sw, int32_t sh, int32_t dw, int32_t dh,
+                          int32_t i, int32_t j, int32_t n, uint8_t mode, bool swap)
+{
+  if (mode == SCALE_BILINEAR) {
+    uint32_t du = ((uint32_t)sw << 16) / dw;
+    uint32_t dv = ((uint32_t)sh << 16) / dh;
 
-    w = (w+1) & 0xFFFE;   // if this is a sprite, w will already be even; this does no harm.
-    bool splitFirst = (dx & 0x01) != 0; // split first means we have to push a single px from the left of the sprite / image
+    // Weights are rounded to 1/32
+    int32_t v  = j * dv + (dv >> 1) - 0x8000 + 0x400;
+    if (v < 0x400) v = 0;
+    int32_t sy = v >> 16;
+    uint32_t fy = (v >> 11) & 0x1F;
+    if (sy >= sh - 1) { sy = sh - 1; fy = 0; }
+    const uint16_t *row0 = data + sy * sw;
+    const uint16_t *row1 = fy ? row0 + sw : row0;
 
-    if (splitFirst) {
-      data += ((dx - 1 + dy * w) >> 1);
+    int32_t u = i * du + (du >> 1) - 0x8000 + 0x400;
+    while (n--) {
+      int32_t  sx = u < 0x400 ? 0 : u >> 16;
+      uint32_t fx = u < 0x400 ? 0 : (u >> 11) & 0x1F;
+      int32_t  nx = (sx < sw - 1) ? 1 : 0;
+      if (!nx) fx = 0;
+
+      uint16_t c[4] = { pgm_read_word(row0 + sx), pgm_read_word(row0 + sx + nx),
+                        pgm_read_word(row1 + sx), pgm_read_word(row1 + sx + nx) };
+      if (swap) for (uint8_t k = 0; k < 4; k++) c[k] = (c[k] >> 8) | (c[k] << 8);
+      *out++ = blend565x4(c[0], c[1], c[2], c[3], fx, fy);
+      u += du;
     }
-    else {
-      data += ((dx + dy * w) >> 1);
+  }
+  else {
+    // The nearest pixel is found exactly, as (2i + 1) * sw / (2 * dw) in whole pixels and a
+    // remainder, so scaling by whole numbers repeats each pixel the same number of times
+    const uint16_t *row = data + ((2 * j + 1) * sh / (2 * dh)) * sw;
+    int32_t den = 2 * dw;
+    int32_t sx  = (2 * i + 1) * sw / den;
+    int32_t r   = (2 * i + 1) * sw % den;
+    int32_t dq  = 2 * sw / den;
+    int32_t dr  = 2 * sw % den;
+    while (n--) {
+      uint16_t color = pgm_read_word(row + sx);
+      *out++ = swap ? (color >> 8) | (color << 8) : color;
+      sx += dq;
+      r  += dr;
+      if (r >= den) { r -= den; sx++; }
     }
+  }
+}
 
-    while (dh--) {
-      uint32_t len = dw;
-      uint8_t * ptr = (uint8_t*)data;
-      uint16_t *linePtr = lineBuf;
-      uint8_t colors; // two colors in one byte
-      uint16_t index;
 
-      if (splitFirst) {
-        colors = pgm_read_byte(ptr);
-        index = (colors & 0x0F);
-        *linePtr++ = cmap[index];
-        len--;
-        ptr++;
-      }
+/***************************************************************************************
+** Function name:           pushImageScaled
+** Description:             plot a 16-bit image scaled to a new size
+***************************************************************************************/
+void TFT_eSPI::pushImageScaled(int32_t x, int32_t y, int32_t dw, int32_t dh, int32_t sw, int32_t sh,
+                               const uint16_t *data, uint8_t mode)
+{
+  if (_vpOoB || data == nullptr || dw < 1 || dh < 1 || sw < 1 || sh < 1) return;
 
-      while (len--)
-      {
-        colors = pgm_read_byte(ptr);
-        index = ((colors & 0xF0) >> 4) & 0x0F;
-        *linePtr++ = cmap[index];
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
 
-        if (len--)
-        {
-          index = colors & 0x0F;
-          *linePtr++ = cmap[index];
-        } else {
-          break;  // nothing to do here
-        }
+  x+= _xDatum;
+  y+= _yDatum;
 
-        ptr++;
-      }
+  // Clipping, i and j are the first destination pixel and row inside the viewport
+  int32_t i = 0, j = 0, w = dw, h = dh;
 
-      pushPixels(lineBuf, dw);
-      data += (w >> 1);
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { i = _vpX - x; w -= i; x = _vpX; }
+  if (y < _vpY) { j = _vpY - y; h -= j; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  uint16_t lineBuf[w];
+
+  // The rows are made in processor byte order
+  bool swap = _swapBytes; _swapBytes = true;
+
+  begin_tft_write();
+
+  setWindow(x, y, x + w - 1, y + h - 1);
+
+  for (int32_t row = 0; row < h; row++) {
+    scaleImageRow(lineBuf, data, sw, sh, dw, dh, i, j + row, w, mode, !swap);
+    pushPixels(lineBuf, w); BUS_STAT_PIXELS(w);
+  }
+
+  end_tft_write();
+
+  _swapBytes = swap;
+}
+
+
+/***************************************************************************************
+** Function name:           expand4bpp
+** Description:             expand a line of 4bpp pixels to 16-bit colours
+***************************************************************************************/
+// row points to the start of the image line, xp is the first pixel. If pair is not
+// nullptr it gives the two colours for each byte, so a byte needs only one lookup
+static void expand4bpp(uint16_t *line, const uint8_t *row, int32_t xp, int32_t len, const uint16_t *cmap, const uint32_t *pair)
+{
+  const uint8_t *ptr = row + (xp >> 1);
+
+  // Odd start pixel is in the low nibble
+  if ((xp & 1) && len) { *line++ = cmap[pgm_read_byte(ptr++) & 0x0F]; len--; }
+
+  if (pair) {
+    while (len >= 2) {
+      uint32_t colors = pair[pgm_read_byte(ptr++)];
+      line[0] = colors;
+      line[1] = colors >> 16;
+      line += 2;
+      len  -= 2;
     }
-    _swapBytes = swap; // Restore old value
   }
-  else // Must be 1bpp
-  {
-    _swapBytes = false;
-    uint8_t * ptr = (uint8_t*)data;
-    uint32_t ww =  (w+7)>>3; // Width of source image line in bytes
-    for (int32_t yp = dy;  yp < dy + dh; yp++)
-    {
-      uint8_t* linePtr = (uint8_t*)lineBuf;
-      for (int32_t xp = dx; xp < dx + dw; xp++)
-      {
-        uint16_t col = (pgm_read_byte(ptr + (xp>>3)) & (0x80 >> (xp & 0x7)) );
-        if (col) {*linePtr++ = bitmap_fg>>8; *linePtr++ = (uint8_t) bitmap_fg;}
-        else     {*linePtr++ = bitmap_bg>>8; *linePtr++ = (uint8_t) bitmap_bg;}
-      }
-      ptr += ww;
-      pushPixels(lineBuf, dw);
+  else {
+    while (len >= 2) {
+      uint8_t colors = pgm_read_byte(ptr++); // two colors in one byte
+      line[0] = cmap[colors >> 4];
+      line[1] = cmap[colors & 0x0F];
+      line += 2;
+      len  -= 2;
     }
   }
 
-  _swapBytes = swap; // Restore old value
-  inTransaction = lockTransaction;
-  end_tft_write();
+  if (len) *line = cmap[pgm_read_byte(ptr) >> 4];
 }
 
+/***************************************************************************************
+** Function name:           expand1bpp
+** Description:             expand a line of 1bpp pixels to 16-bit colours
+***************************************************************************************/
+// quad gives the four colours for each nibble, a whole byte is copied as 8 pixels
+static void expand1bpp(uint16_t *line, const uint8_t *row, int32_t xp, int32_t len, const uint16_t (*quad)[4])
+{
+  uint16_t fg = quad[15][0];
+  uint16_t bg = quad[0][0];
+
+  // Single pixels up to a byte boundary
+  while ((xp & 7) && len) {
+    *line++ = (pgm_read_byte(row + (xp >> 3)) & (0x80 >> (xp & 7))) ? fg : bg;
+    xp++;
+    len--;
+  }
+
+  const uint8_t *ptr = row + (xp >> 3);
+  while (len >= 8) {
+    uint8_t bits = pgm_read_byte(ptr++);
+    memcpy(line,     quad[bits >> 4],   8);
+    memcpy(line + 4, quad[bits & 0x0F], 8);
+    line += 8;
+    len  -= 8;
+  }
+
+  uint8_t bits = len ? pgm_read_byte(ptr) : 0;
+  for (int32_t i = 0; i < len; i++) *line++ = (bits & (0x80 >> i)) ? fg : bg;
+}
 
 /***************************************************************************************
 ** Function name:           pushImage
 ** Description:             plot 8-bit or 4-bit or 1 bit image or sprite using a line buffer
 ***************************************************************************************/
-void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *data, bool bpp8,  uint16_t *cmap)
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *data, bool bpp8,  uint16_t *cmap)
 {
   PI_CLIP;
 
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
   begin_tft_write();
   inTransaction = true;
   bool swap = _swapBytes;
@@ -1815,37 +2078,21 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
   {
     _swapBytes = false;
 
-    uint8_t  blue[] = {0, 11, 21, 31}; // blue 2 to 5-bit colour lookup table
-
-    _lastColor = -1; // Set to illegal value
-
-    // Used to store last shifted colour
-    uint8_t msbColor = 0;
-    uint8_t lsbColor = 0;
+  #if defined (ESP8266)
+    uint8_t  byteBuf[dw]; // Image may be in FLASH, which needs 32-bit aligned access
+  #endif
 
     data += dx + dy * w;
     while (dh--) {
-      uint32_t len = dw;
-      uint8_t* ptr = data;
-      uint8_t* linePtr = (uint8_t*)lineBuf;
-
-      while(len--) {
-        uint32_t color = *ptr++;
-
-        // Shifts are slow so check if colour has changed first
-        if (color != _lastColor) {
-          //          =====Green=====     ===============Red==============
-          msbColor = (color & 0x1C)>>2 | (color & 0xC0)>>3 | (color & 0xE0);
-          //          =====Green=====    =======Blue======
-          lsbColor = (color & 0x1C)<<3 | blue[color & 0x03];
-          _lastColor = color;
-        }
-
-       *linePtr++ = msbColor;
-       *linePtr++ = lsbColor;
-      }
+      // Convert the line to 16 bits in TFT byte order
+  #if defined (ESP8266)
+      for (int32_t i = 0; i < dw; i++) byteBuf[i] = pgm_read_byte(data + i);
+      color8to16(byteBuf, lineBuf, dw, true);
+  #else
+      color8to16(data, lineBuf, dw, true);
+  #endif
 
-      pushPixels(lineBuf, dw);
+      pushPixels(lineBuf, dw); BUS_STAT_PIXELS(dw);
 
       data += w;
     }
@@ -1856,68 +2103,42 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
     _swapBytes = true;
 
     w = (w+1) & 0xFFFE;   // if this is a sprite, w will already be even; this does no harm.
-    bool splitFirst = (dx & 0x01) != 0; // split first means we have to push a single px from the left of the sprite / image
 
-    if (splitFirst) {
-      data += ((dx - 1 + dy * w) >> 1);
-    }
-    else {
-      data += ((dx + dy * w) >> 1);
+    // For larger images a table of the colour pair for each byte is quicker
+    const uint32_t *pair = nullptr;
+  #if !defined (ESP8266) // Limited stack
+    uint32_t pairTable[(dw * dh >= 1024) ? 256 : 1];
+    if (dw * dh >= 1024) {
+      for (uint32_t i = 0; i < 256; i++) pairTable[i] = cmap[i >> 4] | (uint32_t)cmap[i & 0x0F] << 16;
+      pair = pairTable;
     }
+  #endif
 
+    data += dy * (w >> 1);
     while (dh--) {
-      uint32_t len = dw;
-      uint8_t * ptr = data;
-      uint16_t *linePtr = lineBuf;
-      uint8_t colors; // two colors in one byte
-      uint16_t index;
-
-      if (splitFirst) {
-        colors = *ptr;
-        index = (colors & 0x0F);
-        *linePtr++ = cmap[index];
-        len--;
-        ptr++;
-      }
-
-      while (len--)
-      {
-        colors = *ptr;
-        index = ((colors & 0xF0) >> 4) & 0x0F;
-        *linePtr++ = cmap[index];
-
-        if (len--)
-        {
-          index = colors & 0x0F;
-          *linePtr++ = cmap[index];
-        } else {
-          break;  // nothing to do here
-        }
-
-        ptr++;
-      }
-
-      pushPixels(lineBuf, dw);
+      expand4bpp(lineBuf, data, dx, dw, cmap, pair);
+      pushPixels(lineBuf, dw); BUS_STAT_PIXELS(dw);
       data += (w >> 1);
     }
-    _swapBytes = swap; // Restore old value
   }
   else // Must be 1bpp
   {
     _swapBytes = false;
 
+    // Colours in TFT byte order for each 4 bit pattern
+    uint16_t fg = (uint16_t)bitmap_fg >> 8 | (uint16_t)(bitmap_fg << 8);
+    uint16_t bg = (uint16_t)bitmap_bg >> 8 | (uint16_t)(bitmap_bg << 8);
+    uint16_t quad[16][4];
+    for (uint32_t n = 0; n < 16; n++) {
+      for (uint32_t i = 0; i < 4; i++) quad[n][i] = (n & (0x08 >> i)) ? fg : bg;
+    }
+
     uint32_t ww =  (w+7)>>3; // Width of source image line in bytes
-    for (int32_t yp = dy;  yp < dy + dh; yp++)
-    {
-      uint8_t* linePtr = (uint8_t*)lineBuf;
-      for (int32_t xp = dx; xp < dx + dw; xp++)
-      {
-        uint16_t col = (data[(xp>>3)] & (0x80 >> (xp & 0x7)) );
-        if (col) {*linePtr++ = bitmap_fg>>8; *linePtr++ = (uint8_t) bitmap_fg;}
-        else     {*linePtr++ = bitmap_bg>>8; *linePtr++ = (uint8_t) bitmap_bg;}
-      }
+    data += dy * ww;
+    while (dh--) {
+      expand1bpp(lineBuf, data, dx, dw, quad);
+      pushPixels(lineBuf, dw); BUS_STAT_PIXELS(dw);
       data += ww;
-      pushPixels(lineBuf, dw);
     }
   }
 
@@ -1929,73 +2150,125 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
 
 /***************************************************************************************
 ** Function name:           pushImage
-** Description:             plot 8 or 4 or 1 bit image or sprite with a transparent colour
+** Description:             plot 8-bit or 4-bit or 1 bit image or sprite using a line buffer
 ***************************************************************************************/
-void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *data, uint8_t transp, bool bpp8, uint16_t *cmap)
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *data, bool bpp8,  uint16_t *cmap)
 {
   PI_CLIP;
 
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
   begin_tft_write();
   inTransaction = true;
   bool swap = _swapBytes;
 
+  setWindow(x, y, x + dw - 1, y + dh - 1); // Sets CS low and sent RAMWR
 
   // Line buffer makes plotting faster
   uint16_t  lineBuf[dw];
 
-  if (bpp8) { // 8 bits per pixel
-    _swapBytes = false;
+  if (bpp8)
+  {
+    _swapBytes = false;
 
     data += dx + dy * w;
+    while (dh--) {
+      // Convert the line to 16 bits in TFT byte order
+      color8to16(data, lineBuf, dw, true);
 
-    uint8_t  blue[] = {0, 11, 21, 31}; // blue 2 to 5-bit colour lookup table
+      pushPixels(lineBuf, dw); BUS_STAT_PIXELS(dw);
+
+      data += w;
+    }
+    _swapBytes = swap; // Restore old value
+  }
+  else if (cmap != nullptr) // Must be 4bpp
+  {
+    _swapBytes = true;
 
-    _lastColor = -1; // Set to illegal value
+    w = (w+1) & 0xFFFE;   // if this is a sprite, w will already be even; this does no harm.
 
-    // Used to store last shifted colour
-    uint8_t msbColor = 0;
-    uint8_t lsbColor = 0;
+    // For larger images a table of the colour pair for each byte is quicker
+    const uint32_t *pair = nullptr;
+  #if !defined (ESP8266) // Limited stack
+    uint32_t pairTable[(dw * dh >= 1024) ? 256 : 1];
+    if (dw * dh >= 1024) {
+      for (uint32_t i = 0; i < 256; i++) pairTable[i] = cmap[i >> 4] | (uint32_t)cmap[i & 0x0F] << 16;
+      pair = pairTable;
+    }
+  #endif
 
+    data += dy * (w >> 1);
     while (dh--) {
-      int32_t len = dw;
-      uint8_t* ptr = data;
-      uint8_t* linePtr = (uint8_t*)lineBuf;
+      expand4bpp(lineBuf, data, dx, dw, cmap, pair);
+      pushPixels(lineBuf, dw); BUS_STAT_PIXELS(dw);
+      data += (w >> 1);
+    }
+  }
+  else // Must be 1bpp
+  {
+    _swapBytes = false;
 
-      int32_t px = x, sx = x;
-      bool move = true;
-      uint16_t np = 0;
+    // Colours in TFT byte order for each 4 bit pattern
+    uint16_t fg = (uint16_t)bitmap_fg >> 8 | (uint16_t)(bitmap_fg << 8);
+    uint16_t bg = (uint16_t)bitmap_bg >> 8 | (uint16_t)(bitmap_bg << 8);
+    uint16_t quad[16][4];
+    for (uint32_t n = 0; n < 16; n++) {
+      for (uint32_t i = 0; i < 4; i++) quad[n][i] = (n & (0x08 >> i)) ? fg : bg;
+    }
 
-      while (len--) {
-        if (transp != *ptr) {
-          if (move) { move = false; sx = px; }
-          uint8_t color = *ptr;
-
-          // Shifts are slow so check if colour has changed first
-          if (color != _lastColor) {
-            //          =====Green=====     ===============Red==============
-            msbColor = (color & 0x1C)>>2 | (color & 0xC0)>>3 | (color & 0xE0);
-            //          =====Green=====    =======Blue======
-            lsbColor = (color & 0x1C)<<3 | blue[color & 0x03];
-            _lastColor = color;
-          }
-          *linePtr++ = msbColor;
-          *linePtr++ = lsbColor;
-          np++;
-        }
-        else {
-          move = true;
-          if (np) {
-            setWindow(sx, y, sx + np - 1, y);
-            pushPixels(lineBuf, np);
-            linePtr = (uint8_t*)lineBuf;
-            np = 0;
-          }
+    uint32_t ww =  (w+7)>>3; // Width of source image line in bytes
+    data += dy * ww;
+    while (dh--) {
+      expand1bpp(lineBuf, data, dx, dw, quad);
+      pushPixels(lineBuf, dw); BUS_STAT_PIXELS(dw);
+      data += ww;
+    }
+  }
+
+  _swapBytes = swap; // Restore old value
+  inTransaction = lockTransaction;
+  end_tft_write();
+}
+
+
+/***************************************************************************************
+** Function name:           pushImage
+** Description:             plot 8 or 4 or 1 bit image or sprite with a transparent colour
+***************************************************************************************/
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *data, uint8_t transp, bool bpp8, uint16_t *cmap)
+{
+  PI_CLIP;
+
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
+  begin_tft_write();
+  inTransaction = true;
+  bool swap = _swapBytes;
+
+
+  // Line buffer makes plotting faster
+  uint16_t  lineBuf[dw];
+
+  if (bpp8) { // 8 bits per pixel
+    _swapBytes = false;
+
+    data += dx + dy * w;
+
+    while (dh--) {
+      int32_t px = 0;
+      while (px < dw) {
+        // Skip the transparent pixels then convert the run of opaque pixels in TFT byte order
+        while (px < dw && data[px] == transp) px++;
+        int32_t sx = px;
+        while (px < dw && data[px] != transp) px++;
+        int32_t np = px - sx;
+        if (np) {
+          color8to16(data + sx, lineBuf, np, true);
+          setWindow(x + sx, y, x + px - 1, y);
+          pushPixels(lineBuf, np); BUS_STAT_PIXELS(np);
         }
-        px++;
-        ptr++;
       }
-
-      if (np) { setWindow(sx, y, sx + np - 1, y); pushPixels(lineBuf, np); }
       y++;
       data += w;
     }
@@ -2052,7 +2325,7 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
           move = true;
           if (np) {
             setWindow(sx, y, sx + np - 1, y);
-            pushPixels(lineBuf, np);
+            pushPixels(lineBuf, np); BUS_STAT_PIXELS(np);
             np = 0;
           }
         }
@@ -2072,7 +2345,7 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
             move = true;
             if (np) {
               setWindow(sx, y, sx + np - 1, y);
-              pushPixels(lineBuf, np);
+              pushPixels(lineBuf, np); BUS_STAT_PIXELS(np);
               np = 0;
             }
           }
@@ -2086,7 +2359,7 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
 
       if (np) {
         setWindow(sx, y, sx + np - 1, y);
-        pushPixels(lineBuf, np);
+        pushPixels(lineBuf, np); BUS_STAT_PIXELS(np);
         np = 0;
       }
       data += (w>>1);
@@ -2116,13 +2389,13 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
           move = true;
           if (np) {
             setWindow(sx, y, sx + np - 1, y);
-            pushBlock(bitmap_fg, np);
+            pushBlock(bitmap_fg, np); BUS_STAT_BLOCK(np);
             np = 0;
           }
         }
         px++;
       }
-      if (np) { setWindow(sx, y, sx + np - 1, y); pushBlock(bitmap_fg, np); np = 0; }
+      if (np) { setWindow(sx, y, sx + np - 1, y); pushBlock(bitmap_fg, np); BUS_STAT_BLOCK(np); np = 0; }
       y++;
       data += ww;
     }
@@ -2141,6 +2414,8 @@ void TFT_eSPI::pushMaskedImage(int32_t x, int32_t y, int32_t w, int32_t h, uint1
 {
   if (_vpOoB || w < 1 || h < 1) return;
 
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
   // To simplify mask handling the window clipping is done by the pushImage function
   // Each mask image line assumed to be padded to an integer number of bytes & padding bits are 0
 
@@ -2218,6 +2493,61 @@ void TFT_eSPI::pushMaskedImage(int32_t x, int32_t y, int32_t w, int32_t h, uint1
 }
 
 
+/***************************************************************************************
+** Function name:           pushAlphaImage
+** Description:             Render a 16-bit colour image to TFT with an 8-bit alpha mask
+***************************************************************************************/
+// The alpha mask has one byte per image pixel. If bg_color is 0x00FFFFFF the image is
+// blended with the pixels already on the TFT, this needs a TFT that can be read
+void TFT_eSPI::pushAlphaImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *img, const uint8_t *alpha, uint32_t bg_color)
+{
+  PI_CLIP;
+
+  BUS_STAT_SCOPE(STAT_PUSH_IMAGE);
+
+  // readRect() manages its own transaction so only hold one open for a fixed background
+  bool readBg = (bg_color == 0x00FFFFFF);
+  if (!readBg) {
+    begin_tft_write();
+    inTransaction = true;
+  }
+
+  img   += dx + dy * w;
+  alpha += dx + dy * w;
+
+  // The line buffer holds colours in the same byte order as the image
+  uint16_t lineBuf[dw];
+  uint16_t bg = bg_color;
+  if (!_swapBytes) bg = bg >> 8 | bg << 8;
+
+  while (dh--)
+  {
+    if (readBg) {
+      // readRect() returns colours in TFT byte order
+      readRect(x - _xDatum, y - _yDatum, dw, 1, lineBuf);
+      if (_swapBytes) for (int32_t i = 0; i < dw; i++) lineBuf[i] = lineBuf[i] >> 8 | lineBuf[i] << 8;
+    }
+    else for (int32_t i = 0; i < dw; i++) lineBuf[i] = bg;
+
+    blendSpan(lineBuf, img, alpha, dw, !_swapBytes);
+
+    begin_tft_write();
+    setWindow(x, y, x + dw - 1, y);
+    pushPixels(lineBuf, dw); BUS_STAT_PIXELS(dw);
+    end_tft_write();
+
+    y++;
+    img   += w;
+    alpha += w;
+  }
+
+  if (!readBg) {
+    inTransaction = lockTransaction;
+    end_tft_write();
+  }
+}
+
+
 /***************************************************************************************
 ** Function name:           setSwapBytes
 ** Description:             Used by 16-bit pushImage() to swap byte order in colours
@@ -2627,6 +2957,8 @@ void TFT_eSPI::fillEllipse(int16_t x0, int16_t y0, int32_t rx, int32_t ry, uint1
 ***************************************************************************************/
 void TFT_eSPI::fillScreen(uint32_t color)
 {
+  BUS_STAT_SCOPE(STAT_FILL_RECT);
+
   fillRect(0, 0, _width, _height, color);
 }
 
@@ -2801,185 +3133,709 @@ void TFT_eSPI::fillTriangle ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, in
 
 
 /***************************************************************************************
-** Function name:           drawBitmap
-** Description:             Draw an image stored in an array on the TFT
+** Function name:           setEdge - helper function for polygon filling
+** Description:             set up an edge from xa,ya to xb,yb, false if it is horizontal
 ***************************************************************************************/
-void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+static bool setEdge(tftPolyEdge_t *e, int32_t xa, int32_t ya, int32_t xb, int32_t yb)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
+  if (ya == yb) return false; // Horizontal edges do not affect the filled area
 
-  int32_t i, j, byteWidth = (w + 7) / 8;
+  e->dir   = 1;
+  e->flags = 0;
+  if (ya > yb) { transpose(xa, xb); transpose(ya, yb); e->dir = -1; }
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (128 >> (i & 7))) {
-        drawPixel(x + i, y + j, color);
-      }
-    }
-  }
+  e->x0 = xa; e->y0 = ya;
+  e->x1 = xb; e->y1 = yb;
 
-  inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  // Slope is limited for nearly horizontal edges, edgeX() then returns the end x values
+  int64_t dxdy = (int64_t)(xb - xa) * 65536 / (yb - ya);
+  if (dxdy >  0x7FFFFFFF) dxdy =  0x7FFFFFFF;
+  if (dxdy < -0x7FFFFFFF) dxdy = -0x7FFFFFFF;
+  e->dxdy = dxdy;
+
+  return true;
 }
 
+/***************************************************************************************
+** Function name:           edgeX - helper function for polygon filling
+** Description:             return the x position of an edge at y
+***************************************************************************************/
+static inline int32_t edgeX(const tftPolyEdge_t *e, int32_t y)
+{
+  if (y <= e->y0) return e->x0;
+  if (y >= e->y1) return e->x1;
+  return e->x0 + (int32_t)(((int64_t)(y - e->y0) * e->dxdy) >> 16);
+}
 
 /***************************************************************************************
-** Function name:           drawBitmap
-** Description:             Draw an image stored in an array on the TFT
+** Function name:           accumulateEdge - helper function for polygon filling
+** Description:             add the area to the left of a line to a pixel line accumulator
 ***************************************************************************************/
-void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor)
+// The line runs from xa,ya to xb,yb within one pixel line, y is 0-256 from the top of the
+// line and x is in 1/256 pixel units from the first pixel in the accumulator. Each pixel
+// the line passes through gets the area to the right of the line, the next pixel gets the
+// rest of the line height. The running sum of the accumulator is then the covered area of
+// each pixel in 1/65536 units, the sign depends on the direction of the line.
+static void accumulateEdge(int32_t *acc, int32_t w, int32_t xa, int32_t ya, int32_t xb, int32_t yb)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
+  // Walk from left to right, the sign of the area keeps the direction of the line
+  int32_t sgn = 1;
+  if (xa > xb) { transpose(xa, xb); transpose(ya, yb); sgn = -1; }
 
-  int32_t i, j, byteWidth = (w + 7) / 8;
+  int32_t dx = xb - xa, dy = yb - ya;
+  int32_t lx = xa, ly = ya;  // Reference point for y positions along the line
+  int32_t xw = w << 8;       // Right hand end of the accumulator
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (128 >> (i & 7)))
-           drawPixel(x + i, y + j, fgcolor);
-      else drawPixel(x + i, y + j, bgcolor);
-    }
+  // The part of the line left of the first pixel covers all of the pixels
+  if (xa < 0) {
+    int32_t ym = (xb <= 0) ? yb : ly + (int32_t)((int64_t)(0 - lx) * dy / dx);
+    acc[0] += sgn * (ym - ya) * 256;
+    if (xb <= 0) return;
+    xa = 0; ya = ym;
   }
 
-  inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  // The part of the line right of the last pixel does not affect the pixels
+  if (xa >= xw) return;
+  if (xb > xw) {
+    yb = ly + (int32_t)((int64_t)(xw - lx) * dy / dx);
+    xb = xw;
+  }
+
+  // Split the line at each pixel boundary it crosses
+  int32_t px = xa >> 8;
+  while (true) {
+    int32_t xn = (px + 1) << 8;
+    int32_t yn = yb;
+    if (xn < xb) yn = ly + (int32_t)((int64_t)(xn - lx) * dy / dx);
+    else xn = xb;
+
+    int32_t d = sgn * (yn - ya);
+    int32_t m = ((xa + xn) >> 1) - (px << 8); // Mean x position of the line in the pixel
+    acc[px]     += d * (256 - m);
+    acc[px + 1] += d * m;
+
+    if (xn >= xb) break;
+    xa = xn; ya = yn; px++;
+  }
 }
 
 /***************************************************************************************
-** Function name:           drawXBitmap
-** Description:             Draw an image stored in an XBM array onto the TFT
+** Function name:           fillEdges (private function)
+** Description:             fill the area inside a list of edges using the non-zero rule
 ***************************************************************************************/
-void TFT_eSPI::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+// Edges are sorted by their top end and added to an active edge list as the pixel lines
+// reach them, the edge list itself is not changed. The sorted and active lists are held in
+// the caller's work space so nothing on the stack depends on the number of edges.
+// Anti-aliased (smooth) filling finds the exact area of each pixel inside the edges,
+// otherwise a pixel is filled if the pixel centre is inside. Spans of fully covered
+// pixels are drawn with drawFastHLine() and only the edge pixels are blended.
+void TFT_eSPI::fillEdges(const tftPolyEdge_t *edge, uint32_t count, tftPolyWork_t *work, uint32_t color, uint32_t bg_color, bool smooth)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
+  if (_vpOoB || count < 2 || count > 0xFFFF || work == nullptr) return;
+
+  // Sort the edges by top end, insertion sort suits short and part sorted lists
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t j = i;
+    while (j && (edge[work[j - 1].order].y0 > edge[i].y0)) { work[j].order = work[j - 1].order; j--; }
+    work[j].order = i;
+  }
+
+  // Find the pixels that could be touched
+  int32_t xmin = edge[0].x0, xmax = xmin, ymax = edge[0].y1;
+  for (uint32_t i = 0; i < count; i++) {
+    if (edge[i].x0 < xmin) xmin = edge[i].x0;
+    if (edge[i].x1 < xmin) xmin = edge[i].x1;
+    if (edge[i].x0 > xmax) xmax = edge[i].x0;
+    if (edge[i].x1 > xmax) xmax = edge[i].x1;
+    if (edge[i].y1 > ymax) ymax = edge[i].y1;
+  }
+
+  int32_t x0 = xmin >> 8, y0 = edge[work[0].order].y0 >> 8;
+  int32_t x1 = (xmax - 1) >> 8, y1 = (ymax - 1) >> 8;
+
+  if (!clipWindow(&x0, &y0, &x1, &y1)) return;
+
+  // Pixel line buffers
+  int32_t w = x1 - x0 + 1;
+  int32_t acc[smooth ? w + 2 : 1];  // Area accumulator
+  uint8_t alpha[smooth ? w : 1];    // Pixel coverage
+  if (smooth) memset(acc, 0, sizeof(acc));
+
+  // Offset from edge x to the accumulator and pixel positions
+  int32_t ox = (_xDatum - x0) * 256;
+
+  uint32_t na = 0, next = 0; // Number of active edges, next edge in top end order
+
+  begin_nin_write();
   inTransaction = true;
 
-  int32_t i, j, byteWidth = (w + 7) / 8;
+  for (int32_t py = y0; py <= y1; py++) {
+    int32_t top = (py - _yDatum) * 256; // Pixel line in edge coordinates
+    int32_t bot = top + 256;
+
+    // Update the active edge list
+    while ((next < count) && (edge[work[next].order].y0 < bot)) work[na++].active = work[next++].order;
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < na; i++) if (edge[work[i].active].y1 > top) work[k++].active = work[i].active;
+    na = k;
+    if (!na) {
+      if (next == count) break;
+      continue;
+    }
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (1 << (i & 7))) {
-        drawPixel(x + i, y + j, color);
+    int32_t ly = py - _yDatum;
+
+    if (smooth) {
+      for (uint32_t i = 0; i < na; i++) {
+        const tftPolyEdge_t *e = edge + work[i].active;
+        int32_t ya = (e->y0 > top) ? e->y0 : top;
+        int32_t yb = (e->y1 < bot) ? e->y1 : bot;
+        int32_t xa = edgeX(e, ya) + ox;
+        int32_t xb = edgeX(e, yb) + ox;
+        if (e->dir > 0) accumulateEdge(acc, w, xa, ya - top, xb, yb - top);
+        else            accumulateEdge(acc, w, xb, yb - top, xa, ya - top);
+      }
+
+      // Convert the area to coverage and clear the accumulator for the next line
+      int32_t sum = 0;
+      for (int32_t i = 0; i < w; i++) {
+        sum += acc[i];
+        acc[i] = 0;
+        uint32_t cv = abs(sum) >> 8;
+        alpha[i] = (cv > 255) ? 255 : cv;
+      }
+      acc[w] = acc[w + 1] = 0;
+
+      // Draw the spans, fully covered pixels are drawn without blending
+      int32_t i = 0;
+      while (i < w) {
+        if (alpha[i] <= 3) { i++; continue; }
+        int32_t s = i;
+        if (alpha[i] >= 252) {
+          while ((i < w) && (alpha[i] >= 252)) i++;
+          drawFastHLine(x0 + s - _xDatum, ly, i - s, color);
+        }
+        else {
+          while ((i < w) && (alpha[i] > 3) && (alpha[i] < 252)) i++;
+          drawAlphaSpan(x0 + s - _xDatum, ly, alpha + s, i - s, color, bg_color);
+        }
+      }
+    }
+    else {
+      // Find the edges crossing the pixel centres, in x order
+      int32_t yc = top + 128;
+      uint32_t nc = 0;
+      for (uint32_t i = 0; i < na; i++) {
+        const tftPolyEdge_t *e = edge + work[i].active;
+        if ((yc < e->y0) || (yc >= e->y1)) continue;
+        int32_t x = edgeX(e, yc) + ox;
+        uint32_t j = nc++;
+        while (j && (work[j - 1].xc > x)) { work[j].xc = work[j - 1].xc; work[j].dc = work[j - 1].dc; j--; }
+        work[j].xc = x;
+        work[j].dc = e->dir;
+      }
+
+      // Fill between the crossings where the winding number is not zero
+      int32_t wind = 0, xs = 0;
+      for (uint32_t i = 0; i < nc; i++) {
+        if (!wind) xs = work[i].xc;
+        wind += work[i].dc;
+        if (wind) continue;
+        int32_t ps = (xs + 127) >> 8;    // First pixel with centre inside
+        int32_t pe = (work[i].xc + 127) >> 8; // First pixel with centre outside
+        if (ps < 0) ps = 0;
+        if (pe > w) pe = w;
+        if (pe > ps) drawFastHLine(x0 + ps - _xDatum, ly, pe - ps, color);
       }
     }
   }
 
   inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  end_nin_write();
 }
 
-
 /***************************************************************************************
-** Function name:           drawXBitmap
-** Description:             Draw an XBM image with foreground and background colors
+** Function name:           fillPolygon
+** Description:             Draw a filled polygon
 ***************************************************************************************/
-void TFT_eSPI::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bgcolor)
+// Corners are x,y pairs in 1/256 pixel units, a pixel is filled if its centre is inside
+void TFT_eSPI::fillPolygon(const int32_t *xy_fixed, uint32_t n, uint32_t color)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
+  BUS_STAT_SCOPE(STAT_POLYGON);
 
-  int32_t i, j, byteWidth = (w + 7) / 8;
+  if ((n < 3) || (n > POLYGON_CORNERS)) return;
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (1 << (i & 7)))
-           drawPixel(x + i, y + j,   color);
-      else drawPixel(x + i, y + j, bgcolor);
-    }
+  tftPolyEdge_t edge[POLYGON_CORNERS];
+  tftPolyWork_t work[POLYGON_CORNERS];
+  uint32_t count = 0;
+
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t j = (i + 1 < n) ? i + 1 : 0;
+    if (setEdge(&edge[count], xy_fixed[2 * i], xy_fixed[2 * i + 1], xy_fixed[2 * j], xy_fixed[2 * j + 1])) count++;
   }
 
-  inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  fillEdges(edge, count, work, color, 0, false);
 }
 
-
 /***************************************************************************************
-** Function name:           setCursor
-** Description:             Set the text cursor x,y position
+** Function name:           fillSmoothPolygon
+** Description:             Draw a filled anti-aliased polygon
 ***************************************************************************************/
-void TFT_eSPI::setCursor(int16_t x, int16_t y)
+// Corners are x,y pairs in 1/256 pixel units
+// If bg_color is not included the background pixel colour will be read from TFT or sprite
+void TFT_eSPI::fillSmoothPolygon(const int32_t *xy_fixed, uint32_t n, uint32_t color, uint32_t bg_color)
 {
-  cursor_x = x;
-  cursor_y = y;
-}
+  BUS_STAT_SCOPE(STAT_POLYGON);
 
+  if ((n < 3) || (n > POLYGON_CORNERS)) return;
 
-/***************************************************************************************
-** Function name:           setCursor
-** Description:             Set the text cursor x,y position and font
-***************************************************************************************/
-void TFT_eSPI::setCursor(int16_t x, int16_t y, uint8_t font)
-{
-  setTextFont(font);
-  cursor_x = x;
-  cursor_y = y;
+  tftPolyEdge_t edge[POLYGON_CORNERS];
+  tftPolyWork_t work[POLYGON_CORNERS];
+  uint32_t count = 0;
+
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t j = (i + 1 < n) ? i + 1 : 0;
+    if (setEdge(&edge[count], xy_fixed[2 * i], xy_fixed[2 * i + 1], xy_fixed[2 * j], xy_fixed[2 * j + 1])) count++;
+  }
+
+  fillEdges(edge, count, work, color, bg_color, true);
 }
 
 
 /***************************************************************************************
-** Function name:           getCursorX
-** Description:             Get the text cursor x position
+** Function name:           meshEdge - helper function for drawTriangleMesh
+** Description:             set up the x step of an edge from vertex ia down to ib
 ***************************************************************************************/
-int16_t TFT_eSPI::getCursorX(void)
+// Edge x is held as q + r/den with 0 <= r < den and is stepped exactly, so the pixels
+// found for an edge do not depend on the triangle it belongs to and edges shared by
+// adjacent triangles have no gaps or overlaps
+typedef struct {
+  uint16_t ia, ib;  // Vertex numbers, top end first, used to find shared edges
+  int32_t  dx, den; // Edge width and height
+  int32_t  dq, dr;  // x change per line, whole pixels and remainder
+} meshEdge_t;
+
+typedef struct {
+  int32_t  x, y;    // Screen position
+  uint16_t i;       // Vertex number
+} meshPoint_t;
+
+static void meshEdge(meshEdge_t *e, const meshPoint_t *a, const meshPoint_t *b)
 {
-  return cursor_x;
+  e->ia  = a->i;
+  e->ib  = b->i;
+  e->dx  = b->x - a->x;
+  e->den = b->y - a->y;
+  e->dq  = 0;
+  e->dr  = 0;
+  if (e->den > 0) {
+    e->dq = e->dx / e->den;
+    e->dr = e->dx % e->den;
+    if (e->dr < 0) { e->dr += e->den; e->dq--; }
+  }
 }
 
 /***************************************************************************************
-** Function name:           getCursorY
-** Description:             Get the text cursor y position
+** Function name:           meshWalk - helper functions for drawTriangleMesh
+** Description:             start, step and read the x position of an edge
 ***************************************************************************************/
-int16_t TFT_eSPI::getCursorY(void)
+typedef struct {
+  int32_t q, r;       // Edge x is q + r/den
+  const meshEdge_t *e;
+} meshWalk_t;
+
+static void meshWalkStart(meshWalk_t *w, const meshEdge_t *e, int32_t xa, int32_t rows)
 {
-  return cursor_y;
+  w->e = e;
+  w->q = xa;
+  w->r = 0;
+  if (rows > 0) { // Start is below the top of the edge, after clipping
+    int64_t num = (int64_t)rows * e->dx;
+    int32_t q = num / e->den;
+    int32_t r = num % e->den;
+    if (r < 0) { r += e->den; q--; }
+    w->q += q;
+    w->r  = r;
+  }
 }
 
+// First pixel on or to the right of the edge
+static inline int32_t meshWalkX(const meshWalk_t *w) { return w->q + (w->r > 0); }
 
-/***************************************************************************************
-** Function name:           setTextSize
-** Description:             Set the text size multiplier
-***************************************************************************************/
-void TFT_eSPI::setTextSize(uint8_t s)
+static inline void meshWalkStep(meshWalk_t *w)
 {
-  if (s>7) s = 7; // Limit the maximum size multiplier so byte variables can be used for rendering
-  textsize = (s > 0) ? s : 1; // Don't allow font size 0
+  w->q += w->e->dq;
+  w->r += w->e->dr;
+  if (w->r >= w->e->den) { w->r -= w->e->den; w->q++; }
 }
 
-
 /***************************************************************************************
-** Function name:           setTextColor
-** Description:             Set the font foreground colour (background is transparent)
+** Function name:           meshPlane - helper function for drawTriangleMesh
+** Description:             find the x and y gradients of a value across a triangle
 ***************************************************************************************/
-void TFT_eSPI::setTextColor(uint16_t c)
+// Gradients are 16.16 fixed point, p holds the corners in the original order and area
+// is twice the signed triangle area
+static void meshPlane(const meshPoint_t *p, int32_t a0, int32_t a1, int32_t a2, int64_t area, int32_t *dadx, int32_t *dady)
 {
-  // For 'transparent' background, we'll set the bg
-  // to the same as fg instead of using a flag
-  textcolor = textbgcolor = c;
+  *dadx = (((int64_t)(a1 - a0) * (p[2].y - p[0].y) - (int64_t)(a2 - a0) * (p[1].y - p[0].y)) * 65536) / area;
+  *dady = (((int64_t)(a2 - a0) * (p[1].x - p[0].x) - (int64_t)(a1 - a0) * (p[2].x - p[0].x)) * 65536) / area;
 }
 
+static inline int32_t meshLevel(int32_t v, int32_t max)
+{
+  v >>= 16;
+  return v < 0 ? 0 : v > max ? max : v;
+}
 
 /***************************************************************************************
-** Function name:           setTextColor
-** Description:             Set the font foreground and background colour
+** Function name:           drawTriangleMesh
+** Description:             draw triangles with shared vertices, flat or Gouraud shaded
 ***************************************************************************************/
-// Smooth fonts use the background colour for anti-aliasing and by default the
-// background is not filled. If bgfill = true, then a smooth font background fill will
-// be used.
-void TFT_eSPI::setTextColor(uint16_t c, uint16_t b, bool bgfill)
+void TFT_eSPI::drawTriangleMesh(const tftMeshVertex_t *vertex, const uint16_t *index, uint32_t count,
+                                const uint16_t *colors, uint8_t mode, TFT_eSprite *depth)
 {
-  textcolor   = c;
-  textbgcolor = b;
-  _fillbg     = bgfill;
-}
+  if (_vpOoB || vertex == nullptr || index == nullptr || colors == nullptr) return;
 
+  BUS_STAT_SCOPE(STAT_MESH);
 
-/***************************************************************************************
-** Function name:           setPivot
-** Description:             Set the pivot point on the TFT
-*************************************************************************************x*/
-void TFT_eSPI::setPivot(int16_t x, int16_t y)
+  // Clip area, limited to the depth buffer size
+  int32_t  cx0 = _vpX, cy0 = _vpY, cx1 = _vpW, cy1 = _vpH;
+  uint8_t *zbuf = nullptr;
+  int32_t  zw = 0;
+  if (depth) {
+    zbuf = (uint8_t *)depth->getPointer();
+    if (zbuf == nullptr || depth->getColorDepth() != 8) return;
+    zw = depth->width();
+    if (cx1 > zw) cx1 = zw;
+    if (cy1 > depth->height()) cy1 = depth->height();
+  }
+
+  bool gouraud = mode & MESH_GOURAUD;
+
+  // The edges of the previous triangle are kept, the next triangle in a strip or fan
+  // shares one or two of them so the edge set up is reused
+  meshEdge_t last[3];
+  uint8_t    lastCount = 0;
+
+  begin_nin_write();
+  inTransaction = true;
+
+  for (uint32_t t = 0; t < count; t++, index += 3) {
+    meshPoint_t p[3];
+    for (uint8_t k = 0; k < 3; k++) {
+      p[k].i = index[k];
+      p[k].x = vertex[p[k].i].x + _xDatum;
+      p[k].y = vertex[p[k].i].y + _yDatum;
+    }
+
+    // Products of 16-bit coordinate differences can exceed 32 bits
+    int64_t area = (int64_t)(p[1].x - p[0].x) * (p[2].y - p[0].y) - (int64_t)(p[1].y - p[0].y) * (p[2].x - p[0].x);
+    if (area == 0 || (area < 0 && (mode & MESH_CULL_CCW))) continue;
+
+    // Sort by y, then by vertex number so a shared edge is always set up the same way
+    meshPoint_t s[3] = { p[0], p[1], p[2] };
+    for (uint8_t k = 0; k < 2; k++) {
+      for (uint8_t j = 0; j < 2 - k; j++) {
+        if (s[j].y > s[j + 1].y || (s[j].y == s[j + 1].y && s[j].i > s[j + 1].i)) {
+          meshPoint_t tmp = s[j]; s[j] = s[j + 1]; s[j + 1] = tmp;
+        }
+      }
+    }
+
+    // Rows are from the top vertex to the line before the bottom vertex
+    int32_t ys = s[0].y < cy0 ? cy0 : s[0].y;
+    int32_t ye = s[2].y > cy1 ? cy1 : s[2].y;
+    if (ys >= ye) continue;
+
+    int32_t xmin = s[0].x, xmax = s[0].x;
+    for (uint8_t k = 1; k < 3; k++) {
+      if (s[k].x < xmin) xmin = s[k].x;
+      if (s[k].x > xmax) xmax = s[k].x;
+    }
+    if (xmax < cx0 || xmin >= cx1) continue;
+
+    // Long edge top to bottom, then top to middle and middle to bottom
+    meshEdge_t edge[3];
+    const meshPoint_t *ends[3][2] = { { s, s + 2 }, { s, s + 1 }, { s + 1, s + 2 } };
+    for (uint8_t k = 0; k < 3; k++) {
+      uint8_t j = 0;
+      while (j < lastCount && (last[j].ia != ends[k][0]->i || last[j].ib != ends[k][1]->i)) j++;
+      if (j < lastCount) edge[k] = last[j];
+      else meshEdge(edge + k, ends[k][0], ends[k][1]);
+    }
+    memcpy(last, edge, sizeof(edge));
+    lastCount = 3;
+
+    // The long edge is on the left if the middle vertex is to its right
+    bool longLeft = (int64_t)(s[1].x - s[0].x) * (s[2].y - s[0].y) - (int64_t)(s[1].y - s[0].y) * (s[2].x - s[0].x) > 0;
+
+    meshWalk_t lw, sw;
+    meshWalkStart(&lw, edge, s[0].x, ys - s[0].y);
+    bool upper = ys < s[1].y;
+    if (upper) meshWalkStart(&sw, edge + 1, s[0].x, ys - s[0].y);
+    else       meshWalkStart(&sw, edge + 2, s[1].x, ys - s[1].y);
+
+    // Shading and depth gradients, values are found at the start of each span
+    uint16_t color = colors[gouraud ? 0 : t];
+    int32_t  val[4] = { 0 }, ddx[4] = { 0 }, ddy[4] = { 0 };
+    uint8_t  nval = 0;
+    if (gouraud) {
+      uint16_t c0 = colors[p[0].i], c1 = colors[p[1].i], c2 = colors[p[2].i];
+      meshPlane(p, c0 >> 11, c1 >> 11, c2 >> 11, area, ddx + 0, ddy + 0);
+      meshPlane(p, (c0 >> 5) & 0x3F, (c1 >> 5) & 0x3F, (c2 >> 5) & 0x3F, area, ddx + 1, ddy + 1);
+      meshPlane(p, c0 & 0x1F, c1 & 0x1F, c2 & 0x1F, area, ddx + 2, ddy + 2);
+      val[0] = c0 >> 11; val[1] = (c0 >> 5) & 0x3F; val[2] = c0 & 0x1F;
+      nval = 3;
+    }
+    if (zbuf) {
+      meshPlane(p, vertex[p[0].i].z, vertex[p[1].i].z, vertex[p[2].i].z, area, ddx + 3, ddy + 3);
+      val[3] = vertex[p[0].i].z;
+      nval = 4;
+    }
+
+    for (int32_t y = ys; y < ye; y++) {
+      if (upper && y == s[1].y) {
+        upper = false;
+        meshWalkStart(&sw, edge + 2, s[1].x, 0);
+      }
+
+      int32_t xl = meshWalkX(longLeft ? &lw : &sw);
+      int32_t xr = meshWalkX(longLeft ? &sw : &lw);
+      meshWalkStep(&lw);
+      meshWalkStep(&sw);
+
+      if (xl < cx0) xl = cx0;
+      if (xr > cx1) xr = cx1;
+      int32_t len = xr - xl;
+      if (len < 1) continue;
+
+      if (nval == 0) {
+        drawFastHLine(xl - _xDatum, y - _yDatum, len, color);
+        continue;
+      }
+
+      int32_t v[4];
+      for (uint8_t k = 0; k < nval; k++) {
+        v[k] = (int32_t)(((int64_t)val[k] * 65536) + 0x8000 + (int64_t)ddx[k] * (xl - p[0].x) + (int64_t)ddy[k] * (y - p[0].y));
+      }
+
+      uint16_t cBuf[gouraud ? len : 1];
+      uint8_t *zrow = zbuf ? zbuf + y * zw : nullptr;
+      int32_t  run = 0; // Pixels waiting to be drawn
+
+      for (int32_t x = xl; x <= xr; x++) {
+        bool pass = x < xr;
+        if (pass && zrow) {
+          int32_t z = meshLevel(v[3], 255);
+          if (z <= zrow[x]) zrow[x] = z;
+          else pass = false;
+          v[3] += ddx[3];
+        }
+
+        if (pass) {
+          if (gouraud) {
+            cBuf[run] = meshLevel(v[0], 31) << 11 | meshLevel(v[1], 63) << 5 | meshLevel(v[2], 31);
+            v[0] += ddx[0]; v[1] += ddx[1]; v[2] += ddx[2];
+          }
+          run++;
+          continue;
+        }
+
+        if (gouraud && x < xr) { v[0] += ddx[0]; v[1] += ddx[1]; v[2] += ddx[2]; }
+        if (run) {
+          if (gouraud) pushSpan(x - run, y, cBuf, run);
+          else drawFastHLine(x - run - _xDatum, y - _yDatum, run, color);
+          run = 0;
+        }
+      }
+    }
+  }
+
+  inTransaction = lockTransaction;
+  end_nin_write();
+}
+
+
+/***************************************************************************************
+** Function name:           drawBitmap
+** Description:             Draw an image stored in an array on the TFT
+***************************************************************************************/
+void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+{
+  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
+  inTransaction = true;
+
+  int32_t i, j, byteWidth = (w + 7) / 8;
+
+  for (j = 0; j < h; j++) {
+    for (i = 0; i < w; i++ ) {
+      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (128 >> (i & 7))) {
+        drawPixel(x + i, y + j, color);
+      }
+    }
+  }
+
+  inTransaction = lockTransaction;
+  end_tft_write();              // Does nothing if Sprite class uses this function
+}
+
+
+/***************************************************************************************
+** Function name:           drawBitmap
+** Description:             Draw an image stored in an array on the TFT
+***************************************************************************************/
+void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor)
+{
+  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
+  inTransaction = true;
+
+  int32_t i, j, byteWidth = (w + 7) / 8;
+
+  for (j = 0; j < h; j++) {
+    for (i = 0; i < w; i++ ) {
+      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (128 >> (i & 7)))
+           drawPixel(x + i, y + j, fgcolor);
+      else drawPixel(x + i, y + j, bgcolor);
+    }
+  }
+
+  inTransaction = lockTransaction;
+  end_tft_write();              // Does nothing if Sprite class uses this function
+}
+
+/***************************************************************************************
+** Function name:           drawXBitmap
+** Description:             Draw an image stored in an XBM array onto the TFT
+***************************************************************************************/
+void TFT_eSPI::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+{
+  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
+  inTransaction = true;
+
+  int32_t i, j, byteWidth = (w + 7) / 8;
+
+  for (j = 0; j < h; j++) {
+    for (i = 0; i < w; i++ ) {
+      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (1 << (i & 7))) {
+        drawPixel(x + i, y + j, color);
+      }
+    }
+  }
+
+  inTransaction = lockTransaction;
+  end_tft_write();              // Does nothing if Sprite class uses this function
+}
+
+
+/***************************************************************************************
+** Function name:           drawXBitmap
+** Description:             Draw an XBM image with foreground and background colors
+***************************************************************************************/
+void TFT_eSPI::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bgcolor)
+{
+  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
+  inTransaction = true;
+
+  int32_t i, j, byteWidth = (w + 7) / 8;
+
+  for (j = 0; j < h; j++) {
+    for (i = 0; i < w; i++ ) {
+      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (1 << (i & 7)))
+           drawPixel(x + i, y + j,   color);
+      else drawPixel(x + i, y + j, bgcolor);
+    }
+  }
+
+  inTransaction = lockTransaction;
+  end_tft_write();              // Does nothing if Sprite class uses this function
+}
+
+
+/***************************************************************************************
+** Function name:           setCursor
+** Description:             Set the text cursor x,y position
+***************************************************************************************/
+void TFT_eSPI::setCursor(int16_t x, int16_t y)
+{
+  cursor_x = x;
+  cursor_y = y;
+}
+
+
+/***************************************************************************************
+** Function name:           setCursor
+** Description:             Set the text cursor x,y position and font
+***************************************************************************************/
+void TFT_eSPI::setCursor(int16_t x, int16_t y, uint8_t font)
+{
+  setTextFont(font);
+  cursor_x = x;
+  cursor_y = y;
+}
+
+
+/***************************************************************************************
+** Function name:           getCursorX
+** Description:             Get the text cursor x position
+***************************************************************************************/
+int16_t TFT_eSPI::getCursorX(void)
+{
+  return cursor_x;
+}
+
+/***************************************************************************************
+** Function name:           getCursorY
+** Description:             Get the text cursor y position
+***************************************************************************************/
+int16_t TFT_eSPI::getCursorY(void)
+{
+  return cursor_y;
+}
+
+
+/***************************************************************************************
+** Function name:           setTextSize
+** Description:             Set the text size multiplier
+***************************************************************************************/
+void TFT_eSPI::setTextSize(uint8_t s)
+{
+  if (s>7) s = 7; // Limit the maximum size multiplier so byte variables can be used for rendering
+  textsize = (s > 0) ? s : 1; // Don't allow font size 0
+}
+
+
+/***************************************************************************************
+** Function name:           setTextColor
+** Description:             Set the font foreground colour (background is transparent)
+***************************************************************************************/
+void TFT_eSPI::setTextColor(uint16_t c)
+{
+  // For 'transparent' background, we'll set the bg
+  // to the same as fg instead of using a flag
+  textcolor = textbgcolor = c;
+}
+
+
+/***************************************************************************************
+** Function name:           setTextColor
+** Description:             Set the font foreground and background colour
+***************************************************************************************/
+// Smooth fonts use the background colour for anti-aliasing and by default the
+// background is not filled. If bgfill = true, then a smooth font background fill will
+// be used.
+void TFT_eSPI::setTextColor(uint16_t c, uint16_t b, bool bgfill)
+{
+  textcolor   = c;
+  textbgcolor = b;
+  _fillbg     = bgfill;
+}
+
+
+/***************************************************************************************
+** Function name:           setPivot
+** Description:             Set the pivot point on the TFT
+*************************************************************************************x*/
+void TFT_eSPI::setPivot(int16_t x, int16_t y)
 {
   _xPivot = x;
   _yPivot = y;
@@ -3229,6 +4085,8 @@ void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32
 {
   if (_vpOoB) return;
 
+  BUS_STAT_SCOPE(STAT_DRAW_CHAR);
+
 #ifdef LOAD_GLCD
 //>>>>>>>>>>>>>>>>>>
   #ifdef LOAD_GFXFF
@@ -3269,6 +4127,7 @@ void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32
       mask <<= 1;
       tft_Write_16(bg);
     }
+    BUS_STAT_WRITE(48);
 
     end_tft_write();
   }
@@ -3405,10 +4264,11 @@ void TFT_eSPI::setAddrWindow(int32_t x0, int32_t y0, int32_t w, int32_t h)
 void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
 {
   //begin_tft_write(); // Must be called before setWindow
+
+#if defined (ILI9225_DRIVER)
   addr_row = 0xFFFF;
   addr_col = 0xFFFF;
 
-#if defined (ILI9225_DRIVER)
   if (rotation & 0x01) { transpose(x0, y0); transpose(x1, y1); }
   SPI_BUSY_CHECK;
   DC_C; tft_Write_8(TFT_CASET1);
@@ -3429,6 +4289,7 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
   // write to RAM
   DC_C; tft_Write_8(TFT_RAMWR);
   DC_D;
+  BUS_STAT_WINDOW(7, 12);
   // Temporary solution is to include the RP2040 code here
   #if (defined(ARDUINO_ARCH_RP2040)  || defined (ARDUINO_ARCH_MBED)) && !defined(RP2040_PIO_INTERFACE) && !defined(ARDUINO_ARCH_NRF52840)
     // For ILI9225 and RP2040 the slower Arduino SPI transfer calls were used, so need to swap back to 16-bit mode
@@ -3440,6 +4301,8 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
     transpose(x0, y0);
     transpose(x1, y1);
   }
+  // The RAM write command does not return the address pointer to the start of
+  // the window, so both ranges are always sent to set it
   SPI_BUSY_CHECK;
   DC_C; tft_Write_8(TFT_CASET);
   DC_D; tft_Write_16(x1 | (x0 << 8));
@@ -3447,6 +4310,9 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
   DC_D; tft_Write_16(y1 | (y0 << 8));
   DC_C; tft_Write_8(TFT_RAMWR);
   DC_D;
+  addr_col = ((uint32_t)x0 << 16) | (uint16_t)x1;
+  addr_row = ((uint32_t)y0 << 16) | (uint16_t)y1;
+  BUS_STAT_WINDOW(3, 4);
 #else
   #if defined (SSD1963_DRIVER)
     if ((rotation & 0x1) == 0) { transpose(x0, y0); transpose(x1, y1); }
@@ -3459,13 +4325,22 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
     y1+=rowstart;
   #endif
 
+  #if defined (MULTI_TFT_SUPPORT) || defined (GC9A01_DRIVER)
+    addr_row = 0xFFFF;
+    addr_col = 0xFFFF;
+  #endif
+
+  // The TFT keeps the column and page ranges, and RAMWR returns the address pointer
+  // to the window start, so only the ranges that have changed need to be sent
+  uint32_t xw = ((uint32_t)x0 << 16) | (uint16_t)x1;
+  uint32_t yw = ((uint32_t)y0 << 16) | (uint16_t)y1;
+
   // Temporary solution is to include the RP2040 optimised code here
   #if (defined(ARDUINO_ARCH_RP2040)  || defined (ARDUINO_ARCH_MBED)) && !defined(ARDUINO_ARCH_NRF52840)
     #if !defined(RP2040_PIO_INTERFACE)
       // Use hardware SPI port, this code does not swap from 8 to 16-bit
       // to avoid the spi_set_format() call overhead
       while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
-      DC_C;
       #if !defined (SPI_18BIT_DRIVER)
         #if  defined (RPI_DISPLAY_TYPE) // RPi TFT type always needs 16-bit transfers
           hw_write_masked(&spi_get_hw(SPI_X)->cr0, (16 - 1) << SPI_SSPCR0_DSS_LSB, SPI_SSPCR0_DSS_BITS);
@@ -3473,27 +4348,39 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
           hw_write_masked(&spi_get_hw(SPI_X)->cr0, (8 - 1) << SPI_SSPCR0_DSS_LSB, SPI_SSPCR0_DSS_BITS);
         #endif
       #endif
-      spi_get_hw(SPI_X)->dr = (uint32_t)TFT_CASET;
 
-      while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
-      DC_D;
-      spi_get_hw(SPI_X)->dr = (uint32_t)x0>>8;
-      spi_get_hw(SPI_X)->dr = (uint32_t)x0;
-      spi_get_hw(SPI_X)->dr = (uint32_t)x1>>8;
-      spi_get_hw(SPI_X)->dr = (uint32_t)x1;
+      if (addr_col != xw) {
+        DC_C;
+        spi_get_hw(SPI_X)->dr = (uint32_t)TFT_CASET;
 
-      while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
-      DC_C;
-      spi_get_hw(SPI_X)->dr = (uint32_t)TFT_PASET;
+        while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
+        DC_D;
+        spi_get_hw(SPI_X)->dr = (uint32_t)x0>>8;
+        spi_get_hw(SPI_X)->dr = (uint32_t)x0;
+        spi_get_hw(SPI_X)->dr = (uint32_t)x1>>8;
+        spi_get_hw(SPI_X)->dr = (uint32_t)x1;
+        addr_col = xw;
+        BUS_STAT_CMD(1, 4);
 
-      while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
-      DC_D;
-      spi_get_hw(SPI_X)->dr = (uint32_t)y0>>8;
-      spi_get_hw(SPI_X)->dr = (uint32_t)y0;
-      spi_get_hw(SPI_X)->dr = (uint32_t)y1>>8;
-      spi_get_hw(SPI_X)->dr = (uint32_t)y1;
+        while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
+      }
+
+      if (addr_row != yw) {
+        DC_C;
+        spi_get_hw(SPI_X)->dr = (uint32_t)TFT_PASET;
+
+        while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
+        DC_D;
+        spi_get_hw(SPI_X)->dr = (uint32_t)y0>>8;
+        spi_get_hw(SPI_X)->dr = (uint32_t)y0;
+        spi_get_hw(SPI_X)->dr = (uint32_t)y1>>8;
+        spi_get_hw(SPI_X)->dr = (uint32_t)y1;
+        addr_row = yw;
+        BUS_STAT_CMD(1, 4);
+
+        while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
+      }
 
-      while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
       DC_C;
       spi_get_hw(SPI_X)->dr = (uint32_t)TFT_RAMWR;
 
@@ -3502,20 +4389,31 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
         hw_write_masked(&spi_get_hw(SPI_X)->cr0, (16 - 1) << SPI_SSPCR0_DSS_LSB, SPI_SSPCR0_DSS_BITS);
       #endif
       DC_D;
+      BUS_STAT_WINDOW(1, 0);
     #elif defined (RM68120_DRIVER)
-      DC_C; tft_Write_16(TFT_CASET+0); DC_D; tft_Write_16(x0 >> 8);
-      DC_C; tft_Write_16(TFT_CASET+1); DC_D; tft_Write_16(x0 & 0xFF);
-      DC_C; tft_Write_16(TFT_CASET+2); DC_D; tft_Write_16(x1 >> 8);
-      DC_C; tft_Write_16(TFT_CASET+3); DC_D; tft_Write_16(x1 & 0xFF);
-      DC_C; tft_Write_16(TFT_PASET+0); DC_D; tft_Write_16(y0 >> 8);
-      DC_C; tft_Write_16(TFT_PASET+1); DC_D; tft_Write_16(y0 & 0xFF);
-      DC_C; tft_Write_16(TFT_PASET+2); DC_D; tft_Write_16(y1 >> 8);
-      DC_C; tft_Write_16(TFT_PASET+3); DC_D; tft_Write_16(y1 & 0xFF);
+      if (addr_col != xw) {
+        DC_C; tft_Write_16(TFT_CASET+0); DC_D; tft_Write_16(x0 >> 8);
+        DC_C; tft_Write_16(TFT_CASET+1); DC_D; tft_Write_16(x0 & 0xFF);
+        DC_C; tft_Write_16(TFT_CASET+2); DC_D; tft_Write_16(x1 >> 8);
+        DC_C; tft_Write_16(TFT_CASET+3); DC_D; tft_Write_16(x1 & 0xFF);
+        addr_col = xw;
+        BUS_STAT_CMD(4, 8);
+      }
+      if (addr_row != yw) {
+        DC_C; tft_Write_16(TFT_PASET+0); DC_D; tft_Write_16(y0 >> 8);
+        DC_C; tft_Write_16(TFT_PASET+1); DC_D; tft_Write_16(y0 & 0xFF);
+        DC_C; tft_Write_16(TFT_PASET+2); DC_D; tft_Write_16(y1 >> 8);
+        DC_C; tft_Write_16(TFT_PASET+3); DC_D; tft_Write_16(y1 & 0xFF);
+        addr_row = yw;
+        BUS_STAT_CMD(4, 8);
+      }
 
       DC_C; tft_Write_16(TFT_RAMWR);
       DC_D;
+      BUS_STAT_WINDOW(1, 0);
     #else
       // This is for the RP2040 and PIO interface (SPI or parallel)
+      // The PIO program always sends the complete window sequence
       WAIT_FOR_STALL;
       tft_pio->sm[pio_sm].instr = pio_instr_addr;
 
@@ -3524,15 +4422,31 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
       TX_FIFO = TFT_PASET;
       TX_FIFO = (y0<<16) | y1;
       TX_FIFO = TFT_RAMWR;
+      addr_col = xw;
+      addr_row = yw;
+      BUS_STAT_WINDOW(3, 8);
     #endif
   #else
     SPI_BUSY_CHECK;
-    DC_C; tft_Write_8(TFT_CASET);
-    DC_D; tft_Write_32C(x0, x1);
-    DC_C; tft_Write_8(TFT_PASET);
-    DC_D; tft_Write_32C(y0, y1);
+    // No need to send the column range if it has not changed (speeds things up)
+    if (addr_col != xw) {
+      DC_C; tft_Write_8(TFT_CASET);
+      DC_D; tft_Write_32C(x0, x1);
+      addr_col = xw;
+      BUS_STAT_CMD(1, 4);
+    }
+
+    // No need to send the page range if it has not changed (speeds things up)
+    if (addr_row != yw) {
+      DC_C; tft_Write_8(TFT_PASET);
+      DC_D; tft_Write_32C(y0, y1);
+      addr_row = yw;
+      BUS_STAT_CMD(1, 4);
+    }
+
     DC_C; tft_Write_8(TFT_RAMWR);
     DC_D;
+    BUS_STAT_WINDOW(1, 0);
   #endif // RP2040 SPI
 #endif
   //end_tft_write(); // Must be called after setWindow
@@ -3549,9 +4463,6 @@ void TFT_eSPI::readAddrWindow(int32_t xs, int32_t ys, int32_t w, int32_t h)
   int32_t xe = xs + w - 1;
   int32_t ye = ys + h - 1;
 
-  addr_col = 0xFFFF;
-  addr_row = 0xFFFF;
-
 #if defined (SSD1963_DRIVER)
   if ((rotation & 0x1) == 0) { transpose(xs, ys); transpose(xe, ye); }
 #endif
@@ -3563,6 +4474,10 @@ void TFT_eSPI::readAddrWindow(int32_t xs, int32_t ys, int32_t w, int32_t h)
   ye += rowstart;
 #endif
 
+  // Both ranges are sent, so the TFT window matches these afterwards
+  addr_col = ((uint32_t)xs << 16) | (uint16_t)xe;
+  addr_row = ((uint32_t)ys << 16) | (uint16_t)ye;
+
   // Temporary solution is to include the RP2040 optimised code here
 #if (defined(ARDUINO_ARCH_RP2040)  || defined (ARDUINO_ARCH_MBED)) && !defined(RP2040_PIO_INTERFACE) && !defined(ARDUINO_ARCH_NRF52840)
   // Use hardware SPI port, this code does not swap from 8 to 16-bit
@@ -3616,6 +4531,9 @@ void TFT_eSPI::readAddrWindow(int32_t xs, int32_t ys, int32_t w, int32_t h)
   DC_D;
 #endif // RP2040 SPI
 
+  BUS_STAT_WINDOW(3, 8);
+  BUS_STAT_READ;
+
   //end_tft_write(); // Must be called after readAddrWindow or CS set high
 }
 
@@ -3626,6 +4544,10 @@ void TFT_eSPI::readAddrWindow(int32_t xs, int32_t ys, int32_t w, int32_t h)
 ***************************************************************************************/
 void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
 {
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord && dlRect(x, y, 1, 1, color)) return;
+#endif
+
   if (_vpOoB) return;
 
   x+= _xDatum;
@@ -3634,6 +4556,8 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
   // Range checking
   if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return;
 
+  BUS_STAT_SCOPE(STAT_DRAW_PIXEL);
+
 #ifdef CGRAM_OFFSET
   x+=colstart;
   y+=rowstart;
@@ -3662,6 +4586,7 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
     DC_D; tft_Write_16(0);
     DC_C; tft_Write_8(TFT_PASET2);
     DC_D; tft_Write_16(219);
+    BUS_STAT_CMD(4, 8);
   }
 
   // Define pixel coordinate
@@ -3677,6 +4602,8 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
   #else
     DC_D; tft_Write_16N(color);
   #endif
+  BUS_STAT_WINDOW(3, 4);
+  BUS_STAT_WRITE(1);
 
 // Temporary solution is to include the RP2040 optimised code here
 #elif (defined (ARDUINO_ARCH_RP2040) || defined (ARDUINO_ARCH_MBED)) && !defined (SSD1351_DRIVER) && !defined(ARDUINO_ARCH_NRF52840)
@@ -3685,6 +4612,10 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
     if ((rotation & 0x1) == 0) { transpose(x, y); }
   #endif
 
+  // Single pixel column and page ranges, as held in the window shadow
+  uint32_t xw = ((uint32_t)x << 16) | x;
+  uint32_t yw = ((uint32_t)y << 16) | y;
+
   #if !defined(RP2040_PIO_INTERFACE)
     while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
 
@@ -3694,7 +4625,7 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
       hw_write_masked(&spi_get_hw(SPI_X)->cr0, (8 - 1) << SPI_SSPCR0_DSS_LSB, SPI_SSPCR0_DSS_BITS);
     #endif
 
-    if (addr_col != x) {
+    if (addr_col != xw) {
       DC_C;
       spi_get_hw(SPI_X)->dr = (uint32_t)TFT_CASET;
       while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS){};
@@ -3703,11 +4634,12 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
       spi_get_hw(SPI_X)->dr = (uint32_t)x;
       spi_get_hw(SPI_X)->dr = (uint32_t)x>>8;
       spi_get_hw(SPI_X)->dr = (uint32_t)x;
-      addr_col = x;
+      addr_col = xw;
+      BUS_STAT_CMD(1, 4);
       while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
     }
 
-    if (addr_row != y) {
+    if (addr_row != yw) {
       DC_C;
       spi_get_hw(SPI_X)->dr = (uint32_t)TFT_PASET;
       while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
@@ -3716,7 +4648,8 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
       spi_get_hw(SPI_X)->dr = (uint32_t)y;
       spi_get_hw(SPI_X)->dr = (uint32_t)y>>8;
       spi_get_hw(SPI_X)->dr = (uint32_t)y;
-      addr_row = y;
+      addr_row = yw;
+      BUS_STAT_CMD(1, 4);
       while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
     }
 
@@ -3740,25 +4673,31 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
         spi_get_hw(SPI_X)->dr = (uint32_t)color;
       #endif
     #endif
+    BUS_STAT_WINDOW(1, 0);
+    BUS_STAT_WRITE(1);
     while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
   #elif defined (RM68120_DRIVER)
-    if (addr_col != x) {
+    if (addr_col != xw) {
       DC_C; tft_Write_16(TFT_CASET+0); DC_D; tft_Write_16(x >> 8);
       DC_C; tft_Write_16(TFT_CASET+1); DC_D; tft_Write_16(x & 0xFF);
       DC_C; tft_Write_16(TFT_CASET+2); DC_D; tft_Write_16(x >> 8);
       DC_C; tft_Write_16(TFT_CASET+3); DC_D; tft_Write_16(x & 0xFF);
-      addr_col = x;
+      addr_col = xw;
+      BUS_STAT_CMD(4, 8);
     }
-    if (addr_row != y) {
+    if (addr_row != yw) {
       DC_C; tft_Write_16(TFT_PASET+0); DC_D; tft_Write_16(y >> 8);
       DC_C; tft_Write_16(TFT_PASET+1); DC_D; tft_Write_16(y & 0xFF);
       DC_C; tft_Write_16(TFT_PASET+2); DC_D; tft_Write_16(y >> 8);
       DC_C; tft_Write_16(TFT_PASET+3); DC_D; tft_Write_16(y & 0xFF);
-      addr_row = y;
+      addr_row = yw;
+      BUS_STAT_CMD(4, 8);
     }
     DC_C; tft_Write_16(TFT_RAMWR); DC_D;
 
     TX_FIFO = color;
+    BUS_STAT_WINDOW(1, 0);
+    BUS_STAT_WRITE(1);
   #else
     // This is for the RP2040 and PIO interface (SPI or parallel)
     WAIT_FOR_STALL;
@@ -3774,6 +4713,8 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
     #else
       TX_FIFO = color;
     #endif
+    BUS_STAT_WINDOW(3, 8);
+    BUS_STAT_WRITE(1);
 
   #endif
 
@@ -3787,32 +4728,43 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
 
   #if defined (SSD1351_DRIVER)
     if (rotation & 0x1) { transpose(x, y); }
+  #endif
+
+  // Single pixel column and page ranges, as held in the window shadow
+  uint32_t xw = ((uint32_t)x << 16) | x;
+  uint32_t yw = ((uint32_t)y << 16) | y;
+
+  #if defined (SSD1351_DRIVER)
     // No need to send x if it has not changed (speeds things up)
-    if (addr_col != x) {
+    if (addr_col != xw) {
       DC_C; tft_Write_8(TFT_CASET);
       DC_D; tft_Write_16(x | (x << 8));
-      addr_col = x;
+      addr_col = xw;
+      BUS_STAT_CMD(1, 2);
     }
 
     // No need to send y if it has not changed (speeds things up)
-    if (addr_row != y) {
+    if (addr_row != yw) {
       DC_C; tft_Write_8(TFT_PASET);
       DC_D; tft_Write_16(y | (y << 8));
-      addr_row = y;
+      addr_row = yw;
+      BUS_STAT_CMD(1, 2);
     }
   #else
     // No need to send x if it has not changed (speeds things up)
-    if (addr_col != x) {
+    if (addr_col != xw) {
       DC_C; tft_Write_8(TFT_CASET);
       DC_D; tft_Write_32D(x);
-      addr_col = x;
+      addr_col = xw;
+      BUS_STAT_CMD(1, 4);
     }
 
     // No need to send y if it has not changed (speeds things up)
-    if (addr_row != y) {
+    if (addr_row != yw) {
       DC_C; tft_Write_8(TFT_PASET);
       DC_D; tft_Write_32D(y);
-      addr_row = y;
+      addr_row = yw;
+      BUS_STAT_CMD(1, 4);
     }
   #endif
 
@@ -3823,6 +4775,8 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
   #else
     DC_D; tft_Write_16N(color);
   #endif
+  BUS_STAT_WINDOW(1, 0);
+  BUS_STAT_WRITE(1);
 #endif
 
   end_tft_write();
@@ -3838,6 +4792,7 @@ void TFT_eSPI::pushColor(uint16_t color)
 
   SPI_BUSY_CHECK;
   tft_Write_16N(color);
+  BUS_STAT_WRITE(1);
 
   end_tft_write();
 }
@@ -3851,7 +4806,7 @@ void TFT_eSPI::pushColor(uint16_t color, uint32_t len)
 {
   begin_tft_write();
 
-  pushBlock(color, len);
+  pushBlock(color, len); BUS_STAT_BLOCK(len);
 
   end_tft_write();
 }
@@ -3885,7 +4840,7 @@ void TFT_eSPI::endWrite(void)
 ***************************************************************************************/
 void TFT_eSPI::writeColor(uint16_t color, uint32_t len)
 {
-  pushBlock(color, len);
+  pushBlock(color, len); BUS_STAT_BLOCK(len);
 }
 
 /***************************************************************************************
@@ -3898,7 +4853,7 @@ void TFT_eSPI::pushColors(uint8_t *data, uint32_t len)
 {
   begin_tft_write();
 
-  pushPixels(data, len>>1);
+  pushPixels(data, len>>1); BUS_STAT_PIXELS(len>>1);
 
   end_tft_write();
 }
@@ -3913,7 +4868,7 @@ void TFT_eSPI::pushColors(uint16_t *data, uint32_t len, bool swap)
   begin_tft_write();
   if (swap) {swap = _swapBytes; _swapBytes = true; }
 
-  pushPixels(data, len);
+  pushPixels(data, len); BUS_STAT_PIXELS(len);
 
   _swapBytes = swap; // Restore old value
   end_tft_write();
@@ -3930,6 +4885,8 @@ void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t
 {
   if (_vpOoB) return;
 
+  BUS_STAT_SCOPE(STAT_DRAW_LINE);
+
   //begin_tft_write();       // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
@@ -3989,14 +4946,302 @@ void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t
 }
 
 
+/***************************************************************************************
+** Function name:           batchFill - helper function for batched drawing
+** Description:             fill a rectangle clipped to the viewport, TFT only
+***************************************************************************************/
+void TFT_eSPI::batchFill(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  setWindow(x, y, x + w - 1, y + h - 1);
+
+  pushBlock(color, w * h); BUS_STAT_BLOCK(w * h);
+}
+
+
+// Batches are sorted in blocks of this many items
+constexpr uint32_t BatchBlock = 64;
+
+/***************************************************************************************
+** Function name:           batchSort - helper function for batched drawing
+** Description:             stable sort of item numbers by key
+***************************************************************************************/
+// Insertion sort, batches are often nearly in order already. Items with the same key
+// keep their order so the last one drawn is the same as for single calls
+static void batchSort(uint32_t *key, uint8_t *order, uint8_t n)
+{
+  for (uint8_t i = 1; i < n; i++) {
+    uint32_t k = key[i];
+    uint8_t  o = order[i];
+    int32_t  j = i - 1;
+    while (j >= 0 && key[j] > k) {
+      key[j + 1]   = key[j];
+      order[j + 1] = order[j];
+      j--;
+    }
+    key[j + 1]   = k;
+    order[j + 1] = o;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           drawPixels
+** Description:             draw n pixels, each with its own colour
+***************************************************************************************/
+void TFT_eSPI::drawPixels(const tftPoint_t *point, const uint16_t *colors, uint32_t n)
+{
+  if (point == nullptr || colors == nullptr) return;
+
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord) {
+    for (uint32_t i = 0; i < n; i++) drawPixel(point[i].x, point[i].y, colors[i]);
+    return;
+  }
+#endif
+
+  if (_vpOoB) return;
+
+  BUS_STAT_SCOPE(STAT_DRAW_PIXEL);
+
+  // Clip area in sketch coordinates
+  int32_t x0 = _vpX - _xDatum, y0 = _vpY - _yDatum;
+  int32_t x1 = _vpW - _xDatum, y1 = _vpH - _yDatum;
+
+  uint32_t key[BatchBlock];
+  uint8_t  order[BatchBlock];
+  uint16_t cBuf[BatchBlock];
+
+  // Colours are in processor byte order
+  bool swap = _swapBytes; _swapBytes = true;
+
+  begin_tft_write();
+
+  while (n) {
+    uint32_t count = n < BatchBlock ? n : BatchBlock;
+
+    // Sort the pixels inside the clip area by row then column
+    uint8_t m = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      int32_t x = point[i].x, y = point[i].y;
+      if ((x < x0) || (y < y0) || (x >= x1) || (y >= y1)) continue;
+      key[m]   = (uint32_t)(y + _yDatum) << 16 | (x + _xDatum);
+      order[m] = i;
+      m++;
+    }
+    batchSort(key, order, m);
+
+    // Pixels next to each other on a row are sent with one window
+    uint8_t i = 0;
+    while (i < m) {
+      uint32_t start = key[i];
+      uint8_t  len = 0;
+      cBuf[len++] = colors[order[i++]];
+      while (i < m) {
+        if (key[i] == key[i - 1]) cBuf[len - 1] = colors[order[i]]; // Same pixel again
+        else if (key[i] == key[i - 1] + 1) cBuf[len++] = colors[order[i]];
+        else break;
+        i++;
+      }
+      int32_t xs = start & 0xFFFF;
+      int32_t ys = start >> 16;
+      setWindow(xs, ys, xs + len - 1, ys);
+      pushPixels(cBuf, len); BUS_STAT_PIXELS(len);
+    }
+
+    point  += count;
+    colors += count;
+    n      -= count;
+  }
+
+  end_tft_write();
+
+  _swapBytes = swap;
+}
+
+
+/***************************************************************************************
+** Function name:           drawPolyline
+** Description:             draw lines joining n points
+***************************************************************************************/
+// The lines are the same as drawLine() gives, but the runs of pixels are clipped and
+// sent directly instead of through drawFastHLine() and drawFastVLine()
+void TFT_eSPI::drawPolyline(const tftPoint_t *point, uint32_t n, uint32_t color)
+{
+  if (point == nullptr || n == 0) return;
+
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord) {
+    if (n == 1) drawPixel(point[0].x, point[0].y, color);
+    for (uint32_t i = 1; i < n; i++) drawLine(point[i - 1].x, point[i - 1].y, point[i].x, point[i].y, color);
+    return;
+  }
+#endif
+
+  if (_vpOoB) return;
+
+  BUS_STAT_SCOPE(STAT_DRAW_LINE);
+
+  // Clip area in sketch coordinates
+  int32_t cx0 = _vpX - _xDatum, cy0 = _vpY - _yDatum;
+  int32_t cx1 = _vpW - _xDatum, cy1 = _vpH - _yDatum;
+
+  begin_tft_write();
+
+  if (n == 1) batchFill(point[0].x, point[0].y, 1, 1, color);
+
+  for (uint32_t i = 1; i < n; i++) {
+    int32_t x0 = point[i - 1].x, y0 = point[i - 1].y;
+    int32_t x1 = point[i].x,     y1 = point[i].y;
+
+    // Lines outside the clip area are skipped
+    if (((x0 < cx0) && (x1 < cx0)) || ((x0 >= cx1) && (x1 >= cx1)) ||
+        ((y0 < cy0) && (y1 < cy0)) || ((y0 >= cy1) && (y1 >= cy1))) continue;
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+      transpose(x0, y0);
+      transpose(x1, y1);
+    }
+
+    if (x0 > x1) {
+      transpose(x0, x1);
+      transpose(y0, y1);
+    }
+
+    int32_t dx = x1 - x0, dy = abs(y1 - y0);
+
+    int32_t err = dx >> 1, ystep = -1, xs = x0, dlen = 0;
+
+    if (y0 < y1) ystep = 1;
+
+    for (; x0 <= x1; x0++) {
+      dlen++;
+      err -= dy;
+      if (err < 0) {
+        if (steep) batchFill(y0, xs, 1, dlen, color);
+        else       batchFill(xs, y0, dlen, 1, color);
+        dlen = 0;
+        y0 += ystep; xs = x0 + 1;
+        err += dx;
+      }
+    }
+    if (dlen) {
+      if (steep) batchFill(y0, xs, 1, dlen, color);
+      else       batchFill(xs, y0, dlen, 1, color);
+    }
+  }
+
+  end_tft_write();
+}
+
+
+/***************************************************************************************
+** Function name:           fillRects
+** Description:             fill n rectangles with one colour
+***************************************************************************************/
+void TFT_eSPI::fillRects(const tftRect_t *rect, uint32_t n, uint32_t color)
+{
+  if (rect == nullptr) return;
+
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord) {
+    for (uint32_t i = 0; i < n; i++) fillRect(rect[i].x, rect[i].y, rect[i].w, rect[i].h, color);
+    return;
+  }
+#endif
+
+  if (_vpOoB) return;
+
+  BUS_STAT_SCOPE(STAT_FILL_RECT);
+
+  begin_tft_write();
+
+  // Not sorted, rectangles may overlap on several rows so the order must be kept
+  for (uint32_t i = 0; i < n; i++) batchFill(rect[i].x, rect[i].y, rect[i].w, rect[i].h, color);
+
+  end_tft_write();
+}
+
+
+/***************************************************************************************
+** Function name:           drawHLines
+** Description:             draw n horizontal lines, each with its own colour
+***************************************************************************************/
+void TFT_eSPI::drawHLines(const tftSpan_t *span, uint32_t n)
+{
+  if (span == nullptr) return;
+
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord) {
+    for (uint32_t i = 0; i < n; i++) drawFastHLine(span[i].x, span[i].y, span[i].w, span[i].color);
+    return;
+  }
+#endif
+
+  if (_vpOoB) return;
+
+  BUS_STAT_SCOPE(STAT_FAST_LINE);
+
+  // Clip rows in sketch coordinates
+  int32_t y0 = _vpY - _yDatum, y1 = _vpH - _yDatum;
+
+  uint32_t key[BatchBlock];
+  uint8_t  order[BatchBlock];
+
+  begin_tft_write();
+
+  while (n) {
+    uint32_t count = n < BatchBlock ? n : BatchBlock;
+
+    // Sorted by row only, so the window rows are kept for lines on the same row
+    uint8_t m = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      if ((span[i].y < y0) || (span[i].y >= y1) || (span[i].w < 1)) continue;
+      key[m]   = span[i].y - y0;
+      order[m] = i;
+      m++;
+    }
+    batchSort(key, order, m);
+
+    for (uint8_t i = 0; i < m; i++) {
+      const tftSpan_t *s = span + order[i];
+      batchFill(s->x, s->y, s->w, 1, s->color);
+    }
+
+    span += count;
+    n    -= count;
+  }
+
+  end_tft_write();
+}
+
+
 /***************************************************************************************
 ** Description:  Constants for anti-aliased line drawing on TFT and in Sprites
 ***************************************************************************************/
-constexpr float PixelAlphaGain   = 255.0;
-constexpr float LoAlphaTheshold  = 1.0/32.0;
-constexpr float HiAlphaTheshold  = 1.0 - LoAlphaTheshold;
+// Pixel coverage is in 1/256 pixel units, pixels below the low threshold are not drawn
+// and pixels above the high threshold are drawn without blending
+constexpr int32_t LoCoverage = 256/32;
+constexpr int32_t HiCoverage = 256 - LoCoverage;
 constexpr float deg2rad      = 3.14159265359/180.0;
 
+// Pixels read, blended and written at a time by drawAlphaSpan()
+constexpr int32_t AlphaSpanBlock = 64;
+
 /***************************************************************************************
 ** Function name:           drawPixel (alpha blended)
 ** Description:             Draw a pixel blended with the screen or bg pixel colour
@@ -4010,6 +5255,97 @@ uint16_t TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color, uint8_t alpha
 }
 
 
+/***************************************************************************************
+** Function name:           drawAlphaSpan
+** Description:             Draw a line of pixels blended with the screen or bg colour
+***************************************************************************************/
+void TFT_eSPI::drawAlphaSpan(int32_t x, int32_t y, const uint8_t *alpha, int32_t len, uint32_t color, uint32_t bg_color, bool reverse)
+{
+  if (_vpOoB || len < 1) return;
+
+  // Clip to the viewport
+  int32_t xs = x + _xDatum;
+  int32_t ys = y + _yDatum;
+  if ((ys < _vpY) || (ys >= _vpH) || (xs >= _vpW) || (xs + len <= _vpX)) return;
+
+  int32_t skip = 0;
+  if (xs < _vpX) skip = _vpX - xs;
+  int32_t dw = len - skip;
+  if (xs + len > _vpW) dw -= xs + len - _vpW;
+
+  // Work in blocks so long spans use a fixed amount of stack
+  uint8_t  aBuf[AlphaSpanBlock];
+  uint16_t cBuf[AlphaSpanBlock];
+
+  while (dw > 0) {
+    int32_t n = (dw > AlphaSpanBlock) ? AlphaSpanBlock : dw;
+
+    // Get the alpha values in left to right order
+    const uint8_t *ap = alpha;
+    if (reverse) {
+      const uint8_t *rp = alpha + len - 1 - skip;
+      for (int32_t i = 0; i < n; i++) aBuf[i] = *rp--;
+      ap = aBuf;
+    }
+    else ap += skip;
+
+    // Background colours, the screen is read in one transfer
+    if (bg_color == 0x00FFFFFF) readSpan(xs + skip, ys, cBuf, n);
+    else for (int32_t i = 0; i < n; i++) cBuf[i] = bg_color;
+
+    blendSpanConst(cBuf, color, ap, n);
+
+    pushSpan(xs + skip, ys, cBuf, n);
+
+    skip += n;
+    dw   -= n;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           readSpan
+** Description:             Read a line of colours at a clipped screen position
+***************************************************************************************/
+// Coordinates include the datum. TFT_eSprite overrides this to read the Sprite memory
+void TFT_eSPI::readSpan(int32_t xs, int32_t ys, uint16_t *color, int32_t len)
+{
+  readRect(xs - _xDatum, ys - _yDatum, len, 1, color);
+
+  // readRect() returns the colours in TFT byte order
+  for (int32_t i = 0; i < len; i++) color[i] = (color[i] >> 8) | (color[i] << 8);
+}
+
+
+/***************************************************************************************
+** Function name:           pushSpan
+** Description:             Draw a line of colours at a clipped screen position
+***************************************************************************************/
+// Coordinates include the datum. TFT_eSprite overrides this to write the Sprite memory
+void TFT_eSPI::pushSpan(int32_t xs, int32_t ys, const uint16_t *color, int32_t len)
+{
+#ifdef TFT_DISPLAY_LIST
+  // The span is copied into the list, if it does not fit it is drawn directly
+  if (_dlRecord && dlSpan(xs - _xDatum, ys - _yDatum, color, len)) return;
+#endif
+
+#ifdef GC9A01_DRIVER
+  for (int32_t i = 0; i < len; i++) drawPixel(xs - _xDatum + i, ys - _yDatum, color[i]);
+#else
+  begin_nin_write();
+  setWindow(xs, ys, xs + len - 1, ys);
+
+  // The colours are not byte swapped
+  bool swap = _swapBytes;
+  _swapBytes = true;
+  pushPixels(color, len); BUS_STAT_PIXELS(len);
+  _swapBytes = swap;
+
+  end_nin_write();
+#endif
+}
+
+
 /***************************************************************************************
 ** Function name:           drawSmoothArc
 ** Description:             Draw a smooth arc clockwise from 6 o'clock
@@ -4022,6 +5358,8 @@ void TFT_eSPI::drawSmoothArc(int32_t x, int32_t y, int32_t r, int32_t ir, uint32
 // anti-aliased roundEnd is optional, default is anti-aliased straight end
 // Note: rounded ends extend the arc angle so can overlap, user sketch to manage this.
 {
+  BUS_STAT_SCOPE(STAT_SMOOTH_ARC);
+
   inTransaction = true;
 
   if (endAngle != startAngle && (startAngle != 0 || endAngle != 360))
@@ -4113,6 +5451,8 @@ void TFT_eSPI::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
                        uint32_t fg_color, uint32_t bg_color,
                        bool smooth)
 {
+  BUS_STAT_SCOPE(STAT_SMOOTH_ARC);
+
   if (endAngle   > 360)   endAngle = 360;
   if (startAngle > 360) startAngle = 360;
   if (_vpOoB || startAngle == endAngle) return;
@@ -4128,7 +5468,6 @@ void TFT_eSPI::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
   inTransaction = true;
 
   int32_t xs = 0;        // x start position for quadrant scan
-  uint8_t alpha = 0;     // alpha value for blending pixels
 
   uint32_t r2 = r * r;   // Outer arc radius^2
   if (smooth) r++;       // Outer AA zone radius
@@ -4196,72 +5535,84 @@ void TFT_eSPI::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
     endSlope[3] =  slope;
   }
 
+  // The slope increases along a pixel line so the arc start and end slopes in each
+  // quadrant give a single range of pixels inside the arc. Quadrant slope limits:
+  uint32_t loSlope[4] = { endSlope[0], startSlope[1], endSlope[2], startSlope[3] };
+  uint32_t hiSlope[4] = { startSlope[0], endSlope[1], startSlope[2], endSlope[3] };
+
+  // Start of the solid, inner AA and inner skipped zones, these are tracked like xs
+  int32_t xo = 0, xi = 0, xe = 0;
+
+  // AA pixel alpha values, drawn in runs with drawAlphaSpan()
+  uint8_t aBuf[16];
+  const int32_t aMax = sizeof(aBuf);
+
   // Scan quadrant
   for (int32_t cy = r - 1; cy > 0; cy--)
   {
-    uint32_t len[4] = { 0,  0,  0,  0}; // Pixel run length
-    int32_t  xst[4] = {-1, -1, -1, -1}; // Pixel run x start
-    uint32_t dy2 = (r - cy) * (r - cy);
+    uint32_t dy  = r - cy;
+    uint32_t dy2 = dy * dy;
 
-    // Find and track arc zone start point
+    // Find and track the zone start points, these only move right as cy decreases
     while ((r - xs) * (r - xs) + dy2 >= r1) xs++;
+    if (xo < xs) xo = xs;
+    while ((xo < r) && ((r - xo) * (r - xo) + dy2 > r2)) xo++;
+    if (xi < xo) xi = xo;
+    while ((xi < r) && ((r - xi) * (r - xi) + dy2 >= r3)) xi++;
+    if (xe < xi) xe = xi;
+    while ((xe < r) && ((r - xe) * (r - xe) + dy2 > r4)) xe++;
+
+    // Find the range of cx inside the arc for each quadrant from the slope limits,
+    // slope = (dy << 16) / (r - cx) so the limits convert to limits on r - cx
+    int32_t qs[4], qe[4];
+    uint32_t num = dy << 16;
+    for (uint8_t q = 0; q < 4; q++) {
+      uint32_t maxDx = loSlope[q] ? num / loSlope[q] : r;
+      uint32_t minDx = (hiSlope[q] == 0xFFFFFFFF) ? 0 : num / (hiSlope[q] + 1) + 1;
+      qs[q] = r - (int32_t)(maxDx < (uint32_t)r ? maxDx : r);
+      qe[q] = r - (int32_t)(minDx < (uint32_t)r ? minDx : r);
+    }
 
-    for (int32_t cx = xs; cx < r; cx++)
-    {
-      // Calculate radius^2
-      uint32_t hyp = (r - cx) * (r - cx) + dy2;
+    // Outer (z = 0) and inner (z = 1) AA zones, only these pixels need an alpha value
+    for (uint8_t z = 0; z < 2; z++) {
+      int32_t ze = z ? xe : xo;
+      for (int32_t cs = z ? xi : xs; cs < ze; cs += aMax) {
+        int32_t ce = (ze - cs > aMax) ? cs + aMax - 1 : ze - 1;
 
-      // If in outer zone calculate alpha
-      if (hyp > r2) {
-        alpha = ~sqrt_fraction(hyp); // Outer AA zone
-      }
-      // If within arc fill zone, get line start and lengths for each quadrant
-      else if (hyp >= r3) {
-        // Calculate U16.16 slope
-        slope = ((r - cy) << 16)/(r - cx);
-        if (slope <= startSlope[0] && slope >= endSlope[0]) { // slope hi -> lo
-          xst[0] = cx; // Bottom left line end
-          len[0]++;
-        }
-        if (slope >= startSlope[1] && slope <= endSlope[1]) { // slope lo -> hi
-          xst[1] = cx; // Top left line end
-          len[1]++;
-        }
-        if (slope <= startSlope[2] && slope >= endSlope[2]) { // slope hi -> lo
-          xst[2] = cx; // Bottom right line start
-          len[2]++;
+        bool used = false;
+        for (uint8_t q = 0; q < 4; q++) used |= (qs[q] <= ce && qe[q] >= cs);
+        if (!used) continue;
+
+        for (int32_t cx = cs; cx <= ce; cx++) {
+          uint32_t hyp = (r - cx) * (r - cx) + dy2;
+          aBuf[cx - cs] = z ? sqrt_fraction(hyp) : ~sqrt_fraction(hyp);
         }
-        if (slope <= endSlope[3] && slope >= startSlope[3]) { // slope lo -> hi
-          xst[3] = cx; // Top right line start
-          len[3]++;
+
+        // Draw the runs inside each quadrant, skipping low alpha pixels
+        for (uint8_t q = 0; q < 4; q++) {
+          int32_t ps = (qs[q] > cs) ? qs[q] : cs;
+          int32_t pe = (qe[q] < ce) ? qe[q] : ce;
+          while (ps <= pe) {
+            while ((ps <= pe) && (aBuf[ps - cs] < 16)) ps++;
+            int32_t px = ps;
+            while ((px <= pe) && (aBuf[px - cs] >= 16)) px++;
+            if (px > ps) drawArcAlpha(x, y, r, cy, px - 1, q, aBuf + ps - cs, px - ps, fg_color, bg_color);
+            ps = px;
+          }
         }
-        continue; // Next x
       }
-      else {
-        if (hyp <= r4) break;  // Skip inner pixels
-        alpha = sqrt_fraction(hyp); // Inner AA zone
-      }
-
-      if (alpha < 16) continue;  // Skip low alpha pixels
-
-      // If background is read it must be done in each quadrant
-      uint16_t pcol = fastBlend(alpha, fg_color, bg_color);
-      // Check if an AA pixels need to be drawn
-      slope = ((r - cy)<<16)/(r - cx);
-      if (slope <= startSlope[0] && slope >= endSlope[0]) // BL
-        drawPixel(x + cx - r, y - cy + r, pcol);
-      if (slope >= startSlope[1] && slope <= endSlope[1]) // TL
-        drawPixel(x + cx - r, y + cy - r, pcol);
-      if (slope <= startSlope[2] && slope >= endSlope[2]) // TR
-        drawPixel(x - cx + r, y + cy - r, pcol);
-      if (slope <= endSlope[3] && slope >= startSlope[3]) // BR
-        drawPixel(x - cx + r, y - cy + r, pcol);
     }
+
     // Add line in inner zone
-    if (len[0]) drawFastHLine(x + xst[0] - len[0] + 1 - r, y - cy + r, len[0], fg_color); // BL
-    if (len[1]) drawFastHLine(x + xst[1] - len[1] + 1 - r, y + cy - r, len[1], fg_color); // TL
-    if (len[2]) drawFastHLine(x - xst[2] + r, y + cy - r, len[2], fg_color); // TR
-    if (len[3]) drawFastHLine(x - xst[3] + r, y - cy + r, len[3], fg_color); // BR
+    int32_t ls[4], len[4];
+    for (uint8_t q = 0; q < 4; q++) {
+      ls[q]  = (qs[q] > xo) ? qs[q] : xo;
+      len[q] = ((qe[q] < xi - 1) ? qe[q] : xi - 1) - ls[q] + 1;
+    }
+    if (len[0] > 0) drawFastHLine(x + ls[0] - r, y - cy + r, len[0], fg_color); // BL
+    if (len[1] > 0) drawFastHLine(x + ls[1] - r, y + cy - r, len[1], fg_color); // TL
+    if (len[2] > 0) drawFastHLine(x - ls[2] - len[2] + 1 + r, y + cy - r, len[2], fg_color); // TR
+    if (len[3] > 0) drawFastHLine(x - ls[3] - len[3] + 1 + r, y - cy + r, len[3], fg_color); // BR
   }
 
   // Fill in centre lines
@@ -4274,6 +5625,23 @@ void TFT_eSPI::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
   end_tft_write();
 }
 
+/***************************************************************************************
+** Function name:           drawArcAlpha (private function)
+** Description:             Draw a run of arc AA pixels in one quadrant
+***************************************************************************************/
+// cx is the quadrant scan position of the last pixel in the run, alpha holds the run
+// alpha values in scan order so the right hand quadrants are drawn reversed
+void TFT_eSPI::drawArcAlpha(int32_t x, int32_t y, int32_t r, int32_t cy, int32_t cx, uint8_t q, const uint8_t *alpha, int32_t len, uint32_t fg_color, uint32_t bg_color)
+{
+  // The background colour is not read, 0x00FFFFFF blends with white as before
+  bg_color = (uint16_t)bg_color;
+
+  int32_t yp = (q == 1 || q == 2) ? y + cy - r : y - cy + r;
+
+  if (q < 2) drawAlphaSpan(x + cx - len + 1 - r, yp, alpha, len, fg_color, bg_color);
+  else       drawAlphaSpan(x - cx + r, yp, alpha, len, fg_color, bg_color, true);
+}
+
 /***************************************************************************************
 ** Function name:           drawSmoothCircle
 ** Description:             Draw a smooth circle
@@ -4281,6 +5649,8 @@ void TFT_eSPI::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
 // To have effective anti-aliasing the circle will be 3 pixels thick
 void TFT_eSPI::drawSmoothCircle(int32_t x, int32_t y, int32_t r, uint32_t fg_color, uint32_t bg_color)
 {
+  BUS_STAT_SCOPE(STAT_SMOOTH_CIRCLE);
+
   drawSmoothRoundRect(x-r, y-r, r, r-1, 0, 0, fg_color, bg_color);
 }
 
@@ -4292,6 +5662,8 @@ void TFT_eSPI::fillSmoothCircle(int32_t x, int32_t y, int32_t r, uint32_t color,
 {
   if (r <= 0) return;
 
+  BUS_STAT_SCOPE(STAT_SMOOTH_CIRCLE);
+
   inTransaction = true;
 
   drawFastHLine(x - r, y, 2 * r + 1, color);
@@ -4302,6 +5674,10 @@ void TFT_eSPI::fillSmoothCircle(int32_t x, int32_t y, int32_t r, uint32_t color,
   r++;
   int32_t r2 = r * r;
   
+  // Edge pixel alpha values for a line, drawn in blocks with drawAlphaSpan()
+  uint8_t aBuf[32];
+  int32_t an = 0;
+
   for (int32_t cy = r - 1; cy > 0; cy--)
   {
     int32_t dy2 = (r - cy) * (r - cy);
@@ -4316,19 +5692,25 @@ void TFT_eSPI::fillSmoothCircle(int32_t x, int32_t y, int32_t r, uint32_t color,
       xs = cx;
       if (alpha < 9) continue;
 
-      if (bg_color == 0x00FFFFFF) {
-        drawPixel(x + cx - r, y + cy - r, color, alpha, bg_color);
-        drawPixel(x - cx + r, y + cy - r, color, alpha, bg_color);
-        drawPixel(x - cx + r, y - cy + r, color, alpha, bg_color);
-        drawPixel(x + cx - r, y - cy + r, color, alpha, bg_color);
-      }
-      else {
-        uint16_t pcol = drawPixel(x + cx - r, y + cy - r, color, alpha, bg_color);
-        drawPixel(x - cx + r, y + cy - r, pcol);
-        drawPixel(x - cx + r, y - cy + r, pcol);
-        drawPixel(x + cx - r, y - cy + r, pcol);
+      // Alpha rises towards the centre, so the edge pixels of a line are contiguous
+      aBuf[an++] = alpha;
+      if (an == sizeof(aBuf)) {
+        int32_t ax = cx - an + 1;
+        drawAlphaSpan(x + ax - r, y + cy - r, aBuf, an, color, bg_color);
+        drawAlphaSpan(x - cx + r, y + cy - r, aBuf, an, color, bg_color, true);
+        drawAlphaSpan(x - cx + r, y - cy + r, aBuf, an, color, bg_color, true);
+        drawAlphaSpan(x + ax - r, y - cy + r, aBuf, an, color, bg_color);
+        an = 0;
       }
     }
+    if (an) {
+      int32_t ax = cx - an;
+      drawAlphaSpan(x + ax - r, y + cy - r, aBuf, an, color, bg_color);
+      drawAlphaSpan(x - cx + 1 + r, y + cy - r, aBuf, an, color, bg_color, true);
+      drawAlphaSpan(x - cx + 1 + r, y - cy + r, aBuf, an, color, bg_color, true);
+      drawAlphaSpan(x + ax - r, y - cy + r, aBuf, an, color, bg_color);
+      an = 0;
+    }
     drawFastHLine(x + cx - r, y + cy - r, 2 * (r - cx) + 1, color);
     drawFastHLine(x + cx - r, y - cy + r, 2 * (r - cx) + 1, color);
   }
@@ -4354,6 +5736,9 @@ void TFT_eSPI::fillSmoothCircle(int32_t x, int32_t y, int32_t r, uint32_t color,
 void TFT_eSPI::drawSmoothRoundRect(int32_t x, int32_t y, int32_t r, int32_t ir, int32_t w, int32_t h, uint32_t fg_color, uint32_t bg_color, uint8_t quadrants)
 {
   if (_vpOoB) return;
+
+  BUS_STAT_SCOPE(STAT_SMOOTH_CIRCLE);
+
   if (r < ir) transpose(r, ir); // Required that r > ir
   if (r <= 0 || ir < 0) return; // Invalid
 
@@ -4446,6 +5831,8 @@ void TFT_eSPI::drawSmoothRoundRect(int32_t x, int32_t y, int32_t r, int32_t ir,
 ***************************************************************************************/
 void TFT_eSPI::fillSmoothRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color, uint32_t bg_color)
 {
+  BUS_STAT_SCOPE(STAT_SMOOTH_CIRCLE);
+
   inTransaction = true;
 
   int32_t xs = 0;
@@ -4501,6 +5888,8 @@ void TFT_eSPI::fillSmoothRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, i
 // Coordinates are floating point to achieve sub-pixel positioning
 void TFT_eSPI::drawSpot(float ax, float ay, float r, uint32_t fg_color, uint32_t bg_color)
 {
+  BUS_STAT_SCOPE(STAT_WEDGE_LINE);
+
   // Filled circle can be created by the wide line function with zero line length
   drawWedgeLine( ax, ay, ax, ay, r, r, fg_color, bg_color);
 }
@@ -4511,15 +5900,88 @@ void TFT_eSPI::drawSpot(float ax, float ay, float r, uint32_t fg_color, uint32_t
 ***************************************************************************************/
 void TFT_eSPI::drawWideLine(float ax, float ay, float bx, float by, float wd, uint32_t fg_color, uint32_t bg_color)
 {
+  BUS_STAT_SCOPE(STAT_WEDGE_LINE);
+
   drawWedgeLine( ax, ay, bx, by, wd/2.0, wd/2.0, fg_color, bg_color);
 }
 
+/***************************************************************************************
+** Description:  Fixed point wedge line description used by drawWedgeLine
+***************************************************************************************/
+typedef struct {
+  int32_t dux, dvx;   // Change in u and v for each pixel step in x
+  int32_t rowU, rowV; // u and v at x = 0 on the current pixel line
+  int32_t len;        // Line length
+  int64_t k;          // Radius change per unit length along the line, U16.16
+  int32_t ar8, dr8;   // Start radius + 0.5 and radius change, 1/256 pixel units
+} wedge_t;
+
+/***************************************************************************************
+** Function name:           isqrt32
+** Description:             integer square root
+***************************************************************************************/
+static uint32_t isqrt32(uint32_t num)
+{
+  uint32_t root = 0;
+  uint32_t bit  = 1UL << 30;
+
+  while (bit > num) bit >>= 2;
+
+  while (bit) {
+    if (num >= root + bit) {
+      num -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else root >>= 1;
+    bit >>= 2;
+  }
+
+  return root;
+}
+
+/***************************************************************************************
+** Function name:           wedgeCoverage - helper function for drawWedgeLine
+** Description:             returns coverage of pixel x on the current line
+***************************************************************************************/
+// Coverage is the wedge radius + 0.5 less the distance of the pixel from the line, in
+// 1/256 pixel units. Past the line ends the distance is to the end point, between the
+// ends it is across the line and the radius changes linearly
+static int32_t wedgeCoverage(const wedge_t *wl, int32_t x)
+{
+  int32_t u = wl->rowU + x * wl->dux;
+  int32_t v = wl->rowV + x * wl->dvx;
+  int32_t dist;
+
+  if (u > 0 && u < wl->len) {
+    dist = (abs(v) >> 8) + (int32_t)(((int64_t)u * wl->k) >> 24);
+  }
+  else {
+    bool end = (u > 0);
+    if (end) u -= wl->len;
+    uint32_t du = abs(u) >> 8;
+    uint32_t dv = abs(v) >> 8;
+    if ((du | dv) < 0x8000) dist = isqrt32(du * du + dv * dv);
+    else {
+      // Far from the end point, so reduce the precision to avoid overflow
+      du >>= 4; dv >>= 4;
+      if ((du | dv) < 0x8000) dist = isqrt32(du * du + dv * dv) << 4;
+      else return -1;
+    }
+    if (end) dist += wl->dr8;
+  }
+
+  return wl->ar8 - dist;
+}
+
+
 /***************************************************************************************
 ** Function name:           drawWedgeLine - background colour specified or pixel read
 ** Description:             draw an anti-aliased line with different width radiused ends
 ***************************************************************************************/
 void TFT_eSPI::drawWedgeLine(float ax, float ay, float bx, float by, float ar, float br, uint32_t fg_color, uint32_t bg_color)
 {
+  BUS_STAT_SCOPE(STAT_WEDGE_LINE);
+
   if ( (ar < 0.0) || (br < 0.0) )return;
   if ( (fabsf(ax - bx) < 0.01f) && (fabsf(ay - by) < 0.01f) ) bx += 0.01f;  // Avoid divide by zero
 
@@ -4531,93 +5993,92 @@ void TFT_eSPI::drawWedgeLine(float ax, float ay, float bx, float by, float ar, f
 
   if (!clipWindow(&x0, &y0, &x1, &y1)) return;
 
-  // Establish x start and y start
-  int32_t ys = ay;
-  if ((ax-ar)>(bx-br)) ys = by;
-
-  float rdt = ar - br; // Radius delta
-  float alpha = 1.0f;
-  ar += 0.5;
-
-  uint16_t bg = bg_color;
-  float xpax, ypay, bax = bx - ax, bay = by - ay;
+  float bax = bx - ax, bay = by - ay;
+  float len = sqrtf(bax * bax + bay * bay);
+  float ux = bax / len, uy = bay / len; // Unit vector along the line
+
+  // Pixel positions are converted to U16.16 fixed point distances along (u) and across (v)
+  // the line from the start point, these change by a constant for each pixel step. The
+  // origin is the datum so the result does not depend on where the viewport is
+  wedge_t wl;
+  wl.dux  = ux * 65536.0f;
+  wl.dvx  = -uy * 65536.0f;
+  int32_t duy = uy * 65536.0f;
+  int32_t dvy = ux * 65536.0f;
+  int32_t u0  = (-ax * ux - ay * uy) * 65536.0f;
+  int32_t v0  = ( ax * uy - ay * ux) * 65536.0f;
+  wl.len  = len * 65536.0f;
+  wl.k    = (int64_t)((ar - br) / len * 65536.0f);
+  wl.ar8  = (ar + 0.5f) * 256.0f;
+  wl.dr8  = (ar - br) * 256.0f;
+
+  // Alpha values for the anti-aliased pixels at each end of a line, a thin line can have a
+  // long run of them so they are drawn in blocks
+  uint8_t aL[AlphaSpanBlock];
+  uint8_t aR[AlphaSpanBlock];
 
   begin_nin_write();
   inTransaction = true;
 
-  int32_t xs = x0;
-  // Scan bounding box from ys down, calculate pixel intensity from distance to line
-  for (int32_t yp = ys; yp <= y1; yp++) {
-    bool swin = true;  // Flag to start new window area
-    bool endX = false; // Flag to skip pixels
-    ypay = yp - ay;
-    for (int32_t xp = xs; xp <= x1; xp++) {
-      if (endX) if (alpha <= LoAlphaTheshold) break;  // Skip right side
-      xpax = xp - ax;
-      alpha = ar - wedgeLineDistance(xpax, ypay, bax, bay, rdt);
-      if (alpha <= LoAlphaTheshold ) continue;
-      // Track edge to minimise calculations
-      if (!endX) { endX = true; xs = xp; }
-      if (alpha > HiAlphaTheshold) {
-        #ifdef GC9A01_DRIVER
-          drawPixel(xp, yp, fg_color);
-        #else
-          if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
-          pushColor(fg_color);
-        #endif
-        continue;
-      }
-      //Blend color with background and plot
-      if (bg_color == 0x00FFFFFF) {
-        bg = readPixel(xp, yp); swin = true;
-      }
-      #ifdef GC9A01_DRIVER
-        uint16_t pcol = fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg);
-        drawPixel(xp, yp, pcol);
-        swin = swin;
-      #else
-        if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
-        pushColor(fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg));
-      #endif
-    }
-  }
-
-  // Reset x start to left side of box
-  xs = x0;
-  // Scan bounding box from ys-1 up, calculate pixel intensity from distance to line
-  for (int32_t yp = ys-1; yp >= y0; yp--) {
-    bool swin = true;  // Flag to start new window area
-    bool endX = false; // Flag to skip pixels
-    ypay = yp - ay;
-    for (int32_t xp = xs; xp <= x1; xp++) {
-      if (endX) if (alpha <= LoAlphaTheshold) break;  // Skip right side of drawn line
-      xpax = xp - ax;
-      alpha = ar - wedgeLineDistance(xpax, ypay, bax, bay, rdt);
-      if (alpha <= LoAlphaTheshold ) continue;
-      // Track line boundary
-      if (!endX) { endX = true; xs = xp; }
-      if (alpha > HiAlphaTheshold) {
-        #ifdef GC9A01_DRIVER
-          drawPixel(xp, yp, fg_color);
-        #else
-          if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
-          pushColor(fg_color);
-        #endif
-        continue;
+  int32_t xl = 0, xr = -1; // Covered pixels on the last line, none if xl > xr
+
+  for (int32_t yp = y0; yp <= y1; yp++) {
+    // Bounding box is in screen coordinates, so step from the datum in integers
+    wl.rowU = u0 + (yp - _yDatum) * duy - _xDatum * wl.dux;
+    wl.rowV = v0 + (yp - _yDatum) * dvy - _xDatum * wl.dvx;
+
+    // Find a covered pixel, try the middle of the last line first
+    int32_t sx = (xl + xr) >> 1;
+    if ((xl > xr) || (wedgeCoverage(&wl, sx) <= LoCoverage)) {
+      // Start from the point on the line nearest this pixel line and move
+      // in the direction of increasing coverage
+      float h = (fabsf(bay) < 0.01f) ? 0.5f : fmaxf(fminf((yp - _yDatum - ay) / bay, 1.0f), 0.0f);
+      sx = ax + h * bax + _xDatum;
+      if (sx < x0) sx = x0;
+      if (sx > x1) sx = x1;
+      int32_t cv = wedgeCoverage(&wl, sx);
+      int8_t  dir = 0;
+      if ((sx > x0) && (wedgeCoverage(&wl, sx - 1) > cv)) dir = -1;
+      else if ((sx < x1) && (wedgeCoverage(&wl, sx + 1) > cv)) dir = 1;
+      while ((cv <= LoCoverage) && dir) {
+        int32_t nx = sx + dir;
+        if ((nx < x0) || (nx > x1)) break;
+        int32_t nc = wedgeCoverage(&wl, nx);
+        if (nc <= cv) break;
+        sx = nx; cv = nc;
       }
-      //Blend colour with background and plot
-      if (bg_color == 0x00FFFFFF) {
-        bg = readPixel(xp, yp); swin = true;
+      if (cv <= LoCoverage) {
+        if (xl <= xr) break; // The shape is convex so there are no more lines
+        continue;
       }
-      #ifdef GC9A01_DRIVER
-        uint16_t pcol = fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg);
-        drawPixel(xp, yp, pcol);
-        swin = swin;
-      #else
-        if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
-        pushColor(fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg));
-      #endif
     }
+
+    // Move the left and right edges of the last line to this line
+    int32_t l = (xl <= xr && xl < sx) ? xl : sx;
+    if (wedgeCoverage(&wl, l) > LoCoverage) { while ((l > x0) && (wedgeCoverage(&wl, l - 1) > LoCoverage)) l--; }
+    else do l++; while (wedgeCoverage(&wl, l) <= LoCoverage);
+
+    int32_t r = (xl <= xr && xr > sx) ? xr : sx;
+    if (wedgeCoverage(&wl, r) > LoCoverage) { while ((r < x1) && (wedgeCoverage(&wl, r + 1) > LoCoverage)) r++; }
+    else do r--; while (wedgeCoverage(&wl, r) <= LoCoverage);
+
+    xl = l;
+    xr = r;
+
+    // Only the edge pixels are blended, the pixels between them are fully covered
+    int32_t nl = 0, nr = 0, cv;
+    while ((l <= r) && ((cv = wedgeCoverage(&wl, l)) <= HiCoverage)) {
+      aL[nl++] = cv; l++;
+      if (nl == AlphaSpanBlock) { drawAlphaSpan(l - nl - _xDatum, yp - _yDatum, aL, nl, fg_color, bg_color); nl = 0; }
+    }
+    while ((r >= l) && ((cv = wedgeCoverage(&wl, r)) <= HiCoverage)) {
+      aR[nr++] = cv; r--;
+      if (nr == AlphaSpanBlock) { drawAlphaSpan(r + 1 - _xDatum, yp - _yDatum, aR, nr, fg_color, bg_color, true); nr = 0; }
+    }
+
+    if (nl) drawAlphaSpan(l - nl - _xDatum, yp - _yDatum, aL, nl, fg_color, bg_color);
+    if (l <= r) drawFastHLine(l - _xDatum, yp - _yDatum, r - l + 1, fg_color);
+    if (nr) drawAlphaSpan(r + 1 - _xDatum, yp - _yDatum, aR, nr, fg_color, bg_color, true);
   }
 
   inTransaction = lockTransaction;
@@ -4625,26 +6086,20 @@ void TFT_eSPI::drawWedgeLine(float ax, float ay, float bx, float by, float ar, f
 }
 
 
-/***************************************************************************************
-** Function name:           lineDistance - private helper function for drawWedgeLine
-** Description:             returns distance of px,py to closest part of a to b wedge
-***************************************************************************************/
-inline float TFT_eSPI::wedgeLineDistance(float xpax, float ypay, float bax, float bay, float dr)
-{
-  float h = fmaxf(fminf((xpax * bax + ypay * bay) / (bax * bax + bay * bay), 1.0f), 0.0f);
-  float dx = xpax - bax * h, dy = ypay - bay * h;
-  return sqrtf(dx * dx + dy * dy) + h * dr;
-}
-
-
 /***************************************************************************************
 ** Function name:           drawFastVLine
 ** Description:             draw a vertical line
 ***************************************************************************************/
 void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
 {
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord && dlRect(x, y, 1, h, color)) return;
+#endif
+
   if (_vpOoB) return;
 
+  BUS_STAT_SCOPE(STAT_FAST_LINE);
+
   x+= _xDatum;
   y+= _yDatum;
 
@@ -4661,7 +6116,7 @@ void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
 
   setWindow(x, y, x, y + h - 1);
 
-  pushBlock(color, h);
+  pushBlock(color, h); BUS_STAT_BLOCK(h);
 
   end_tft_write();
 }
@@ -4673,8 +6128,14 @@ void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
 ***************************************************************************************/
 void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
 {
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord && dlRect(x, y, w, 1, color)) return;
+#endif
+
   if (_vpOoB) return;
 
+  BUS_STAT_SCOPE(STAT_FAST_LINE);
+
   x+= _xDatum;
   y+= _yDatum;
 
@@ -4691,7 +6152,7 @@ void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
 
   setWindow(x, y, x + w - 1, y);
 
-  pushBlock(color, w);
+  pushBlock(color, w); BUS_STAT_BLOCK(w);
 
   end_tft_write();
 }
@@ -4703,8 +6164,14 @@ void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
 ***************************************************************************************/
 void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
 {
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord && dlRect(x, y, w, h, color)) return;
+#endif
+
   if (_vpOoB) return;
 
+  BUS_STAT_SCOPE(STAT_FILL_RECT);
+
   x+= _xDatum;
   y+= _yDatum;
 
@@ -4732,7 +6199,7 @@ void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t col
 
   setWindow(x, y, x + w - 1, y + h - 1);
 
-  pushBlock(color, w * h);
+  pushBlock(color, w * h); BUS_STAT_BLOCK(w * h);
 
   end_tft_write();
 }
@@ -4746,6 +6213,8 @@ void TFT_eSPI::fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, uin
 {
   if (_vpOoB) return;
 
+  BUS_STAT_SCOPE(STAT_GRADIENT);
+
   x+= _xDatum;
   y+= _yDatum;
 
@@ -4784,6 +6253,8 @@ void TFT_eSPI::fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, uin
 {
   if (_vpOoB) return;
 
+  BUS_STAT_SCOPE(STAT_GRADIENT);
+
   x+= _xDatum;
   y+= _yDatum;
 
@@ -4814,6 +6285,270 @@ void TFT_eSPI::fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, uin
 }
 
 
+/***************************************************************************************
+** Function name:           setGradientColors
+** Description:             expand the colour stops into the 256 entry gradient ramp
+***************************************************************************************/
+void TFT_eSPI::setGradientColors(tftGradient_t *g, const tftGradientStop_t *stop, uint8_t count)
+{
+  if (g == nullptr || stop == nullptr || count == 0) return;
+
+  uint8_t  s = 0;
+  uint16_t color;
+
+  for (int32_t pos = 0; pos < 256; pos++) {
+    while (s < count && stop[s].pos <= pos) s++;
+
+    if (s == 0) color = stop[0].color;                 // Before the first stop
+    else if (s == count) color = stop[count - 1].color; // After the last stop
+    else {
+      const tftGradientStop_t *a = stop + s - 1;
+      const tftGradientStop_t *b = stop + s;
+      uint8_t alpha = ((pos - a->pos) * 255 + ((b->pos - a->pos) >> 1)) / (b->pos - a->pos);
+      color = alphaBlend(alpha, b->color, a->color); // Stops at the same position give a step
+    }
+
+    g->ramp[pos] = (color >> 8) | (color << 8);
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           setLinearGradient
+** Description:             set up a linear gradient at any angle
+***************************************************************************************/
+void TFT_eSPI::setLinearGradient(tftGradient_t *g, float x0, float y0, float x1, float y1)
+{
+  if (g == nullptr) return;
+
+  float vx = x1 - x0;
+  float vy = y1 - y0;
+  float len2 = vx * vx + vy * vy;
+  if (len2 < 1.0f) len2 = 1.0f;
+
+  g->type = GRADIENT_LINEAR;
+  g->x  = x0;
+  g->y  = y0;
+  g->dx = 255.0f * vx / len2;
+  g->dy = 255.0f * vy / len2;
+}
+
+
+/***************************************************************************************
+** Function name:           setRadialGradient
+** Description:             set up a radial gradient
+***************************************************************************************/
+void TFT_eSPI::setRadialGradient(tftGradient_t *g, float x, float y, float r)
+{
+  if (g == nullptr) return;
+
+  if (r < 1.0f) r = 1.0f;
+
+  g->type = GRADIENT_RADIAL;
+  g->x  = x;
+  g->y  = y;
+  g->dx = 255.0f / r;
+  g->dy = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           setConicGradient
+** Description:             set up a conic (sweep) gradient
+***************************************************************************************/
+void TFT_eSPI::setConicGradient(tftGradient_t *g, float x, float y, float angle)
+{
+  if (g == nullptr) return;
+
+  // Angle 0 is at 6 o'clock as for drawArc(), which is 90 degrees from the +x axis
+  angle = fmodf(angle + 90.0f, 360.0f);
+  if (angle < 0) angle += 360.0f;
+
+  g->type = GRADIENT_CONIC;
+  g->x  = x;
+  g->y  = y;
+  g->dx = angle * (256.0f / 360.0f);
+  g->dy = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           gradientAngle - helper function for gradientSpan
+** Description:             angle of dx,dy clockwise from +x axis, 1/65536 turn units
+***************************************************************************************/
+// The arctangent of the octant is approximated by z*pi/4 + 0.273*z*(1-z), the error
+// is less than 0.004 radians which is 1/6 of a ramp step
+static uint32_t gradientAngle(int32_t dx, int32_t dy)
+{
+  uint32_t ax = dx < 0 ? -dx : dx;
+  uint32_t ay = dy < 0 ? -dy : dy;
+
+  if (ax == 0 && ay == 0) return 0;
+
+  // z is 0-4096 for 0-45 degrees. It is found in 64 bits only where the 32 bit shift
+  // would overflow, more than 4096 pixels from the centre
+  uint32_t a;
+  if (ax >= ay) {
+    uint32_t z = (ay < (1UL << 20)) ? (ay << 12) / ax : (uint32_t)(((uint64_t)ay << 12) / ax);
+    a = 2 * z + (((z * (4096 - z)) >> 8) * 2847 >> 16);
+  }
+  else {
+    uint32_t z = (ax < (1UL << 20)) ? (ax << 12) / ay : (uint32_t)(((uint64_t)ax << 12) / ay);
+    a = 16384 - 2 * z - (((z * (4096 - z)) >> 8) * 2847 >> 16);
+  }
+
+  if (dx < 0) a = 32768 - a;
+  if (dy < 0) a = 65536 - a;
+
+  return a;
+}
+
+
+/***************************************************************************************
+** Function name:           gradientSpan - helper function for fillRectGradient
+** Description:             generate len pixel colours of a gradient starting at x,y
+***************************************************************************************/
+// Coordinates are relative to the datum. Pixels outside the gradient (past the ends of
+// a linear gradient or the radius of a radial gradient) are found first and filled with
+// the end colours so that the span between can be stepped in fixed point without overflow
+static void gradientSpan(const tftGradient_t *g, uint16_t *buf, int32_t x, int32_t y, int32_t len)
+{
+  const uint16_t *ramp = g->ramp;
+  float px = x + 0.5f - g->x;
+  float py = y + 0.5f - g->y;
+
+  if (g->type == GRADIENT_CONIC) {
+    int32_t  dx  = (int32_t)floorf(px * 256.0f);
+    int32_t  dy  = (int32_t)floorf(py * 256.0f);
+    uint32_t ref = (uint32_t)(g->dx * 256.0f);
+    while (len--) {
+      *buf++ = ramp[((gradientAngle(dx, dy) - ref) & 0xFFFF) >> 8];
+      dx += 256;
+    }
+    return;
+  }
+
+  int32_t i0, i1; // Pixels i0 to i1-1 are within the gradient
+  float   u0, du; // Position of first pixel and position change per pixel
+  uint16_t left, right; // Colours either side
+
+  if (g->type == GRADIENT_LINEAR) {
+    u0 = px * g->dx + py * g->dy;
+    du = g->dx;
+    if (fabsf(du) < 1.0e-6f) {
+      uint16_t color = ramp[u0 <= 0 ? 0 : u0 >= 255 ? 255 : (uint8_t)(u0 + 0.5f)];
+      while (len--) *buf++ = color;
+      return;
+    }
+    float ia = (-0.5f - u0) / du;
+    float ib = (255.5f - u0) / du;
+    if (du > 0) { left = ramp[0];   right = ramp[255]; }
+    else { left = ramp[255]; right = ramp[0]; float t = ia; ia = ib; ib = t; }
+    i0 = ia <= 0 ? 0 : ia >= len ? len : (int32_t)ceilf(ia);
+    i1 = ib <= 0 ? 0 : ib >= len ? len : (int32_t)ceilf(ib);
+  }
+  else { // GRADIENT_RADIAL
+    float v = py * g->dx;
+    left = right = ramp[255];
+    u0 = px * g->dx;
+    du = g->dx;
+    if (fabsf(v) >= 255.5f) { i0 = i1 = len; }
+    else {
+      float hc = sqrtf(255.5f * 255.5f - v * v);
+      float ia = (-hc - u0) / du;
+      float ib = ( hc - u0) / du;
+      i0 = ia <= 0 ? 0 : ia >= len ? len : (int32_t)ceilf(ia);
+      i1 = ib <= 0 ? 0 : ib >= len ? len : (int32_t)ceilf(ib);
+    }
+  }
+
+  int32_t i = 0;
+  while (i < i0) { *buf++ = left; i++; }
+
+  if (i < i1) {
+    // Position in 16.16 fixed point, at most 256 from the gradient start or centre
+    int32_t u = (int32_t)((u0 + i * du) * 65536.0f);
+    int32_t s = (int32_t)(du * 65536.0f);
+
+    if (g->type == GRADIENT_LINEAR) {
+      while (i < i1) {
+        int32_t k = (u + 0x8000) >> 16;
+        *buf++ = ramp[k < 0 ? 0 : k > 255 ? 255 : k];
+        u += s; i++;
+      }
+    }
+    else {
+      // Distance squared in 1/128 units is compared with the rounding thresholds
+      // (k +/- 0.5)^2 of the current ramp index k, which changes by small steps
+      int32_t  v  = (int32_t)(py * g->dx * 128.0f);
+      uint32_t v2 = v * v;
+      int32_t  uc = u >> 9;
+      uint32_t k  = (isqrt32(uc * uc + v2) + 64) >> 7;
+      if (k > 255) k = 255;
+      uint32_t lo = k ? (2 * k - 1) * (2 * k - 1) << 12 : 0;
+      uint32_t hi = (2 * k + 1) * (2 * k + 1) << 12;
+      while (i < i1) {
+        uc = u >> 9;
+        uint32_t d2 = uc * uc + v2;
+        while (k < 255 && d2 >= hi) { k++; lo = hi; hi = (2 * k + 1) * (2 * k + 1) << 12; }
+        while (k > 0 && d2 < lo) { k--; hi = lo; lo = k ? (2 * k - 1) * (2 * k - 1) << 12 : 0; }
+        *buf++ = ramp[k];
+        u += s; i++;
+      }
+    }
+  }
+
+  while (i < len) { *buf++ = right; i++; }
+}
+
+
+/***************************************************************************************
+** Function name:           fillRectGradient
+** Description:             fill a rectangle with a linear, radial or conic gradient
+***************************************************************************************/
+void TFT_eSPI::fillRectGradient(int32_t x, int32_t y, int32_t w, int32_t h, const tftGradient_t *g)
+{
+  if (_vpOoB || g == nullptr) return;
+
+  BUS_STAT_SCOPE(STAT_GRADIENT);
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  uint16_t lineBuf[w];
+
+  // A linear gradient with no vertical change has the same colours on every row
+  bool same = (g->type == GRADIENT_LINEAR) && (g->dy == 0);
+
+  // The ramp is in TFT byte order so the pixels must not be swapped
+  bool swap = _swapBytes; _swapBytes = false;
+
+  begin_tft_write();
+
+  setWindow(x, y, x + w - 1, y + h - 1);
+
+  for (int32_t yp = 0; yp < h; yp++) {
+    if (yp == 0 || !same) gradientSpan(g, lineBuf, x - _xDatum, y + yp - _yDatum, w);
+    pushPixels(lineBuf, w); BUS_STAT_PIXELS(w);
+  }
+
+  end_tft_write();
+
+  _swapBytes = swap;
+}
+
+
 /***************************************************************************************
 ** Function name:           color565
 ** Description:             convert three 8-bit RGB levels to a 16-bit colour value
@@ -4877,6 +6612,203 @@ uint32_t TFT_eSPI::color24to16(uint32_t color888)
   return (r | g | b);
 }
 
+/***************************************************************************************
+** Function name:           swap16x2
+** Description:             swap the bytes of two 16-bit colours packed in 32 bits
+***************************************************************************************/
+static inline uint32_t swap16x2(uint32_t w)
+{
+  return ((w >> 8) & 0x00FF00FF) | ((w << 8) & 0xFF00FF00);
+}
+
+/***************************************************************************************
+** Function name:           loadLE32, storeLE32
+** Description:             read or write 4 bytes as a little endian 32-bit word
+***************************************************************************************/
+// Byte access keeps strict aliasing and works on any endianness, compilers combine the
+// bytes into one word access where the processor allows it
+static inline uint32_t loadLE32(const uint8_t *p)
+{
+  return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void storeLE32(uint8_t *p, uint32_t w)
+{
+  p[0] = w; p[1] = w >> 8; p[2] = w >> 16; p[3] = w >> 24;
+}
+
+/***************************************************************************************
+** Function name:           color24to16
+** Description:             convert a span of 24-bit RGB bytes to 16-bit 565 colours
+***************************************************************************************/
+void TFT_eSPI::color24to16(const uint8_t *rgb888, uint16_t *rgb565, uint32_t len, bool swap)
+{
+  // Convert single pixels until the source is word aligned
+  while (len && ((uintptr_t)rgb888 & 3)) {
+    uint16_t c = ((rgb888[0] & 0xF8) << 8) | ((rgb888[1] & 0xFC) << 3) | (rgb888[2] >> 3);
+    *rgb565++ = swap ? (c >> 8) | (c << 8) : c;
+    rgb888 += 3;
+    len--;
+  }
+
+  // Four pixels are read as three little endian 32-bit words:
+  // w0 = R1 B0 G0 R0, w1 = G2 R2 B1 G1, w2 = B3 G3 R3 B2 (MS byte first)
+  while (len >= 4) {
+    uint32_t w0 = loadLE32(rgb888);
+    uint32_t w1 = loadLE32(rgb888 + 4);
+    uint32_t w2 = loadLE32(rgb888 + 8);
+    rgb888 += 12;
+
+    // Two pixels are packed into each 32-bit result
+    uint32_t p01 = ((w0 <<  8) & 0x0000F800) | ((w0 >>  5) & 0x000007E0) | ((w0 >> 19) & 0x0000001F) |
+                   ( w0        & 0xF8000000) | ((w1 << 19) & 0x07E00000) | ((w1 <<  5) & 0x001F0000);
+    uint32_t p23 = ((w1 >>  8) & 0x0000F800) | ((w1 >> 21) & 0x000007E0) | ((w2 >>  3) & 0x0000001F) |
+                   ((w2 << 16) & 0xF8000000) | ((w2 <<  3) & 0x07E00000) | ((w2 >> 11) & 0x001F0000);
+
+    if (swap) { p01 = swap16x2(p01); p23 = swap16x2(p23); }
+
+    rgb565[0] = p01; rgb565[1] = p01 >> 16;
+    rgb565[2] = p23; rgb565[3] = p23 >> 16;
+    rgb565 += 4;
+    len -= 4;
+  }
+
+  while (len--) {
+    uint16_t c = ((rgb888[0] & 0xF8) << 8) | ((rgb888[1] & 0xFC) << 3) | (rgb888[2] >> 3);
+    *rgb565++ = swap ? (c >> 8) | (c << 8) : c;
+    rgb888 += 3;
+  }
+}
+
+/***************************************************************************************
+** Function name:           color16toRGB
+** Description:             convert a span of 16-bit colours to 3 bytes per pixel
+***************************************************************************************/
+// If full is true the colour bits are repeated to fill each byte (24-bit colour),
+// otherwise the low bits are left clear (18-bit colour)
+static void color16toRGB(const uint16_t *rgb565, uint8_t *rgb, uint32_t len, bool swap, bool full)
+{
+  // Mask for the bits repeated in the low bits of each colour byte
+  uint32_t rbx = full ? 0x00070007 : 0;
+  uint32_t gx  = full ? 0x00030003 : 0;
+
+  // Convert single pixels until the destination is word aligned
+  while (len && ((uintptr_t)rgb & 3)) {
+    uint16_t c = swap ? (*rgb565 >> 8) | (*rgb565 << 8) : *rgb565;
+    uint8_t r = (c >> 8) & 0xF8; r |= (r >> 5) & rbx;
+    uint8_t g = (c >> 3) & 0xFC; g |= (g >> 6) & gx;
+    uint8_t b = (c << 3) & 0xF8; b |= (b >> 5) & rbx;
+    rgb[0] = r; rgb[1] = g; rgb[2] = b;
+    rgb565++;
+    rgb += 3;
+    len--;
+  }
+
+  // Four pixels are written as three 32-bit words, colours of two pixels are
+  // extracted together in the LS byte of each 16-bit half
+  while (len >= 4) {
+    uint32_t p01 = rgb565[0] | (uint32_t)rgb565[1] << 16;
+    uint32_t p23 = rgb565[2] | (uint32_t)rgb565[3] << 16;
+    rgb565 += 4;
+
+    if (swap) { p01 = swap16x2(p01); p23 = swap16x2(p23); }
+
+    uint32_t r01 = (p01 >> 8) & 0x00F800F8; r01 |= (r01 >> 5) & rbx;
+    uint32_t g01 = (p01 >> 3) & 0x00FC00FC; g01 |= (g01 >> 6) & gx;
+    uint32_t b01 = (p01 << 3) & 0x00F800F8; b01 |= (b01 >> 5) & rbx;
+    uint32_t r23 = (p23 >> 8) & 0x00F800F8; r23 |= (r23 >> 5) & rbx;
+    uint32_t g23 = (p23 >> 3) & 0x00FC00FC; g23 |= (g23 >> 6) & gx;
+    uint32_t b23 = (p23 << 3) & 0x00F800F8; b23 |= (b23 >> 5) & rbx;
+
+    // Little endian byte order R0 G0 B0 R1, G1 B1 R2 G2, B2 R3 G3 B3
+    storeLE32(rgb,     (r01 & 0xFF) | ((g01 & 0xFF) << 8) | ((b01 & 0xFF) << 16) | ((r01 << 8) & 0xFF000000));
+    storeLE32(rgb + 4, (g01 >> 16) | ((b01 >> 8) & 0xFF00) | ((r23 & 0xFF) << 16) | ((g23 & 0xFF) << 24));
+    storeLE32(rgb + 8, (b23 & 0xFF) | ((r23 >> 8) & 0xFF00) | (g23 & 0x00FF0000) | ((b23 << 8) & 0xFF000000));
+    rgb += 12;
+    len -= 4;
+  }
+
+  while (len--) {
+    uint16_t c = swap ? (*rgb565 >> 8) | (*rgb565 << 8) : *rgb565;
+    uint8_t r = (c >> 8) & 0xF8; r |= (r >> 5) & rbx;
+    uint8_t g = (c >> 3) & 0xFC; g |= (g >> 6) & gx;
+    uint8_t b = (c << 3) & 0xF8; b |= (b >> 5) & rbx;
+    rgb[0] = r; rgb[1] = g; rgb[2] = b;
+    rgb565++;
+    rgb += 3;
+  }
+}
+
+/***************************************************************************************
+** Function name:           color16to24
+** Description:             convert a span of 16-bit colours to 24-bit RGB bytes
+***************************************************************************************/
+void TFT_eSPI::color16to24(const uint16_t *rgb565, uint8_t *rgb888, uint32_t len, bool swap)
+{
+  color16toRGB(rgb565, rgb888, len, swap, true);
+}
+
+/***************************************************************************************
+** Function name:           color16to18
+** Description:             convert a span of 16-bit colours to 18-bit RGB bytes
+***************************************************************************************/
+void TFT_eSPI::color16to18(const uint16_t *rgb565, uint8_t *rgb666, uint32_t len, bool swap)
+{
+  color16toRGB(rgb565, rgb666, len, swap, false);
+}
+
+/***************************************************************************************
+** Function name:           color8to16
+** Description:             convert a span of 8-bit 332 colours to 16-bit 565 colours
+***************************************************************************************/
+void TFT_eSPI::color8to16(const uint8_t *rgb332, uint16_t *rgb565, uint32_t len, bool swap)
+{
+  // Two pixels are converted together, one in each 16-bit half of a 32-bit word
+  while (len) {
+    uint32_t c = rgb332[0];
+    if (len > 1) c |= (uint32_t)rgb332[1] << 16;
+
+    //           ===============Red==============
+    uint32_t p = (c & 0x00E000E0) << 8 | (c & 0x00C000C0) << 5;
+    //           =====Green=====       =====Green=====
+    p |= (c & 0x001C001C) << 6 | (c & 0x001C001C) << 3;
+    // Blue 2 to 5 bits, same as the 0, 11, 21, 31 table used by color8to16(color)
+    uint32_t b = c & 0x00030003;
+    p |= (b << 3) + (b << 1) + ((b | b >> 1) & 0x00010001);
+
+    if (swap) p = swap16x2(p);
+
+    *rgb565++ = p;
+    if (len == 1) break;
+    *rgb565++ = p >> 16;
+    rgb332 += 2;
+    len -= 2;
+  }
+}
+
+/***************************************************************************************
+** Function name:           color16to8
+** Description:             convert a span of 16-bit 565 colours to 8-bit 332 colours
+***************************************************************************************/
+void TFT_eSPI::color16to8(const uint16_t *rgb565, uint8_t *rgb332, uint32_t len, bool swap)
+{
+  // Two pixels are converted together, one in each 16-bit half of a 32-bit word
+  while (len) {
+    uint32_t c = rgb565[0];
+    if (len > 1) c |= (uint32_t)rgb565[1] << 16;
+
+    if (swap) c = swap16x2(c);
+
+    uint32_t p = ((c & 0xE000E000) >> 8) | ((c & 0x07000700) >> 6) | ((c & 0x00180018) >> 3);
+
+    *rgb332++ = p;
+    if (len == 1) break;
+    *rgb332++ = p >> 16;
+    rgb565 += 2;
+    len -= 2;
+  }
+}
+
 /***************************************************************************************
 ** Function name:           invertDisplay
 ** Description:             invert the display colours i = 1 invert, i = 0 normal
@@ -5077,6 +7009,68 @@ uint32_t TFT_eSPI::alphaBlend24(uint8_t alpha, uint32_t fgc, uint32_t bgc, uint8
   return (rxx & 0xFF0000) | (xgx & 0x00FF00) | (xxb & 0x0000FF);
 }
 
+/***************************************************************************************
+** Function name:           spread565 / blend565
+** Description:             Blend 565 colours with one multiply
+***************************************************************************************/
+// The green field is moved to the top half of a 32-bit word, leaving gaps between the
+// fields so a product with a 5-bit alpha (0-32) cannot overflow into the next field
+static inline uint32_t spread565(uint32_t c)
+{
+  return (c | c << 16) & 0x07E0F81F;
+}
+
+static inline uint16_t blend565(uint32_t fg, uint32_t bg, uint32_t a)
+{
+  bg = spread565(bg);
+  bg += (fg - bg) * a >> 5;
+  bg &= 0x07E0F81F;
+  return bg | bg >> 16;
+}
+
+/***************************************************************************************
+** Function name:           blendSpan
+** Description:             Blend a line of source pixels into a line of pixels
+***************************************************************************************/
+// Alpha 0 leaves dst unchanged, 255 copies src. Other alpha values are reduced to 5 bits
+void TFT_eSPI::blendSpan(uint16_t *dst, const uint16_t *src, const uint8_t *alpha, uint32_t len, bool swap)
+{
+  while (len--) {
+    uint32_t a = *alpha++;
+    if (a >= 252) *dst = *src;
+    else if (a > 3) {
+      uint16_t s = *src, d = *dst;
+      if (swap) { s = s >> 8 | s << 8; d = d >> 8 | d << 8; }
+      d = blend565(spread565(s), d, (a + 4) >> 3);
+      *dst = swap ? (d >> 8 | d << 8) : d;
+    }
+    src++;
+    dst++;
+  }
+}
+
+/***************************************************************************************
+** Function name:           blendSpanConst
+** Description:             Blend one colour into a line of pixels
+***************************************************************************************/
+void TFT_eSPI::blendSpanConst(uint16_t *dst, uint16_t color, const uint8_t *alpha, uint32_t len, bool swap)
+{
+  uint32_t fg = spread565(color);
+  if (swap) color = color >> 8 | color << 8;
+
+  while (len--) {
+    uint32_t a = *alpha++;
+    if (a >= 252) *dst = color;
+    else if (a > 3) {
+      uint16_t d = *dst;
+      if (swap) d = d >> 8 | d << 8;
+      d = blend565(fg, d, (a + 4) >> 3);
+      *dst = swap ? (d >> 8 | d << 8) : d;
+    }
+    dst++;
+  }
+}
+
 /***************************************************************************************
 ** Function name:           write
 ** Description:             draw characters piped through serial stream
@@ -5238,6 +7232,8 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
 {
   if (_vpOoB || !uniCode) return 0;
 
+  BUS_STAT_SCOPE(STAT_DRAW_CHAR);
+
   if (font==1) {
 #ifdef LOAD_GLCD
   #ifndef LOAD_GFXFF
@@ -5276,7 +7272,7 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
 
   int32_t width  = 0;
   int32_t height = 0;
-  uint32_t flash_address = 0;
+  uintptr_t flash_address = 0;
   uniCode -= 32;
 
 #ifdef LOAD_FONT2
@@ -5377,6 +7373,7 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
         }
         if (pX) {tft_Write_16(textbgcolor);}
       }
+      BUS_STAT_WRITE(width * height);
 
       end_tft_write();
     }
@@ -5427,6 +7424,7 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
               while (tnp--) {tft_Write_16(textcolor);}
             }
             else {tft_Write_16(textcolor);}
+            BUS_STAT_WRITE(np);
             px += textsize;
 
             if (px >= (xd + width * textsize)) {
@@ -5454,11 +7452,11 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
           if (line & 0x80) {
             line &= 0x7F;
             line++; w -= line;
-            pushBlock(textcolor,line);
+            pushBlock(textcolor,line); BUS_STAT_BLOCK(line);
           }
           else {
             line++; w -= line;
-            pushBlock(textbgcolor,line);
+            pushBlock(textbgcolor,line); BUS_STAT_BLOCK(line);
           }
         }
       }
@@ -5550,6 +7548,12 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
 {
   if (font > 8) return 0;
 
+#ifdef TFT_DISPLAY_LIST
+  if (_dlRecord && dlString(string, poX, poY, font)) return textWidth(string, font);
+#endif
+
+  BUS_STAT_SCOPE(STAT_DRAW_STRING);
+
   int16_t sumX = 0;
   uint8_t padding = 1, baseline = 0;
   uint16_t cwidth = textWidth(string, font); // Find the pixel width of the string in the font
@@ -5990,11 +7994,57 @@ void TFT_eSPI::setTextFont(uint8_t f)
 ** Function name:           getSPIinstance
 ** Description:             Get the instance of the SPI class
 ***************************************************************************************/
-#if !defined (TFT_PARALLEL_8_BIT) && !defined (RP2040_PIO_INTERFACE)
+#if !defined (TFT_PARALLEL_8_BIT) && !defined (RP2040_PIO_INTERFACE) && !defined (TFT_ESPI_HOST)
 SPIClass& TFT_eSPI::getSPIinstance(void)
 {
   return spi;
 }
+#elif defined (TFT_ESPI_HOST)
+/***************************************************************************************
+** Function name:           getPanelModel
+** Description:             Get the host TFT model (framebuffer and bus counters)
+***************************************************************************************/
+TFT_eSPI_HostPanel& TFT_eSPI::getPanelModel(void)
+{
+  return spi;
+}
+#endif
+
+
+#ifdef TFT_BUS_STATS
+/***************************************************************************************
+** Function name:           getBusStats
+** Description:             Get bus traffic counts for a drawing function, or all of them
+***************************************************************************************/
+tftBusStats_t TFT_eSPI::getBusStats(uint8_t id)
+{
+  if (id < STAT_PRIMITIVES) return _busStats[id];
+
+  tftBusStats_t sum;
+  memset(&sum, 0, sizeof(sum));
+
+  for (uint8_t i = 0; i < STAT_PRIMITIVES; i++) {
+    sum.calls     += _busStats[i].calls;
+    sum.commands  += _busStats[i].commands;
+    sum.dataBytes += _busStats[i].dataBytes;
+    sum.windows   += _busStats[i].windows;
+    sum.blocks    += _busStats[i].blocks;
+    sum.pixelRuns += _busStats[i].pixelRuns;
+    sum.reads     += _busStats[i].reads;
+  }
+
+  return sum;
+}
+
+/***************************************************************************************
+** Function name:           resetBusStats
+** Description:             Clear the bus traffic counts
+***************************************************************************************/
+void TFT_eSPI::resetBusStats(void)
+{
+  memset(_busStats, 0, sizeof(_busStats));
+  _busStat = STAT_NONE;
+}
 #endif
 
 
@@ -6188,10 +8238,14 @@ void TFT_eSPI::getSetup(setup_t &tft_settings)
   #include "Extensions/Touch.cpp"
 #endif
 
+#include "Extensions/Allocator.cpp"
+
 #include "Extensions/Button.cpp"
 
 #include "Extensions/Sprite.cpp"
 
+#include "Extensions/Path.cpp"
+
 #ifdef SMOOTH_FONT
   #include "Extensions/Smooth_font.cpp"
 #endif
@@ -6200,6 +8254,10 @@ void TFT_eSPI::getSetup(setup_t &tft_settings)
   #include "Extensions/AA_graphics.cpp"  // Loaded if SMOOTH_FONT is defined by user
 #endif
 
+#ifdef TFT_DISPLAY_LIST
+  #include "Extensions/Display_list.cpp"
+#endif
+
 #include "Touch_Drivers/Touch.cpp"
 
 #ifdef EPAPER_ENABLE
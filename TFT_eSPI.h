@@ -29,7 +29,7 @@
 // Standard support
 #include <Arduino.h>
 #include <Print.h>
-#if !defined(TFT_PARALLEL_8_BIT) && !defined(RP2040_PIO_INTERFACE)
+#if !defined(TFT_PARALLEL_8_BIT) && !defined(RP2040_PIO_INTERFACE) && !defined(TFT_ESPI_HOST)
 #include <SPI.h>
 #endif
 /***************************************************************************************
@@ -113,6 +113,8 @@
   #include "Processors/TFT_eSPI_nRF52840.h"
 #elif defined (EFR32MG24B220F1536IM48)
   #include "Processors/TFT_eSPI_MG24.h"
+#elif defined (TFT_ESPI_HOST)
+  #include "Processors/TFT_eSPI_Host.h"
 #else
 #include "Processors/TFT_eSPI_Generic.h"
 #define GENERIC_PROCESSOR
@@ -425,6 +427,42 @@ typedef struct
   int16_t tch_spi_freq; // Touch controller read/write SPI frequency
 } setup_t;
 
+#ifdef TFT_BUS_STATS
+// Bus traffic is charged to the drawing function that caused it, see getBusStats()
+// Only the outermost function is charged, e.g. drawString() rather than drawChar()
+#define STAT_NONE           0 // Sent outside a drawing function e.g. init(), writecommand()
+#define STAT_DRAW_PIXEL     1
+#define STAT_FAST_LINE      2 // drawFastHLine(), drawFastVLine()
+#define STAT_FILL_RECT      3 // fillRect(), fillScreen()
+#define STAT_DRAW_LINE      4
+#define STAT_PUSH_IMAGE     5 // pushImage(), pushRect(), pushMaskedImage(), pushImageScaled()
+#define STAT_PUSH_SPRITE    6 // TFT_eSprite::pushSprite()
+#define STAT_PUSH_ROTATED   7 // TFT_eSprite::pushRotated(), pushAffine()
+#define STAT_DRAW_CHAR      8 // drawChar(), print()
+#define STAT_DRAW_STRING    9 // drawString(), drawNumber(), drawFloat()
+#define STAT_DRAW_GLYPH    10 // Smooth font characters
+#define STAT_SMOOTH_ARC    11 // drawSmoothArc(), drawArc()
+#define STAT_SMOOTH_CIRCLE 12 // fillSmoothCircle(), drawSmoothCircle(), smooth round rectangles
+#define STAT_WEDGE_LINE    13 // drawWedgeLine(), drawWideLine(), drawSpot()
+#define STAT_GRADIENT      14 // fillRectVGradient(), fillRectHGradient(), fillRectGradient()
+#define STAT_READ_PIXEL    15 // readPixel(), readRect()
+#define STAT_POLYGON       16 // fillPolygon(), fillSmoothPolygon()
+#define STAT_MESH          17 // drawTriangleMesh()
+#define STAT_PRIMITIVES    18 // Number of entries above
+#define STAT_ALL         0xFF // getBusStats() returns the sum of all entries
+
+typedef struct
+{
+  uint32_t calls;     // Calls to the drawing function (outermost only)
+  uint32_t commands;  // Command bytes sent (DC low)
+  uint32_t dataBytes; // Data bytes sent, includes window coordinates and pixels
+  uint32_t windows;   // Address windows set by setWindow(), readAddrWindow() or drawPixel()
+  uint32_t blocks;    // pushBlock() calls i.e. solid colour runs
+  uint32_t pixelRuns; // pushPixels() calls i.e. image runs
+  uint32_t reads;     // Pixel read round trips, each turns the bus around
+} tftBusStats_t;
+#endif
+
 /***************************************************************************************
 **                         Section 8: Class member and support functions
 ***************************************************************************************/
@@ -432,10 +470,101 @@ typedef struct
 // Callback prototype for smooth font pixel colour read
 typedef uint16_t (*getColorCallback)(uint16_t x, uint16_t y);
 
+// Callback function to report the buffer of a finished DMA transfer
+typedef void (*dmaDoneCallback)(uint16_t *buffer);
+
+// DMA transfer block, a list of blocks is sent as one stream of pixels by pushListDMA()
+typedef struct {
+  uint16_t *data;  // Image pixels, nullptr for a solid colour fill
+  uint32_t  len;   // Number of pixels
+  uint16_t  color; // Fill colour, used if data is nullptr
+  uint8_t   flags; // DMA_BLOCK_xxx flags
+} tftDmaBlock_t;
+
+// Image data is in processor byte order and needs swapping, as for setSwapBytes(true)
+#define DMA_BLOCK_SWAP 0x01
+
+// Maximum number of corners for fillPolygon() and fillSmoothPolygon(), the edges are held
+// on the stack. Larger shapes can be drawn with a TFT_ePath, which uses the sketch buffer
+#ifndef POLYGON_CORNERS
+  #define POLYGON_CORNERS 32
+#endif
+
+// Polygon edge, coordinates are in 1/256 pixel units with the top end first (y0 < y1)
+typedef struct {
+  int32_t x0, y0; // Top end
+  int32_t x1, y1; // Bottom end
+  int32_t dxdy;   // Change in x per unit change in y, 16.16 fixed point
+  int8_t  dir;    // 1 if the edge runs downwards, -1 if upwards
+  uint8_t flags;  // Path segment flags, used by TFT_ePath only
+} tftPolyEdge_t;
+
+// Polygon filling work space, one entry is needed for each edge
+typedef struct {
+  int32_t  xc;     // Edge crossings of a pixel centre line, in x order
+  uint16_t order;  // Edge numbers in order of top end
+  uint16_t active; // Edge numbers of the edges on a pixel line
+  int8_t   dc;     // Direction of the edge at crossing xc
+} tftPolyWork_t;
+
+// Gradient colour stop, pos is the position along the gradient 0-255
+typedef struct {
+  uint8_t  pos;
+  uint16_t color;
+} tftGradientStop_t;
+
+#define GRADIENT_LINEAR 0
+#define GRADIENT_RADIAL 1
+#define GRADIENT_CONIC  2
+
+// Gradient fill, the colour stops are expanded to a ramp of 256 colours so each pixel only
+// needs a table look up
+typedef struct {
+  uint16_t ramp[256]; // Colour at each position, in TFT byte order
+  uint8_t  type;      // GRADIENT_LINEAR, GRADIENT_RADIAL or GRADIENT_CONIC
+  float    x, y;      // Start point or centre
+  float    dx, dy;    // Linear: position change per pixel in x and y, radial: 255/radius in dx
+                      // conic: start angle in dx, 1/256 turn units from the +x axis
+} tftGradient_t;
+
+// Triangle mesh vertex, x,y are in pixels and z is the depth (0 nearest) for the depth buffer
+typedef struct {
+  int16_t x, y;
+  uint8_t z;
+} tftMeshVertex_t;
+
+// drawTriangleMesh() mode flags
+#define MESH_FLAT     0x00 // One colour per triangle
+#define MESH_GOURAUD  0x01 // One colour per vertex, blended across the triangle
+#define MESH_CULL_CCW 0x02 // Triangles with anticlockwise corners on the screen are not drawn
+
+// pushImageScaled() modes
+#define SCALE_NEAREST  0 // Nearest image pixel
+#define SCALE_BILINEAR 1 // Blend of the 4 nearest image pixels
+
+// Batched drawing types, see drawPixels(), drawPolyline(), fillRects() and drawHLines()
+typedef struct {
+  int16_t x, y;
+} tftPoint_t;
+
+typedef struct {
+  int16_t x, y, w, h;
+} tftRect_t;
+
+typedef struct {
+  int16_t  x, y, w; // Left end and length
+  uint16_t color;
+} tftSpan_t;
+
+class TFT_eSprite; // Declared in Extensions/Sprite.h
+class TFT_ePath;   // Declared in Extensions/Path.h
+class TFT_eAllocator; // Declared in Extensions/Allocator.h
+
 // Class functions and variables
 class TFT_eSPI : public Print
 {
   friend class TFT_eSprite; // Sprite class has access to protected members
+  friend class TFT_ePath;   // Path class uses the polygon filling functions
 
   //--------------------------------------- public ------------------------------------//
 public:
@@ -529,6 +658,16 @@ public:
   void fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t color1, uint32_t color2);
   void fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t color1, uint32_t color2);
 
+           // Gradient fill with any number of colour stops. The tftGradient_t is set up once with
+           // setGradientColors() and one of the set...Gradient() functions and can then be used
+           // for any number of fills. Coordinates are relative to the datum, pixel x,y has its
+           // centre at x+0.5,y+0.5. Stops must be in order of position
+  void setGradientColors(tftGradient_t *g, const tftGradientStop_t *stop, uint8_t count);
+  void setLinearGradient(tftGradient_t *g, float x0, float y0, float x1, float y1); // Position 0 at x0,y0, 255 at x1,y1
+  void setRadialGradient(tftGradient_t *g, float x, float y, float r);    // Position 0 at x,y, 255 at radius r
+  void setConicGradient(tftGradient_t *g, float x, float y, float angle); // Position 0 at angle (0 = 6 o'clock), clockwise
+  virtual void fillRectGradient(int32_t x, int32_t y, int32_t w, int32_t h, const tftGradient_t *g); // Sprite overrides this
+
   void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color),
       drawCircleHelper(int32_t x, int32_t y, int32_t r, uint8_t cornername, uint32_t color),
       fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color),
@@ -541,10 +680,36 @@ public:
       drawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color),
       fillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color);
 
+  // Fill a polygon with n corners, xy_fixed holds n x,y pairs in 1/256 pixel units (24.8 fixed point)
+  // The edges may cross (non-zero winding rule) so concave and star shapes can be drawn in one call
+  // Nothing is drawn if n is more than POLYGON_CORNERS
+  void fillPolygon(const int32_t *xy_fixed, uint32_t n, uint32_t color);
+
+  // Draw count triangles, index holds 3 vertex numbers for each triangle. Pixel centres are at
+  // whole pixel coordinates and edges shared by triangles are drawn once (top-left fill rule).
+  // colors holds a colour per triangle (MESH_FLAT) or per vertex (MESH_GOURAUD). The optional
+  // depth buffer is an 8-bit Sprite the size of the TFT or Sprite being drawn, pixels are only
+  // drawn if z is less than or equal to the buffer value. Clear it with fillSprite(TFT_WHITE)
+  void drawTriangleMesh(const tftMeshVertex_t *vertex, const uint16_t *index, uint32_t count,
+                        const uint16_t *colors, uint8_t mode = MESH_FLAT, TFT_eSprite *depth = nullptr);
+
+  // Batched drawing, many pixels, lines or rectangles are drawn in one call and one transaction
+  // with the clip area found once. Pixels are sorted so the TFT window changes as little as
+  // possible, horizontal lines are sorted by row only so overlapping lines keep their order.
+  // These are virtual so the TFT_eSprite class can override them
+  virtual void drawPixels(const tftPoint_t *point, const uint16_t *colors, uint32_t n); // Pixel i is colors[i]
+  virtual void drawPolyline(const tftPoint_t *point, uint32_t n, uint32_t color);      // Lines joining n points
+  virtual void fillRects(const tftRect_t *rect, uint32_t n, uint32_t color);
+  virtual void drawHLines(const tftSpan_t *span, uint32_t n);                          // Lines with their own colour
+
   // Smooth (anti-aliased) graphics drawing
   // Draw a pixel blended with the background pixel colour (bg_color) specified,  return blended colour
   // If the bg_color is not specified, the background pixel colour will be read from TFT or sprite
   uint16_t drawPixel(int32_t x, int32_t y, uint32_t color, uint8_t alpha, uint32_t bg_color = 0x00FFFFFF);
+  // Draw a line of len pixels from x,y with the colour blended using one alpha value per pixel,
+  // the background is read from the TFT or sprite if bg_color is not specified. The alpha values
+  // are used right to left if reverse is true (for mirrored shapes)
+  void drawAlphaSpan(int32_t x, int32_t y, const uint8_t *alpha, int32_t len, uint32_t color, uint32_t bg_color = 0x00FFFFFF, bool reverse = false);
 
   // Draw an anti-aliased (smooth) arc between start and end angles. Arc ends are anti-aliased.
   // By default the arc is drawn with square ends unless the "roundEnds" parameter is included and set true
@@ -578,6 +743,10 @@ public:
   // If bg_color is not included the background pixel colour will be read from TFT or sprite
   void drawSpot(float ax, float ay, float r, uint32_t fg_color, uint32_t bg_color = 0x00FFFFFF);
 
+  // Anti-aliased version of fillPolygon(), edge pixels are blended using the area of the pixel covered
+  // If bg_color is not included the background pixel colour will be read from TFT or sprite
+  void fillSmoothPolygon(const int32_t *xy_fixed, uint32_t n, uint32_t color, uint32_t bg_color = 0x00FFFFFF);
+
   // Draw an anti-aliased wide line from ax,ay to bx,by width wd with radiused ends (radius is wd/2)
   // If bg_color is not included the background pixel colour will be read from TFT or sprite
   void drawWideLine(float ax, float ay, float bx, float by, float wd, uint32_t fg_color, uint32_t bg_color = 0x00FFFFFF);
@@ -617,6 +786,20 @@ public:
   void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data, uint16_t transparent);
   void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data);
 
+  // An image pushed repeatedly with the same transparent colour can have its opaque spans
+  // found once, pushImageSpans() then only sends those spans without testing each pixel.
+  // createSpanList() returns the list size in 16-bit words and fills the spans buffer if size
+  // is large enough, so call it with spans = nullptr first to size the buffer. The byte
+  // order setting from setSwapBytes() must be the same when the list is created and used
+  uint32_t createSpanList(int32_t w, int32_t h, const uint16_t *data, uint16_t transparent, uint16_t *spans, uint32_t size);
+  void pushImageSpans(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data, const uint16_t *spans);
+
+  // Render a 16-bit image of sw x sh pixels scaled to dw x dh pixels at x,y. The image may be in
+  // RAM or FLASH. SCALE_BILINEAR blends the 4 nearest image pixels for a smoother result.
+  // This is virtual so the TFT_eSprite class can override it
+  virtual void pushImageScaled(int32_t x, int32_t y, int32_t dw, int32_t dh, int32_t sw, int32_t sh,
+                               const uint16_t *data, uint8_t mode = SCALE_NEAREST);
+
   // These are used by Sprite class pushSprite() member function for 1, 4 and 8 bits per pixel (bpp) colours
   // They are not intended to be used with user sketches (but could be)
   // Set bpp8 true for 8bpp sprites, false otherwise. The cmap pointer must be specified for 4bpp
@@ -627,6 +810,9 @@ public:
 
   // Render a 16-bit colour image with a 1bpp mask
   void pushMaskedImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *img, uint8_t *mask);
+  // Render a 16-bit colour image with an 8-bit alpha mask (one byte per pixel), blended with the
+  // bg_color or with the TFT pixels if bg_color is not specified
+  void pushAlphaImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *img, const uint8_t *alpha, uint32_t bg_color = 0x00FFFFFF);
 
   // This next function has been used successfully to dump the TFT screen to a PC for documentation purposes
   // It reads a screen area and returns the 3 RGB 8-bit colour values of each pixel in the buffer
@@ -731,6 +917,17 @@ public:
   uint32_t color16to24(uint16_t color565);
   uint32_t color24to16(uint32_t color888);
 
+  // Convert spans of pixels, several pixels are packed into each 32-bit operation.
+  // 24 and 18-bit colours are 3 bytes per pixel in R, G, B order, as used by camera and
+  // image decoder output and 18-bit displays. Set swap for 16-bit colours in TFT byte order
+  // (e.g. a 16-bit Sprite or data for pushImage() with setSwapBytes(false))
+  void color24to16(const uint8_t *rgb888, uint16_t *rgb565, uint32_t len, bool swap = false);
+  void color16to24(const uint16_t *rgb565, uint8_t *rgb888, uint32_t len, bool swap = false);
+  void color8to16(const uint8_t *rgb332, uint16_t *rgb565, uint32_t len, bool swap = false);
+  void color16to8(const uint16_t *rgb565, uint8_t *rgb332, uint32_t len, bool swap = false);
+  // 18-bit colour has the 6 significant bits of each colour byte left justified
+  void color16to18(const uint16_t *rgb565, uint8_t *rgb666, uint32_t len, bool swap = false);
+
   // Alpha blend 2 colours, see generic "alphaBlend_Test" example
   // alpha =   0 = 100% background colour
   // alpha = 255 = 100% foreground colour
@@ -741,6 +938,14 @@ public:
   // 24-bit colour alphaBlend with optional alpha dither
   uint32_t alphaBlend24(uint8_t alpha, uint32_t fgc, uint32_t bgc, uint8_t dither = 0);
 
+  // Alpha blend lines of len 16-bit colours, each pixel has its own alpha value. blendSpan()
+  // blends src into dst and blendSpanConst() blends one colour into dst. These are faster
+  // than alphaBlend() but use 5-bit alpha precision, so a channel can differ by 1 LSB from
+  // the alphaBlend() result. Set swap true if the dst and src colours are in TFT byte order
+  // (e.g. 16-bit Sprite memory)
+  void blendSpan(uint16_t *dst, const uint16_t *src, const uint8_t *alpha, uint32_t len, bool swap = false);
+  void blendSpanConst(uint16_t *dst, uint16_t color, const uint8_t *alpha, uint32_t len, bool swap = false);
+
   // Direct Memory Access (DMA) support functions
   // These can be used for SPI writes when using the ESP32 (original) or STM32 processors.
   // DMA also works on a RP2040 processor with PIO based SPI and parallel (8 and 16-bit) interfaces
@@ -793,10 +998,37 @@ public:
   // Push a block of pixels into a window set up using setAddrWindow()
   void pushPixelsDMA(uint16_t *image, uint32_t len);
 
+  // Solid colour fills using DMA, these return before the fill is complete so use dmaBusy()
+  // or dmaWait() as for images. The colour is repeated from a small buffer so little RAM is used
+  void pushBlockDMA(uint16_t color, uint32_t len); // Fill a window set up using setAddrWindow()
+  void fillRectDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color); // Clipped to viewport
+
+  // Send a list of image and fill blocks to a window set up using setAddrWindow(), the blocks
+  // follow each other in the window. The list is queued behind any transfers in progress and
+  // this returns once it is queued, so the list and the image data must not change until
+  // dmaBusy() is false or the block is reported by the callback. The RP2040 DMA swaps bytes
+  // during the transfer, other processors byte swap DMA_BLOCK_SWAP images in place.
+  // pushPixelsDMA(), pushImageDMA() and pushBlockDMA() all send their pixels this way
+  void pushListDMA(const tftDmaBlock_t *list, uint32_t count);
+
   // Check if the DMA is complete - use while(tft.dmaBusy); for a blocking wait
   bool dmaBusy(void); // returns true if DMA is still in progress
   void dmaWait(void); // wait until DMA is complete
 
+  // The callback is called with the buffer of each image transfer once it is sent. The ESP32
+  // reports buffers from the DMA functions (dmaBusy(), dmaWait() etc), the STM32 and RP2040
+  // report them from the DMA interrupt so the callback must be short.
+  void setDMACallback(dmaDoneCallback callback) { dmaDone = callback; }
+  dmaDoneCallback getDMACallback(void) { return dmaDone; }
+
+#ifdef DMA_QUEUE_SIZE // ESP32 (original/S2) and STM32 only at the moment
+  // With DMA_QUEUE_SIZE defined as N in the setup file, up to N pushImageDMA() transfers can be
+  // in flight so the next block can be rendered while earlier ones are sent. Each transfer needs
+  // its own buffer (e.g. a ring of N line buffers) which must not be changed until it is reported
+  // by the callback.
+  uint8_t dmaQueueDepth(void); // Number of DMA transfers queued or in progress
+#endif
+
   bool DMA_Enabled = false; // Flag for DMA enabled state
   uint8_t spiBusyCheck = 0; // Number of ESP32 transfer buffers to check
 
@@ -817,13 +1049,27 @@ public:
   void setAttribute(uint8_t id = 0, uint8_t a = 0); // Set attribute value
   uint8_t getAttribute(uint8_t id = 0);             // Get attribute value
 
+  // Take Sprite memory, smooth font metrics and glyph buffers from alloc instead of the heap,
+  // nullptr restores the heap. Memory already allocated is released to the allocator it came
+  // from. Sprites created with this instance start with the same allocator
+  void setAllocator(TFT_eAllocator *alloc) { _allocator = alloc; }
+  TFT_eAllocator* getAllocator(void) { return _allocator; }
+
   // Used for diagnostic sketch to see library setup adopted by compiler, see Section 7 above
   void getSetup(setup_t &tft_settings); // Sketch provides the instance to populate
   bool verifySetupID(uint32_t id);
 
+#ifdef TFT_BUS_STATS
+  // Bus traffic counters, enabled by TFT_BUS_STATS in the setup file
+  tftBusStats_t getBusStats(uint8_t id = STAT_ALL); // Get counts for one STAT_xxx drawing function or all
+  void resetBusStats(void);                      // Clear all counts
+#endif
+
   // Global variables
-#if !defined(TFT_PARALLEL_8_BIT) && !defined(RP2040_PIO_INTERFACE)
+#if !defined(TFT_PARALLEL_8_BIT) && !defined(RP2040_PIO_INTERFACE) && !defined(TFT_ESPI_HOST)
   static SPIClass &getSPIinstance(void); // Get SPI class handle
+#elif defined(TFT_ESPI_HOST)
+  static TFT_eSPI_HostPanel &getPanelModel(void); // Get host TFT model for bus counters and framebuffer
 #endif
   uint32_t textcolor, textbgcolor; // Text foreground and background colours
 
@@ -878,8 +1124,20 @@ private:
   // Smooth graphics helper
   uint8_t sqrt_fraction(uint32_t num);
 
-  // Helper function: calculate distance of a point from a finite length line between two points
-  float wedgeLineDistance(float pax, float pay, float bax, float bay, float dr);
+  // Smooth arc helper, draws a run of anti-aliased pixels in one quadrant
+  void drawArcAlpha(int32_t x, int32_t y, int32_t r, int32_t cy, int32_t cx, uint8_t q, const uint8_t *alpha, int32_t len, uint32_t fg_color, uint32_t bg_color);
+
+  // Polygon helper, fills the area inside a list of edges, work has an entry for each edge
+  void fillEdges(const tftPolyEdge_t *edge, uint32_t count, tftPolyWork_t *work, uint32_t color, uint32_t bg_color, bool smooth);
+
+  // Read or draw a line of colours at a screen position that has been clipped. These are
+  // virtual so the TFT_eSprite class can access the Sprite memory directly
+  virtual void readSpan(int32_t xs, int32_t ys, uint16_t *color, int32_t len);
+  virtual void pushSpan(int32_t xs, int32_t ys, const uint16_t *color, int32_t len);
+
+  // Batched drawing helper, fill a rectangle clipped to the viewport. The caller opens the
+  // transaction, writes to the TFT only
+  void batchFill(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
 
   // Display variant settings
   uint8_t tabcolor,               // ST7735 screen protector "tab" colour (now invalid)
@@ -910,7 +1168,7 @@ protected:
 
   int32_t _init_width, _init_height; // Display w/h as input, used by setRotation()
   int32_t _width, _height;           // Display w/h as modified by current rotation
-  int32_t addr_row, addr_col;        // Window position - used to minimise window commands
+  uint32_t addr_row, addr_col;       // Window page and column ranges (start<<16 | end) - used to minimise window commands
 
   int16_t _xPivot; // TFT x pivot point coordinate for rotated Sprites
   int16_t _yPivot; // TFT x pivot point coordinate for rotated Sprites
@@ -944,10 +1202,18 @@ protected:
   bool _utf8;         // If set, use UTF-8 decoder in print stream 'write()' function (default ON)
   bool _psram_enable; // Enable PSRAM use for library functions (TBD) and Sprites
 
-  uint32_t _lastColor; // Buffered value of last colour used
+  TFT_eAllocator *_allocator = nullptr; // Memory for Sprites and fonts, nullptr for the heap
+
+  dmaDoneCallback dmaDone = nullptr; // Called with the buffer of each finished DMA transfer
 
   bool _fillbg; // Fill background flag (just for for smooth fonts at the moment)
 
+#ifdef TFT_BUS_STATS
+  friend class TFT_eSPI_BusStat; // Scope helper that sets _busStat
+  tftBusStats_t _busStats[STAT_PRIMITIVES]; // Bus traffic counts for each drawing function
+  uint8_t _busStat;                      // Drawing function currently being charged
+#endif
+
 #if defined(SSD1963_DRIVER)
   uint16_t Cswap;     // Swap buffer for SSD1963
   uint8_t r6, g6, b6; // RGB buffer for SSD1963
@@ -980,6 +1246,11 @@ protected:
 #include "Extensions/Smooth_font.h" // Loaded if SMOOTH_FONT is defined by user
 #endif
 
+// Load the display list extension
+#ifdef TFT_DISPLAY_LIST
+#include "Extensions/Display_list.h" // Loaded if TFT_DISPLAY_LIST is defined by user
+#endif
+
 #include "Touch_Drivers/Touch.h"
 
 }; // End of class TFT_eSPI
@@ -1012,12 +1283,18 @@ fastBlend(A alpha, F fgc, B bgc)
 /***************************************************************************************
 **                         Section 10: Additional extension classes
 ***************************************************************************************/
+// Load the memory allocator classes
+#include "Extensions/Allocator.h"
+
 // Load the Button Class
 #include "Extensions/Button.h"
 
 // Load the Sprite Class
 #include "Extensions/Sprite.h"
 
+// Load the vector Path Class
+#include "Extensions/Path.h"
+
 // Load the EPaper
 #ifdef EPAPER_ENABLE
 #include "Extensions/EPaper.h"
@@ -387,3 +387,16 @@
 // so changing it here has no effect
 
 // #define SUPPORT_TRANSACTIONS
+
+// Define TFT_BUS_STATS to count the commands, address windows and bytes sent to
+// the TFT by each drawing function, read the counts with getBusStats(). This
+// adds a little overhead to every function so leave it commented out normally.
+// #define TFT_BUS_STATS
+
+// Define TFT_DISPLAY_LIST to add startRecording() and flush(), these store drawing
+// calls in a sketch supplied buffer and then draw them in a single SPI transaction
+// #define TFT_DISPLAY_LIST
+
+// For ESP32 and STM32 define DMA_QUEUE_SIZE to allow more than one pushImageDMA()
+// transfer in flight, each transfer must use a different buffer
+// #define DMA_QUEUE_SIZE 4
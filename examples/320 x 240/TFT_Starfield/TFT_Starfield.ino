@@ -12,6 +12,11 @@ uint8_t sx[NSTARS] = {};
 uint8_t sy[NSTARS] = {};
 uint8_t sz[NSTARS] = {};
 
+// Each star erases its old pixel and draws a new one, all the pixels are
+// collected and sent to the TFT with one drawPixels() call per frame
+tftPoint_t  pixel[2 * NSTARS];
+uint16_t color[2 * NSTARS];
+
 uint8_t za, zb, zc, zx;
 
 // Fast 0-255 random number generator from http://eternityforest.com/Projects/rng.php:
@@ -45,6 +50,7 @@ void loop()
 {
   unsigned long t0 = micros();
   uint8_t spawnDepthVariation = 255;
+  uint32_t n = 0;
 
   for(int i = 0; i < NSTARS; ++i)
   {
@@ -59,8 +65,9 @@ void loop()
       int old_screen_x = ((int)sx[i] - 160) * 256 / sz[i] + 160;
       int old_screen_y = ((int)sy[i] - 120) * 256 / sz[i] + 120;
 
-      // This is a faster pixel drawing function for occasions where many single pixels must be drawn
-      tft.drawPixel(old_screen_x, old_screen_y,TFT_BLACK);
+      // Erase the old pixel
+      pixel[n] = { (int16_t)old_screen_x, (int16_t)old_screen_y };
+      color[n++] = TFT_BLACK;
 
       sz[i] -= 2;
       if (sz[i] > 1)
@@ -72,13 +79,18 @@ void loop()
         {
           uint8_t r, g, b;
           r = g = b = 255 - sz[i];
-          tft.drawPixel(screen_x, screen_y, tft.color565(r,g,b));
+          pixel[n] = { (int16_t)screen_x, (int16_t)screen_y };
+          color[n++] = tft.color565(r,g,b);
         }
         else
           sz[i] = 0; // Out of screen, die.
       }
     }
   }
+
+  // Pixels are drawn in the order they were added
+  tft.drawPixels(pixel, color, n);
+
   unsigned long t1 = micros();
   //static char timeMicros[8] = {};
 
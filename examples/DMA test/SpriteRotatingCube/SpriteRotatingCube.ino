@@ -86,9 +86,9 @@ float pz[] = {
 };
 
 // Define the triangles
-// The order of the vertices MUST be CCW or the
-// shoelace method won't work to detect visible edges
-int  faces[12][3] = {
+// The order of the vertices MUST be clockwise on the screen when facing
+// the viewer, triangles facing away are then culled by drawTriangleMesh()
+uint16_t faces[12][3] = {
   {0, 1, 4},
   {1, 5, 4},
   {1, 2, 5},
@@ -103,6 +103,9 @@ int  faces[12][3] = {
   {6, 3, 7}
 };
 
+// Colour of each triangle, two per cube face
+uint16_t faceColor[12];
+
 // mapped coordinates on screen
 float p2x[] = {
   0, 0, 0, 0, 0, 0, 0, 0
@@ -150,6 +153,9 @@ void setup() {
   spr[0].setColorDepth(COLOR_DEPTH);
   spr[1].setColorDepth(COLOR_DEPTH);
 
+  // Each cube face is made from two triangles
+  for (int i = 0; i < 12; i++) faceColor[i] = palette[i / 2];
+
   // Create the 2 sprites
   sprPtr[0] = (uint16_t*)spr[0].createSprite(IWIDTH, IHEIGHT);
   sprPtr[1] = (uint16_t*)spr[1].createSprite(IWIDTH, IHEIGHT);
@@ -258,16 +264,6 @@ void loop() {
   tft.endWrite();
 }
 
-/**
-  Detected visible triangles. If calculated area > 0 the triangle
-  is rendered facing towards the viewer, since the vertices are CCW.
-  If the area is negative the triangle is CW and thus facing away from us.
-*/
-int shoelace(int x1, int y1, int x2, int y2, int x3, int y3) {
-  // (x1y2 - y1x2) + (x2y3 - y2x3)
-  return x1 * y2 - y1 * x2 + x2 * y3 - y2 * x3 + x3 * y1 - y3 * x1;
-}
-
 /**
   Rotates and renders the cube.
 **/
@@ -305,45 +301,24 @@ void drawCube()
     p2y[i] = IHEIGHT / 2 + ay[i] * CUBE_SIZE / az[i];
   }
 
+  // Mesh vertices, and the limits used to keep the cube on the screen
+  tftMeshVertex_t v[8];
+  for (int i = 0; i < 8; i++) {
+    v[i].x = p2x[i];
+    v[i].y = p2y[i];
+    v[i].z = 0;
+
+    xmin = min(xmin, (int)v[i].x);
+    ymin = min(ymin, (int)v[i].y);
+    xmax = max(xmax, (int)v[i].x);
+    ymax = max(ymax, (int)v[i].y);
+  }
+
   // Fill the buffer with colour 0 (Black)
   spr[sprSel].fillSprite(TFT_BLACK);
 
-  for (int i = 0; i < 12; i++) {
-
-    if (shoelace(p2x[faces[i][0]], p2y[faces[i][0]], p2x[faces[i][1]], p2y[faces[i][1]], p2x[faces[i][2]], p2y[faces[i][2]]) > 0) {
-      int x0 = p2x[faces[i][0]];
-      int y0 = p2y[faces[i][0]];
-      int x1 = p2x[faces[i][1]];
-      int y1 = p2y[faces[i][1]];
-      int x2 = p2x[faces[i][2]];
-      int y2 = p2y[faces[i][2]];
-
-      xmin = min(xmin, x0);
-      ymin = min(ymin, y0);
-      xmin = min(xmin, x1);
-      ymin = min(ymin, y1);
-      xmin = min(xmin, x2);
-      ymin = min(ymin, y2);
-      xmax = max(xmax, x0);
-      ymax = max(ymax, y0);
-      xmax = max(xmax, x1);
-      ymax = max(ymax, y1);
-      xmax = max(xmax, x2);
-      ymax = max(ymax, y2);
-
-      spr[sprSel].fillTriangle(x0, y0, x1, y1, x2, y2, palette[i / 2]);
-      if (i % 2) {
-        int avX = 0;
-        int avY = 0;
-        for (int v = 0; v < 3; v++) {
-          avX += p2x[faces[i][v]];
-          avY += p2y[faces[i][v]];
-        }
-        avX = avX / 3;
-        avY = avY / 3;
-      }
-    }
-  }
+  // Draw the triangles that face the viewer
+  spr[sprSel].drawTriangleMesh(v, &faces[0][0], 12, faceColor, MESH_CULL_CCW);
 
   //spr[sprSel].drawString(fps, IWIDTH / 2, IHEIGHT / 2, 4);
   //delay(100);
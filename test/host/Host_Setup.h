@@ -0,0 +1,22 @@
+// Setup for the host build, passed to the compiler with -include as the
+// processor and setup must be known before TFT_eSPI.h is read
+
+#define USER_SETUP_LOADED
+
+#define ILI9341_DRIVER
+#define TFT_WIDTH  240
+#define TFT_HEIGHT 320
+
+#define LOAD_GLCD
+#define LOAD_FONT2
+#define LOAD_FONT4
+#define LOAD_FONT6
+#define LOAD_FONT7
+#define LOAD_FONT8
+#define LOAD_GFXFF
+#define SMOOTH_FONT
+
+#define SPI_FREQUENCY 40000000
+
+// There is no touch controller on the host
+#define DISABLE_ALL_LIBRARY_WARNINGS
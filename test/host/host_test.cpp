@@ -0,0 +1,1511 @@
+// Regression test for the host build, see the Makefile. The library draws to
+// the TFT model in Processors/TFT_eSPI_Host.c and the result is read back and
+// compared with a reference. Prints "ok" and returns 0 if all checks pass.
+
+#include <TFT_eSPI.h>
+#include <assert.h>
+
+#include "../../examples/Smooth Fonts/FLASH_Array/Smooth_font_reading_TFT/NotoSansBold15.h"
+
+static uint16_t swap16(uint16_t c)
+{
+  return (c >> 8) | (c << 8);
+}
+
+static uint16_t swapIf(bool swap, uint16_t c)
+{
+  return swap ? swap16(c) : c;
+}
+
+// Compare an area of the TFT with a reference, readRect() returns TFT byte order.
+// The model reads back 18-bit colour so the lowest green bit is not compared
+static void checkRect(TFT_eSPI &tft, int32_t x, int32_t y, int32_t w, int32_t h,
+                      const uint16_t *ref, const char *what)
+{
+  static uint16_t rb[240 * 320];
+  tft.readRect(x, y, w, h, rb);
+  for (int32_t i = 0; i < w * h; i++) {
+    uint16_t c = swap16(rb[i]);
+    if ((c & 0xFFDF) != (ref[i] & 0xFFDF)) {
+      fprintf(stderr, "%s: mismatch at %d,%d tft %04x ref %04x\n", what, x + i % w, y + i / w, c, ref[i]);
+      abort();
+    }
+  }
+}
+
+// As checkRect() but each colour channel may differ by up to tol, for blended pixels
+static void checkRectNear(TFT_eSPI &tft, int32_t x, int32_t y, int32_t w, int32_t h,
+                          const uint16_t *ref, int tol, const char *what)
+{
+  static uint16_t rb[240 * 320];
+  tft.readRect(x, y, w, h, rb);
+  for (int32_t i = 0; i < w * h; i++) {
+    uint16_t c = swap16(rb[i]);
+    if (abs((c >> 11) - (ref[i] >> 11)) > tol || abs(((c >> 6) & 0x1F) - ((ref[i] >> 6) & 0x1F)) > tol ||
+        abs((c & 0x1F) - (ref[i] & 0x1F)) > tol) {
+      fprintf(stderr, "%s: mismatch at %d,%d tft %04x ref %04x\n", what, x + i % w, y + i / w, c, ref[i]);
+      abort();
+    }
+  }
+}
+
+/***************************************************************************************
+** The TFT model: drawing and reading back in each rotation
+***************************************************************************************/
+static void testPanel(TFT_eSPI &tft)
+{
+  TFT_eSPI_HostPanel &p = TFT_eSPI::getPanelModel();
+
+  for (int r = 0; r < 4; r++) {
+    tft.setRotation(r);
+    tft.fillScreen(TFT_BLACK);
+    tft.fillRect(10, 20, 30, 40, TFT_RED);
+    tft.drawPixel(5, 6, TFT_GREEN);
+    assert(tft.readPixel(10, 20) == TFT_RED);
+    assert(tft.readPixel(39, 59) == TFT_RED);
+    assert(tft.readPixel(40, 59) == TFT_BLACK);
+    assert(tft.readPixel(5, 6) == TFT_GREEN);
+
+    uint16_t buf[4] = { 0x1234, 0xF81F, 0x07E0, 0xFFFF };
+    uint16_t rb[4];
+    tft.pushImage(100, 100, 2, 2, buf);
+    tft.readRect(100, 100, 2, 2, rb);
+    for (int i = 0; i < 4; i++) assert((rb[i] & 0xFFDF) == (buf[i] & 0xFFDF));
+  }
+
+  tft.setRotation(0);
+  TFT_eSprite spr(&tft);
+  spr.createSprite(50, 20);
+  spr.fillSprite(TFT_BLUE);
+  spr.drawString("Hi", 2, 2, 2);
+  spr.pushSprite(0, 0);
+  assert(p.getPixel(239, 0) == TFT_BLUE);
+  assert(tft.readPixel(0, 0) == TFT_BLUE);
+  spr.deleteSprite();
+}
+
+/***************************************************************************************
+** Bus statistics match the traffic seen by the TFT model
+***************************************************************************************/
+static void testBusStats(TFT_eSPI &tft)
+{
+#ifdef TFT_BUS_STATS
+  TFT_eSPI_HostPanel &p = TFT_eSPI::getPanelModel();
+
+  tft.setRotation(0);
+  tft.resetBusStats();
+  p.resetCounters();
+  tft.drawWedgeLine(10, 10, 200, 300, 5, 2, TFT_WHITE, TFT_BLACK);
+  tftBusStats_t b = tft.getBusStats(STAT_WEDGE_LINE);
+  assert(b.calls == 1);
+  assert(b.commands == p.counters.commands);
+  assert(b.dataBytes == p.counters.dataBytes);
+
+  TFT_eSprite spr(&tft);
+  spr.createSprite(50, 20);
+  spr.fillSprite(TFT_BLUE);
+  tft.resetBusStats();
+  p.resetCounters();
+  spr.pushSprite(3, 4);
+  b = tft.getBusStats(STAT_ALL);
+  assert(b.commands == p.counters.commands && b.dataBytes == p.counters.dataBytes);
+  spr.deleteSprite();
+
+  // Each pixel sets its own window, even if the window shadow skips CASET and PASET
+  tft.resetBusStats();
+  for (int i = 0; i < 10; i++) tft.drawPixel(i, 7, TFT_RED);
+  b = tft.getBusStats(STAT_DRAW_PIXEL);
+  assert(b.calls == 10 && b.windows == 10);
+#else
+  (void)tft;
+#endif
+}
+
+/***************************************************************************************
+** Random rectangles, pixels and lines match a reference in every rotation, so the
+** window shadow never skips a range that has changed
+***************************************************************************************/
+static void testWindowShadow(TFT_eSPI &tft)
+{
+  static uint16_t ref[240 * 320];
+
+  for (int r = 0; r < 4; r++) {
+    tft.setRotation(r);
+    int W = tft.width(), H = tft.height();
+    tft.fillScreen(0);
+    for (int i = 0; i < W * H; i++) ref[i] = 0;
+    srand(r + 1);
+    for (int n = 0; n < 3000; n++) {
+      int x = rand() % W, y = rand() % H, w = 1 + rand() % 20, h = 1 + rand() % 4;
+      uint16_t c = rand();
+      switch (rand() % 3) {
+        case 0:
+          tft.fillRect(x, y, w, h, c);
+          for (int j = y; j < y + h && j < H; j++) for (int i = x; i < x + w && i < W; i++) ref[j * W + i] = c;
+          break;
+        case 1:
+          tft.drawPixel(x, y, c);
+          ref[y * W + x] = c;
+          break;
+        case 2:
+          tft.drawFastHLine(x, y, w, c);
+          for (int i = x; i < x + w && i < W; i++) ref[y * W + i] = c;
+          break;
+      }
+    }
+    checkRect(tft, 0, 0, W, H, ref, "window shadow");
+  }
+  tft.setRotation(0);
+}
+
+/***************************************************************************************
+** A recorded and replayed display list draws the same as direct drawing
+***************************************************************************************/
+static void testDisplayList(TFT_eSPI &tft)
+{
+#ifdef TFT_DISPLAY_LIST
+  static uint16_t ref[240 * 320], rb[240 * 320];
+  static uint8_t arena[65536];
+  uint16_t img[6 * 5];
+  for (int i = 0; i < 30; i++) img[i] = i * 1234;
+
+  tft.setRotation(0);
+  int W = tft.width(), H = tft.height();
+  for (int pass = 0; pass < 2; pass++) {
+    tft.fillScreen(0);
+    if (pass) tft.startRecording(arena, sizeof(arena));
+    srand(7);
+    for (int n = 0; n < 800; n++) {
+      int x = rand() % W, y = rand() % H, w = 1 + rand() % 20, h = 1 + rand() % 4;
+      uint16_t c = rand() % 4 * 0x1111;
+      switch (rand() % 6) {
+        case 0: tft.fillRect(x, y, w, h, c); break;
+        case 1: tft.drawPixel(x, y, c); break;
+        case 2: tft.drawFastHLine(x, y, w, c); break;
+        case 3: tft.drawFastVLine(x, y, h, c); break;
+        case 4: tft.pushImage(x, y, 6, 5, img); break;
+        case 5:
+          tft.setTextColor(c, ~c);
+          tft.setTextDatum(rand() % 9);
+          tft.drawString("Ab1", x, y, 1 + rand() % 2);
+          break;
+      }
+    }
+    if (pass) {
+      tft.flush();
+      tft.stopRecording();
+    }
+    tft.readRect(0, 0, W, H, pass ? rb : ref);
+  }
+  tft.setTextDatum(TL_DATUM);
+  for (int i = 0; i < W * H; i++) if (rb[i] != ref[i]) { fprintf(stderr, "display list: mismatch %d\n", i); abort(); }
+
+  // Replay into a sprite
+  TFT_eSprite s2(&tft);
+  s2.createSprite(40, 30);
+  s2.fillSprite(0);
+  tft.startRecording(arena, sizeof(arena));
+  tft.fillRect(2, 3, 10, 10, TFT_RED);
+  tft.drawFastHLine(0, 0, 40, TFT_GREEN);
+  tft.stopRecording();
+  tft.replay(&s2);
+  assert(s2.readPixel(5, 5) == TFT_RED && s2.readPixel(39, 0) == TFT_GREEN);
+  tft.clearList();
+  s2.deleteSprite();
+#else
+  (void)tft;
+#endif
+}
+
+/***************************************************************************************
+** pushSpriteDirty() keeps the TFT the same as the sprite at each colour depth
+***************************************************************************************/
+static void testDirty(TFT_eSPI &tft)
+{
+  static uint16_t rb[100 * 60];
+  const int bpps[4] = { 16, 8, 4, 1 };
+
+  tft.setRotation(0);
+  for (int b = 0; b < 4; b++) {
+    TFT_eSprite sp(&tft);
+    sp.setColorDepth(bpps[b]);
+    sp.createSprite(100, 60);
+    sp.fillSprite(TFT_BLACK);
+    sp.trackDirty(true);
+    sp.pushSpriteDirty(20, 30);
+    uint16_t img[8 * 8];
+    for (int i = 0; i < 64; i++) img[i] = i * 999;
+    srand(11 + b);
+    for (int f = 0; f < 40; f++) {
+      int n = rand() % 4;
+      for (int k = 0; k < n; k++) {
+        int x = rand() % 110 - 5, y = rand() % 70 - 5;
+        uint16_t c = rand();
+        switch (rand() % 8) {
+          case 0: sp.fillRect(x, y, rand() % 12, rand() % 12, c); break;
+          case 1: sp.drawPixel(x, y, c); break;
+          case 2: sp.drawLine(x, y, rand() % 100, rand() % 60, c); break;
+          case 3: sp.setTextColor(c, ~c); sp.drawString("12", x, y, 2 + 2 * (rand() % 2)); break;
+          case 4: sp.fillCircle(x, y, rand() % 8, c); break;
+          case 5: sp.drawWedgeLine(x, y, rand() % 100, rand() % 60, 2, 1, c, 0); break;
+          case 6: sp.pushImage(x, y, 8, 8, img); break;
+          case 7: sp.setScrollRect(10, 10, 30, 20, TFT_BLUE); sp.scroll(1, 2); break;
+        }
+      }
+      sp.pushSpriteDirty(20, 30);
+      tft.readRect(20, 30, 100, 60, rb);
+      for (int y = 0; y < 60; y++) for (int x = 0; x < 100; x++) {
+        uint16_t t = swap16(rb[x + y * 100]), s = sp.readPixel(x, y);
+        if ((t & 0xFFDF) != (s & 0xFFDF)) {
+          fprintf(stderr, "dirty: bpp %d frame %d at %d,%d tft %04x spr %04x\n", bpps[b], f, x, y, t, s);
+          abort();
+        }
+      }
+    }
+    sp.deleteSprite();
+  }
+}
+
+/***************************************************************************************
+** pushBanded() draws the same as one sprite the size of the area
+***************************************************************************************/
+static void bandScene(TFT_eSprite *s, void *)
+{
+  s->fillSprite(TFT_NAVY);
+  s->fillCircle(160, 120, 70, TFT_RED);
+  s->drawWedgeLine(0, 0, 319, 239, 1, 8, TFT_YELLOW, TFT_NAVY);
+  s->setTextColor(TFT_WHITE, TFT_NAVY);
+  s->drawString("Banded", 100, 117, 4);
+  s->fillRect(-10, 230, 50, 50, TFT_GREEN);
+}
+
+static void testBanded(TFT_eSPI &tft)
+{
+  static uint16_t rb[320 * 240], ref[320 * 240];
+
+  tft.setRotation(1);
+  TFT_eSprite d(&tft);
+  d.createSprite(320, 240);
+  bandScene(&d, nullptr);
+  d.pushSprite(0, 0);
+  d.deleteSprite();
+  tft.readRect(0, 0, 320, 240, ref);
+
+  for (int bh : { 20, 17, 240 }) {
+    TFT_eSprite b(&tft);
+    b.createSprite(300, bh);
+    tft.fillScreen(TFT_NAVY);
+    b.pushBanded(10, -5, 250, bandScene);
+    tft.readRect(0, 0, 320, 240, rb);
+    for (int y = 0; y < 240; y++) for (int x = 10; x < 310; x++) {
+      if (rb[x + y * 320] != ref[x + y * 320]) {
+        fprintf(stderr, "banded: height %d at %d,%d %04x %04x\n", bh, x, y, rb[x + y * 320], ref[x + y * 320]);
+        abort();
+      }
+    }
+    assert(b.getViewportX() == 0 && b.getViewportWidth() == 300);
+    b.deleteSprite();
+  }
+  tft.setRotation(0);
+}
+
+/***************************************************************************************
+** Span colour converters match the single pixel functions
+***************************************************************************************/
+static void testColorSpans(TFT_eSPI &tft)
+{
+  static uint8_t b8[1000], o8[1300];
+  static uint16_t b16[400], o16[400];
+
+  srand(3);
+  for (auto &v : b8) v = rand();
+  for (auto &v : b16) v = rand();
+
+  for (int off = 0; off < 4; off++) for (int len : { 0, 1, 2, 3, 4, 5, 7, 8, 9, 33, 250 }) for (int sw = 0; sw < 2; sw++) {
+    tft.color24to16(b8 + off, o16 + 1, len, sw);
+    for (int i = 0; i < len; i++) {
+      uint8_t *q = b8 + off + 3 * i;
+      assert(o16[1 + i] == swapIf(sw, tft.color24to16((uint32_t)q[0] << 16 | q[1] << 8 | q[2])));
+    }
+
+    memset(o8, 0xAA, sizeof(o8));
+    tft.color16to24(b16 + 1, o8 + off, len, sw);
+    for (int i = 0; i < len; i++) {
+      uint32_t c = tft.color16to24(swapIf(sw, b16[1 + i]));
+      assert(o8[off + 3 * i] == (c >> 16 & 0xFF) && o8[off + 3 * i + 1] == (c >> 8 & 0xFF) && o8[off + 3 * i + 2] == (c & 0xFF));
+    }
+    assert(o8[off + 3 * len] == 0xAA);
+
+    tft.color16to18(b16 + 1, o8 + off, len, sw);
+    for (int i = 0; i < len; i++) {
+      uint16_t c = swapIf(sw, b16[1 + i]);
+      assert(o8[off + 3 * i] == ((c & 0xF800) >> 8) && o8[off + 3 * i + 1] == ((c & 0x07E0) >> 3) && o8[off + 3 * i + 2] == ((c & 0x001F) << 3));
+    }
+
+    tft.color8to16(b8 + off, o16 + off, len, sw);
+    for (int i = 0; i < len; i++) assert(o16[off + i] == swapIf(sw, tft.color8to16(b8[off + i])));
+
+    memset(o8, 0xAA, sizeof(o8));
+    tft.color16to8(b16 + off, o8 + 1, len, sw);
+    for (int i = 0; i < len; i++) assert(o8[1 + i] == tft.color16to8(swapIf(sw, b16[off + i])));
+    assert(o8[1 + len] == 0xAA);
+  }
+
+  // 8-bit image from RAM
+  static uint8_t img[37 * 11];
+  static uint16_t ref[37 * 11];
+  for (auto &v : img) v = rand();
+  for (int i = 0; i < 37 * 11; i++) ref[i] = tft.color8to16(img[i]);
+  tft.pushImage(3, 4, 37, 11, img, true);
+  checkRect(tft, 3, 4, 37, 11, ref, "8-bit image");
+
+  // From FLASH, clipped at the left and top
+  tft.pushImage(-2, -1, 37, 11, (const uint8_t *)img, true);
+  for (int i = 0; i < 35 * 10; i++) ref[i] = tft.color8to16(img[i % 35 + 2 + (i / 35 + 1) * 37]);
+  checkRect(tft, 0, 0, 35, 10, ref, "8-bit FLASH image");
+
+  // With a transparent colour, runs start and end at the image edges
+  const uint8_t tp = 0x5A;
+  for (int i = 0; i < 37 * 11; i++) if (rand() % 3 == 0 || i % 37 == 0 || i % 37 == 36) img[i] = tp;
+  tft.fillRect(3, 4, 37, 11, TFT_NAVY);
+  tft.pushImage(3, 4, 37, 11, img, tp, true);
+  for (int i = 0; i < 37 * 11; i++) ref[i] = img[i] == tp ? TFT_NAVY : tft.color8to16(img[i]);
+  checkRect(tft, 3, 4, 37, 11, ref, "transparent 8-bit image");
+}
+
+/***************************************************************************************
+** 4bpp and 1bpp images, clipped on each side, small and large (pair table)
+***************************************************************************************/
+static void testPackedImages(TFT_eSPI &tft)
+{
+  static uint8_t im[100 * 80];
+  static uint16_t cm[16], ref[100 * 80];
+
+  srand(5);
+  for (auto &v : im) v = rand();
+  for (auto &v : cm) v = rand();
+  tft.setBitmapColor(0x1234, 0xF00F);
+
+  for (int big = 0; big < 2; big++) for (int cst = 0; cst < 2; cst++) for (int bpp = 1; bpp <= 4; bpp += 3) {
+    int w = big ? 99 : 13, h = big ? 70 : 9;
+    int we = (bpp == 4) ? (w + 1) & ~1 : w;
+    for (int ox : { -3, -2, 0, 5 }) for (int oy : { -4, 0 }) {
+      int X = ox, Y = oy;
+      if (big && ox == 5) X = tft.width() - w + 7; // clip right
+      tft.fillScreen(0);
+      if (cst) tft.pushImage(X, Y, w, h, (const uint8_t*)im, false, bpp == 4 ? cm : nullptr);
+      else     tft.pushImage(X, Y, w, h, im, false, bpp == 4 ? cm : nullptr);
+      int x0 = X < 0 ? 0 : X, y0 = Y < 0 ? 0 : Y;
+      int x1 = X + w > tft.width() ? tft.width() : X + w, y1 = Y + h;
+      for (int yy = y0; yy < y1; yy++) for (int xx = x0; xx < x1; xx++) {
+        int px = xx - X, py = yy - Y;
+        uint16_t e;
+        if (bpp == 4) { uint8_t b = im[(px + py * we) >> 1]; e = cm[(px & 1) ? b & 15 : b >> 4]; }
+        else { uint8_t b = im[(px >> 3) + py * ((w + 7) >> 3)]; e = (b & (0x80 >> (px & 7))) ? 0x1234 : 0xF00F; }
+        ref[(xx - x0) + (yy - y0) * (x1 - x0)] = e;
+      }
+      checkRect(tft, x0, y0, x1 - x0, y1 - y0, ref, bpp == 4 ? "4bpp image" : "1bpp image");
+    }
+  }
+}
+
+/***************************************************************************************
+** Transparent 16-bit pushImage(), span lists and the sprite span cache
+***************************************************************************************/
+static void testTransparent(TFT_eSPI &tft)
+{
+  static uint16_t im[67 * 41 + 1], ref[67 * 41];
+  static uint16_t sl[67 * 41 * 2 + 64];
+  const int w = 67, h = 41;
+
+  srand(9);
+  for (auto &v : im) { int r = rand() % 8; v = r < 3 ? 0xABCD : (r == 3 ? 0xCDAB : rand()); }
+
+  for (int mode = 0; mode < 4; mode++) for (int ox : { -5, 0, 3 }) for (int oy : { -3, 0 }) for (int sw = 0; sw < 2; sw++) {
+    int X = ox == 3 ? tft.width() - w + 9 : ox, Y = oy;
+    uint16_t key = 0xABCD;
+    tft.setSwapBytes(sw);
+    tft.fillScreen(0x0841);
+    const uint16_t *src = im + 1 - (mode & 1); // Misaligned start too
+    if (mode < 2) tft.pushImage(X, Y, w, h, (uint16_t*)src, key);
+    else if (mode == 2) tft.pushImage(X, Y, w, h, src, key);
+    else {
+      uint32_t n = tft.createSpanList(w, h, src, key, nullptr, 0);
+      assert(n <= sizeof(sl) / 2 && tft.createSpanList(w, h, src, key, sl, n) == n);
+      tft.pushImageSpans(X, Y, w, h, src, sl);
+    }
+    int x0 = X < 0 ? 0 : X, y0 = Y < 0 ? 0 : Y;
+    int x1 = X + w > tft.width() ? tft.width() : X + w, y1 = Y + h;
+    uint16_t k = swapIf(!sw, key);
+    for (int yy = y0; yy < y1; yy++) for (int xx = x0; xx < x1; xx++) {
+      uint16_t c = src[(xx - X) + (yy - Y) * w];
+      ref[(xx - x0) + (yy - y0) * (x1 - x0)] = (c == k) ? 0x0841 : swapIf(!sw, c);
+    }
+    checkRect(tft, x0, y0, x1 - x0, y1 - y0, ref, "transparent image");
+  }
+  tft.setSwapBytes(false);
+
+  TFT_eSprite spr(&tft);
+  spr.createSprite(50, 30);
+  spr.fillSprite(TFT_RED);
+  spr.fillRect(10, 5, 20, 10, TFT_GREEN);
+  spr.cacheSpans();
+  for (int pass = 0; pass < 4; pass++) {
+    if (pass == 2) { spr.drawPixel(0, 0, TFT_GREEN); spr.fillRect(40, 20, 5, 5, TFT_BLUE); }
+    uint16_t key = pass == 3 ? TFT_RED : TFT_GREEN;
+    tft.fillScreen(TFT_BLACK);
+    spr.pushSprite(-2, 4, key);
+    for (int yy = 0; yy < 30; yy++) for (int xx = 2; xx < 50; xx++) {
+      uint16_t c = spr.readPixel(xx, yy);
+      if (tft.readPixel(xx - 2, yy + 4) != (c == key ? TFT_BLACK : c)) {
+        fprintf(stderr, "sprite spans: pass %d at %d,%d\n", pass, xx, yy);
+        abort();
+      }
+    }
+  }
+  spr.deleteSprite();
+}
+
+/***************************************************************************************
+** Span blend kernels against a per channel reference, and pushAlphaImage()
+***************************************************************************************/
+static void testBlend(TFT_eSPI &tft)
+{
+  srand(13);
+  for (int i = 0; i < 200000; i++) {
+    uint16_t f = rand(), b = rand();
+    uint8_t a = rand();
+    uint16_t d = b, d2 = swap16(b), s2 = swap16(f), d3 = b;
+    tft.blendSpan(&d, &f, &a, 1);
+    tft.blendSpan(&d2, &s2, &a, 1, true);
+    tft.blendSpanConst(&d3, f, &a, 1);
+    int a5 = a >= 252 ? 32 : (a > 3 ? (a + 4) >> 3 : 0);
+    int fr = f >> 11, fg = (f >> 5) & 63, fb = f & 31, br = b >> 11, bg = (b >> 5) & 63, bb = b & 31;
+    int r = br + (fr - br) * a5 / 32.0, g = bg + (fg - bg) * a5 / 32.0, bl = bb + (fb - bb) * a5 / 32.0;
+    int er = abs((d >> 11) - r), eg = abs(((d >> 5) & 63) - g), eb = abs((d & 31) - bl);
+    if (er > 1 || eg > 1 || eb > 1 || d3 != d || swap16(d2) != d) {
+      fprintf(stderr, "blend: %04x %04x %d -> %04x %04x %04x\n", f, b, a, d, d2, d3);
+      abort();
+    }
+    assert(a != 0 || d == b);
+    assert(a != 255 || d == f);
+  }
+
+  // pushAlphaImage() with a fixed and a read background, both byte orders
+  static uint16_t im[37 * 23], ref[33 * 23];
+  static uint8_t al[37 * 23];
+  for (auto &v : im) v = rand();
+  for (auto &v : al) { int r = rand() % 4; v = r == 0 ? 0 : (r == 1 ? 255 : rand()); }
+  for (int sw = 0; sw < 2; sw++) for (int rb = 0; rb < 2; rb++) {
+    tft.setSwapBytes(sw);
+    tft.fillScreen(0x1234);
+    tft.pushAlphaImage(-4, 7, 37, 23, im, al, rb ? 0x00FFFFFF : 0x1234);
+    for (int yy = 0; yy < 23; yy++) for (int xx = 0; xx < 33; xx++) {
+      uint16_t c = swapIf(!sw, im[xx + 4 + yy * 37]);
+      uint16_t e = 0x1234;
+      tft.blendSpan(&e, &c, &al[xx + 4 + yy * 37], 1);
+      ref[xx + yy * 33] = e;
+    }
+    checkRect(tft, 0, 7, 33, 23, ref, "alpha image");
+  }
+  tft.setSwapBytes(false);
+
+  // drawAlphaSpan() reading the TFT and a 16-bit sprite, spans are longer than a block
+  // and clipped on both sides. With a display list the span is recorded and replayed
+  static uint8_t sa[300];
+  static uint16_t bg[240];
+  for (auto &v : sa) v = rand();
+  TFT_eSprite spr(&tft);
+  spr.createSprite(240, 3);
+  for (int rev = 0; rev < 2; rev++) for (int rec = 0; rec < 2; rec++) {
+    for (int xx = 0; xx < 240; xx++) {
+      bg[xx] = rand();
+      tft.drawPixel(xx, 50, bg[xx]);
+      spr.drawPixel(xx, 1, bg[xx]);
+    }
+#ifdef TFT_DISPLAY_LIST
+    static uint8_t arena[1024];
+    if (rec) tft.startRecording(arena, sizeof(arena));
+#else
+    if (rec) continue;
+#endif
+    tft.drawAlphaSpan(-30, 50, sa, 300, TFT_ORANGE, 0x00FFFFFF, rev);
+#ifdef TFT_DISPLAY_LIST
+    if (rec) {
+      assert(tft.listUsed() > 0);
+      tft.stopRecording();
+      tft.flush();
+    }
+#endif
+    spr.drawAlphaSpan(-30, 1, sa, 300, TFT_ORANGE, 0x00FFFFFF, rev);
+    for (int xx = 0; xx < 240; xx++) {
+      uint8_t a = rev ? sa[299 - 30 - xx] : sa[30 + xx];
+      ref[xx] = bg[xx];
+      tft.blendSpanConst(&ref[xx], TFT_ORANGE, &a, 1);
+      assert(spr.readPixel(xx, 1) == ref[xx]);
+    }
+    checkRect(tft, 0, 50, 240, 1, ref, "alpha span");
+  }
+  spr.deleteSprite();
+}
+
+/***************************************************************************************
+** Polygons drawn in a sprite match the TFT
+***************************************************************************************/
+static void testPolygon(TFT_eSPI &tft)
+{
+  static const int32_t star[] = { 60*256, 5*256, 75*256, 45*256, 115*256, 45*256, 83*256, 70*256, 95*256, 110*256,
+                                  60*256+77, 85*256, 25*256, 110*256, 37*256, 70*256, 5*256, 45*256, 45*256, 45*256 };
+  static uint16_t ref[120 * 120];
+
+  tft.setRotation(0);
+  for (int smooth = 0; smooth < 2; smooth++) {
+    TFT_eSprite s(&tft);
+    s.createSprite(120, 120);
+    s.fillSprite(TFT_NAVY);
+    tft.fillRect(0, 0, 120, 120, TFT_NAVY);
+    if (smooth) { s.fillSmoothPolygon(star, 10, TFT_ORANGE); tft.fillSmoothPolygon(star, 10, TFT_ORANGE); }
+    else        { s.fillPolygon(star, 10, TFT_ORANGE); tft.fillPolygon(star, 10, TFT_ORANGE); }
+    int lit = 0;
+    for (int i = 0; i < 120 * 120; i++) {
+      ref[i] = s.readPixel(i % 120, i / 120);
+      lit += (ref[i] != TFT_NAVY);
+    }
+    assert(lit > 2000);
+    checkRect(tft, 0, 0, 120, 120, ref, smooth ? "smooth polygon" : "polygon");
+    s.deleteSprite();
+  }
+}
+
+/***************************************************************************************
+** A path rectangle on whole pixels matches fillRect()
+***************************************************************************************/
+static void testPath(TFT_eSPI &tft)
+{
+  static tftPolyEdge_t pe[16];
+  TFT_ePath path(pe, 16);
+
+  path.moveTo(10, 20);
+  path.lineTo(50, 20);
+  path.lineTo(50, 45);
+  path.lineTo(10, 45);
+  path.close();
+  tft.fillScreen(TFT_BLACK);
+  path.fill(&tft, TFT_RED, TFT_BLACK);
+  for (int y = 15; y < 50; y++) for (int x = 5; x < 55; x++)
+    assert(tft.readPixel(x, y) == ((x >= 10 && x < 50 && y >= 20 && y < 45) ? TFT_RED : TFT_BLACK));
+  assert(path.segments() == 4 && !path.overflow());
+}
+
+/***************************************************************************************
+** Gradient positions against a float reference, the TFT and 16 and 8-bit sprites match
+***************************************************************************************/
+// Ramp index of pixel x,y, as defined in the set...Gradient() descriptions
+static float gradientRef(int type, const float *p, int x, int y)
+{
+  float px = x + 0.5f - p[0], py = y + 0.5f - p[1];
+  if (type == GRADIENT_LINEAR) {
+    float vx = p[2] - p[0], vy = p[3] - p[1];
+    float u = (px * vx + py * vy) * 255.0f / (vx * vx + vy * vy);
+    return u < 0 ? 0 : u > 255 ? 255 : u;
+  }
+  if (type == GRADIENT_RADIAL) {
+    float u = sqrtf(px * px + py * py) * 255.0f / p[2];
+    return u > 255 ? 255 : u;
+  }
+  // Conic, 256 steps per turn clockwise from 6 o'clock
+  float a = atan2f(py, px) * 128.0f / (float)M_PI - (p[2] + 90.0f) * 256.0f / 360.0f;
+  return fmodf(a + 1024.0f, 256.0f);
+}
+
+static void testGradient(TFT_eSPI &tft)
+{
+  const int W = 97, H = 61;
+  static const struct { int type; float p[4]; } cases[] = {
+    { GRADIENT_LINEAR, { 10, 5, 80, 50 } },    { GRADIENT_LINEAR, { 90, 3, 2, 7 } },
+    { GRADIENT_LINEAR, { -40, 30, 150, 30 } }, { GRADIENT_LINEAR, { 20, 70, 20, -10 } },
+    { GRADIENT_RADIAL, { 40, 30, 35 } },       { GRADIENT_RADIAL, { -20, 80, 120 } },
+    { GRADIENT_CONIC,  { 48, 30, 0 } },        { GRADIENT_CONIC,  { 10.3f, 50.7f, 137 } },
+    { GRADIENT_CONIC,  { -9000, -5000, 30 } }, { GRADIENT_CONIC,  { 6000, 40000, 300 } },
+  };
+
+  TFT_eSprite s16(&tft), s8(&tft);
+  s16.createSprite(W, H);
+  s8.setColorDepth(8);
+  s8.createSprite(W, H);
+  static tftGradient_t g;
+  static uint16_t ref[W * H];
+  uint16_t *p16 = (uint16_t *)s16.getPointer();
+  uint8_t  *p8  = (uint8_t *)s8.getPointer();
+
+  for (auto &c : cases) {
+    if (c.type == GRADIENT_LINEAR) tft.setLinearGradient(&g, c.p[0], c.p[1], c.p[2], c.p[3]);
+    else if (c.type == GRADIENT_RADIAL) tft.setRadialGradient(&g, c.p[0], c.p[1], c.p[2]);
+    else tft.setConicGradient(&g, c.p[0], c.p[1], c.p[2]);
+
+    // A ramp holding its own index, to check the position of each pixel
+    for (int i = 0; i < 256; i++) g.ramp[i] = i;
+    s16.fillRectGradient(0, 0, W, H, &g);
+    for (int y = 0; y < H; y++) for (int x = 0; x < W; x++) {
+      float u = gradientRef(c.type, c.p, x, y);
+      int k = p16[x + y * W];
+      // The conic index is truncated and the arctangent is within 1/6 of a step
+      float e = fabsf(k - (c.type == GRADIENT_CONIC ? u : roundf(u)));
+      if (c.type == GRADIENT_CONIC && e > 128) e = 256 - e;
+      if (e > (c.type == GRADIENT_CONIC ? 1.2f : 1.0f)) {
+        fprintf(stderr, "gradient %d: %d,%d index %d ref %.2f\n", c.type, x, y, k, u);
+        abort();
+      }
+    }
+
+    // A colour ramp, drawn on the TFT and in each sprite
+    static const tftGradientStop_t stop[] = { { 0, TFT_RED }, { 100, TFT_YELLOW }, { 180, TFT_BLUE }, { 255, TFT_GREEN } };
+    tft.setGradientColors(&g, stop, 4);
+    s16.fillRectGradient(0, 0, W, H, &g);
+    s8.fillRectGradient(0, 0, W, H, &g);
+    tft.fillRectGradient(0, 0, W, H, &g);
+    for (int i = 0; i < W * H; i++) {
+      ref[i] = swap16(p16[i]);
+      assert(p8[i] == tft.color16to8(ref[i]));
+    }
+    checkRect(tft, 0, 0, W, H, ref, "gradient");
+  }
+
+  // 4 and 1-bit sprites hold palette indexes, nothing is drawn
+  TFT_eSprite s4(&tft);
+  s4.setColorDepth(4);
+  s4.createSprite(W, H);
+  s4.fillSprite(3);
+  s4.fillRectGradient(0, 0, W, H, &g);
+  for (int y = 0; y < H; y++) for (int x = 0; x < W; x++) assert(s4.readPixelValue(x, y) == 3);
+
+  s4.deleteSprite();
+  s8.deleteSprite();
+  s16.deleteSprite();
+}
+
+/***************************************************************************************
+** pushAffine() and pushRotated() against a float mapping of pixel centres, at each
+** source colour depth, nearest and bilinear, to a sprite and to the TFT
+***************************************************************************************/
+// Float bilinear sample of a 565 image at u,v, pixel centres are at n + 0.5 and the
+// position is clamped at the edges
+static void bilinearRef(const uint16_t *img, int w, int h, float u, float v, float *rgb)
+{
+  u -= 0.5f; v -= 0.5f;
+  if (u < 0) u = 0;
+  if (v < 0) v = 0;
+  int sx = (int)u, sy = (int)v;
+  float fx = u - sx, fy = v - sy;
+  if (sx >= w - 1) { sx = w - 1; fx = 0; }
+  if (sy >= h - 1) { sy = h - 1; fy = 0; }
+  int nx = sx < w - 1 ? 1 : 0, ny = sy < h - 1 ? 1 : 0;
+  uint16_t c[4] = { img[sx + sy * w], img[sx + nx + sy * w], img[sx + (sy + ny) * w], img[sx + nx + (sy + ny) * w] };
+  for (int k = 0; k < 3; k++) {
+    int sh = k == 0 ? 11 : (k == 1 ? 5 : 0), m = k == 1 ? 63 : 31;
+    float t = ((c[0] >> sh) & m) * (1 - fx) + ((c[1] >> sh) & m) * fx;
+    float b = ((c[2] >> sh) & m) * (1 - fx) + ((c[3] >> sh) & m) * fx;
+    rgb[k] = t * (1 - fy) + b * fy;
+  }
+}
+
+// Check a destination pixel against the sample at u,v, the position is in source pixels.
+// Returns false if the pixel is too close to a pixel boundary for a nearest sample to
+// be certain
+static bool checkSample(uint16_t d, const uint16_t *img, int w, int h, float u, float v,
+                        uint8_t mode, int32_t tp, uint16_t marker)
+{
+  const float e = 1.0f / 256;
+  float fu = u - floorf(u), fv = v - floorf(v);
+  if (fu < e || fu > 1 - e || fv < e || fv > 1 - e) return false;
+
+  if (u < 0 || v < 0 || u >= w || v >= h) { assert(d == marker); return true; }
+
+  uint16_t near = img[(int)u + (int)v * w];
+  if (tp >= 0 && near == tp) { assert(d == marker); return true; }
+
+  if (mode == SCALE_NEAREST) {
+    if (d != near) {
+      fprintf(stderr, "affine: sample at %.3f,%.3f is %04x, expected %04x\n", u, v, d, near);
+      abort();
+    }
+  }
+  else {
+    float rgb[3];
+    bilinearRef(img, w, h, u, v, rgb);
+    int r = d >> 11, g = (d >> 5) & 63, b = d & 31;
+    if (fabsf(r - rgb[0]) > 1.5f || fabsf(g - rgb[1]) > 2.5f || fabsf(b - rgb[2]) > 1.5f) {
+      fprintf(stderr, "affine: bilinear at %.3f,%.3f is %04x, expected %.1f %.1f %.1f\n", u, v, d, rgb[0], rgb[1], rgb[2]);
+      abort();
+    }
+  }
+  return true;
+}
+
+static void testAffine(TFT_eSPI &tft)
+{
+  const int SW = 23, SH = 17, DW = 64, DH = 64;
+  const uint16_t marker = 0x1863;
+  static uint16_t img[SW * SH], rb[DW * DH];
+  static const struct { float angle, xs, ys, shear; } tf[] = {
+    { 0, 1, 1, 0 }, { 90, 1, 1, 0 }, { 180, 1, 1, 0 }, { 270, 1, 1, 0 },
+    { 33, 1.7f, 0.8f, 0 }, { -127, 0.6f, 1.3f, 0.4f },
+  };
+
+  TFT_eSprite dst(&tft);
+  dst.createSprite(DW, DH);
+  dst.setPivot(30, 31);
+  tft.setPivot(40, 50);
+
+  const uint8_t depth[] = { 16, 8, 4, 1 };
+  for (uint8_t bpp : depth) {
+    TFT_eSprite s(&tft);
+    s.setColorDepth(bpp);
+    s.createSprite(SW, SH);
+    for (int y = 0; y < SH; y++) for (int x = 0; x < SW; x++) {
+      uint16_t c = rand();
+      if (bpp == 4) c &= 0x0F;
+      if (bpp == 1) c &= 0x01;
+      s.drawPixel(x, y, c);
+      img[x + y * SW] = s.readPixel(x, y);
+    }
+    s.setPivot(11, 8);
+
+    for (uint8_t mode = SCALE_NEAREST; mode <= SCALE_BILINEAR; mode++)
+    for (auto &t : tf) for (int useTp = 0; useTp < 2; useTp++) {
+      // The colour of pixel 0,0 is transparent, which is a palette index for 4bpp
+      int32_t  tp = useTp ? img[0] : -1;
+      uint32_t transp = useTp ? (bpp == 4 ? s.readPixelValue(0, 0) : img[0]) : 0x00FFFFFF;
+      if (useTp && mode == SCALE_BILINEAR) continue;
+
+      tftAffine_t m;
+      s.setAffine(&m, t.angle, t.xs, t.ys, t.shear, 30, 31);
+      dst.fillSprite(marker);
+      s.pushAffine(&dst, &m, transp, mode);
+
+      // The same transform on the TFT
+      tftAffine_t mt = m;
+      mt.tx += 10; mt.ty += 19;
+      tft.fillRect(10, 19, DW, DH, marker);
+      s.pushAffine(&mt, transp, mode);
+      tft.readRect(10, 19, DW, DH, rb);
+
+      float det = m.a * m.d - m.b * m.c;
+      int skipped = 0;
+      for (int y = 0; y < DH; y++) for (int x = 0; x < DW; x++) {
+        float px = x - m.tx, py = y - m.ty;
+        float u = ( m.d * px - m.b * py) / det + 0.5f;
+        float v = (-m.c * px + m.a * py) / det + 0.5f;
+        uint16_t d = dst.readPixel(x, y);
+        if (!checkSample(d, img, SW, SH, u, v, mode, tp, marker)) skipped++;
+        assert((swap16(rb[x + y * DW]) & 0xFFDF) == (d & 0xFFDF));
+      }
+
+      // Right angle rotations map pixel centres onto pixel centres, so nothing is uncertain
+      if (t.xs == 1 && t.ys == 1 && t.shear == 0) assert(skipped == 0);
+
+      // pushRotated() is pushAffine() without scale or shear, nearest sampling
+      if (mode == SCALE_NEAREST && t.xs == 1 && t.ys == 1 && t.shear == 0) {
+        static uint16_t ref[DW * DH];
+        for (int i = 0; i < DW * DH; i++) ref[i] = dst.readPixel(i % DW, i / DW);
+        dst.fillSprite(marker);
+        s.pushRotated(&dst, t.angle, transp);
+        for (int i = 0; i < DW * DH; i++) assert(dst.readPixel(i % DW, i / DW) == ref[i]);
+
+        tft.fillRect(10, 19, DW, DH, marker);
+        tft.setPivot(40, 50);
+        s.pushRotated(t.angle, transp);
+        checkRect(tft, 10, 19, DW, DH, ref, "rotated");
+      }
+    }
+    s.deleteSprite();
+  }
+  dst.deleteSprite();
+}
+
+/***************************************************************************************
+** Arena and pool allocators: reuse, exhaustion, foreign pointers, and a sprite and a
+** smooth font using the allocator draw the same as with the heap
+***************************************************************************************/
+static void testAllocator(TFT_eSPI &tft)
+{
+  static uint8_t mem[16384 + 3];
+  int local;
+
+  // Arena, the region is not aligned
+  TFT_eArena arena(mem + 3, 1000);
+  uint8_t *a = (uint8_t *)arena.allocate(10);
+  uint8_t *b = (uint8_t *)arena.allocate(100);
+  uint8_t *c = (uint8_t *)arena.allocate(1);
+  assert(a && b && c && a < b && b < c);
+  assert(((uintptr_t)a % ALLOC_ALIGN) == 0 && ((uintptr_t)c % ALLOC_ALIGN) == 0);
+  size_t used = arena.used();
+
+  // The last block is reused, others are kept until every block is released
+  arena.release(c);
+  assert(arena.allocate(1) == c && arena.used() == used);
+  arena.release(b);
+  assert(arena.used() == used);
+
+  // Foreign pointers and a second release of b are ignored
+  arena.release(&local);
+  arena.release(mem + 3 + 1000);
+  arena.release(b);
+  arena.release(b + 1);
+  arena.release(a);
+  assert(arena.used() == used);
+  arena.release(c);
+  assert(arena.used() == 0);
+
+  // Exhaustion, the arena is full and then free again
+  int n = 0;
+  uint8_t *last = nullptr;
+  while (uint8_t *p = (uint8_t *)arena.allocate(64)) { assert(p > last); last = p; n++; }
+  assert(n > 1 && n <= 1000 / 64 && arena.used() <= arena.size());
+  assert(arena.allocate(64) == nullptr);
+  arena.reset();
+  assert(arena.used() == 0 && arena.allocate((arena.size() - ARENA_HEADER) & ~(ALLOC_ALIGN - 1)) != nullptr);
+  assert(arena.allocate(1) == nullptr);
+  arena.reset();
+
+  // Pool, best fit first and the next class when a class is exhausted
+  TFT_ePool pool(mem, 2000);
+  assert(pool.addClass(256, 2) && pool.addClass(64, 3));
+  assert(!pool.addClass(1000, 2)); // No space
+  assert(pool.available(50) == 5 && pool.available(100) == 2 && pool.available(300) == 0);
+  void *p[5];
+  for (int i = 0; i < 3; i++) { p[i] = pool.allocate(50); assert(p[i]); }
+  assert(pool.available(50) == 2);
+  p[3] = pool.allocate(50); // From the 256 byte class
+  assert(p[3] && pool.available(100) == 1);
+  p[4] = pool.allocate(200);
+  assert(p[4] && pool.allocate(1) == nullptr);
+
+  // Released blocks are reused, foreign and misaligned pointers are ignored
+  pool.release(&local);
+  pool.release((uint8_t *)p[1] + 8);
+  assert(pool.available(1) == 0);
+  pool.release(p[1]);
+  assert(pool.available(1) == 1 && pool.allocate(64) == p[1]);
+  for (auto q : p) pool.release(q);
+  assert(pool.available(50) == 5);
+
+  // A sprite and a smooth font in an arena draw the same as with the heap
+  static uint16_t ref[120 * 30];
+  TFT_eArena fontArena(mem, sizeof(mem));
+  for (int k = 0; k < 2; k++) {
+    tft.setAllocator(k ? &fontArena : nullptr);
+    TFT_eSprite spr(&tft);
+    uint16_t *img = (uint16_t *)spr.createSprite(120, 30);
+    assert(img != nullptr);
+    if (k) assert((uint8_t *)img >= mem && (uint8_t *)img < mem + sizeof(mem));
+
+    spr.loadFont(NotoSansBold15);
+    spr.fillSprite(TFT_NAVY);
+    spr.setTextColor(TFT_YELLOW, TFT_NAVY);
+    spr.drawString("Arena 123", 4, 6);
+    spr.unloadFont();
+
+    if (k == 0) for (int i = 0; i < 120 * 30; i++) ref[i] = spr.readPixel(i % 120, i / 120);
+    else for (int i = 0; i < 120 * 30; i++) assert(spr.readPixel(i % 120, i / 120) == ref[i]);
+
+    spr.deleteSprite();
+    if (k) assert(fontArena.used() == 0);
+  }
+
+  // The TFT font metrics, the arena is empty after unloadFont()
+  tft.setAllocator(&fontArena);
+  tft.loadFont(NotoSansBold15);
+  assert(fontArena.used() > 0);
+  tft.unloadFont();
+  assert(fontArena.used() == 0);
+  tft.setAllocator(nullptr);
+}
+
+/***************************************************************************************
+** Batched drawing matches the single calls, on the TFT and in a sprite, with clipping
+***************************************************************************************/
+static uint32_t lcg(uint32_t &seed)
+{
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+// Draw the batch or the single call equivalent to d with a viewport that clips
+static void batchScene(TFT_eSPI &d, bool batched)
+{
+  static tftPoint_t pt[300];
+  static uint16_t   col[300];
+  static tftRect_t  rect[40];
+  static tftSpan_t  span[300];
+  uint32_t seed = 1;
+
+  d.fillScreen(TFT_BLACK);
+  d.setViewport(10, 8, 100, 80);
+
+  // Points and spans may be off the viewport, repeat a pixel or overlap
+  for (int i = 0; i < 300; i++) {
+    pt[i].x = lcg(seed) % 130 - 15;
+    pt[i].y = lcg(seed) % 110 - 15;
+    col[i] = lcg(seed);
+    span[i].x = lcg(seed) % 140 - 30;
+    span[i].y = lcg(seed) % 110 - 15;
+    span[i].w = lcg(seed) % 40;
+    span[i].color = lcg(seed);
+  }
+  pt[100].x = pt[107].x = 50; // The same pixel twice
+  pt[100].y = pt[107].y = 40;
+  for (int i = 0; i < 40; i++) {
+    rect[i].x = lcg(seed) % 130 - 20;
+    rect[i].y = lcg(seed) % 110 - 20;
+    rect[i].w = lcg(seed) % 30;
+    rect[i].h = lcg(seed) % 30;
+  }
+
+  if (batched) {
+    d.drawHLines(span, 300);
+    d.fillRects(rect, 40, TFT_GREEN);
+    d.drawPixels(pt, col, 300);
+    d.drawPolyline(pt, 20, TFT_YELLOW);
+    d.drawPolyline(pt + 20, 1, TFT_CYAN);
+  }
+  else {
+    for (int i = 0; i < 300; i++) d.drawFastHLine(span[i].x, span[i].y, span[i].w, span[i].color);
+    for (int i = 0; i < 40; i++) d.fillRect(rect[i].x, rect[i].y, rect[i].w, rect[i].h, TFT_GREEN);
+    for (int i = 0; i < 300; i++) d.drawPixel(pt[i].x, pt[i].y, col[i]);
+    for (int i = 1; i < 20; i++) d.drawLine(pt[i - 1].x, pt[i - 1].y, pt[i].x, pt[i].y, TFT_YELLOW);
+    d.drawPixel(pt[20].x, pt[20].y, TFT_CYAN);
+  }
+
+  d.resetViewport();
+}
+
+static void testBatched(TFT_eSPI &tft)
+{
+  static uint16_t ref[120 * 100];
+
+  tft.setRotation(1);
+  TFT_eSprite spr(&tft);
+  spr.createSprite(120, 100);
+  for (int k = 0; k < 2; k++) {
+    TFT_eSPI &d = k ? (TFT_eSPI &)spr : tft;
+    batchScene(d, false);
+    for (int i = 0; i < 120 * 100; i++) ref[i] = d.readPixel(i % 120, i / 120);
+    batchScene(d, true);
+    for (int i = 0; i < 120 * 100; i++) {
+      if (d.readPixel(i % 120, i / 120) != ref[i]) {
+        fprintf(stderr, "%s batch: mismatch at %d,%d\n", k ? "sprite" : "tft", i % 120, i / 120);
+        abort();
+      }
+    }
+  }
+  spr.deleteSprite();
+  tft.setRotation(0);
+}
+
+/***************************************************************************************
+** Wedge lines are within 1 LSB of the float distance rasteriser they replaced
+***************************************************************************************/
+// Coverage of pixel x,y as found by the original drawWedgeLine(), 0-1
+static float wedgeRef(float x, float y, float ax, float ay, float bx, float by, float ar, float br)
+{
+  if ((fabsf(ax - bx) < 0.01f) && (fabsf(ay - by) < 0.01f)) bx += 0.01f;
+  float xpax = x - ax, ypay = y - ay, bax = bx - ax, bay = by - ay;
+  float h = fmaxf(fminf((xpax * bax + ypay * bay) / (bax * bax + bay * bay), 1.0f), 0.0f);
+  float dx = xpax - bax * h, dy = ypay - bay * h;
+  return ar + 0.5f - (sqrtf(dx * dx + dy * dy) + h * (ar - br));
+}
+
+// Red level 0-31 of a pixel with coverage a
+static int wedgeRed(TFT_eSPI &tft, float a)
+{
+  if (a > 1.0f - 1.0f / 32) return 31;
+  if (a > 1.0f / 32) return tft.alphaBlend(a * 255, TFT_RED, TFT_BLACK) >> 11;
+  return 0;
+}
+
+static void testWedgeLine(TFT_eSPI &tft)
+{
+  static const struct { float ax, ay, bx, by, ar, br; } line[] = {
+    {  20.0f,  30.0f, 200.0f,  90.0f, 3.0f,  3.0f }, // Wide
+    {  30.5f, 250.2f, 180.3f,  40.7f, 6.0f,  1.5f }, // Wedge
+    { 120.0f, 160.0f, 120.0f, 160.0f, 8.0f,  8.0f }, // Zero length
+    {  50.3f,  50.3f,  50.3f,  50.3f, 0.4f,  0.4f }, // Zero length and thin
+    { -50.0f, 100.3f, 300.0f, 104.1f, 0.2f,  0.2f }, // Very thin, long runs of edge pixels
+    {  10.0f,  10.0f,  17.0f, 300.0f, 0.1f,  0.3f }, // Very thin, steep
+    {-400.0f, -90.0f, 500.0f, 410.0f, 2.5f,  2.5f }, // Both ends off screen
+    { 200.0f, 300.0f, 260.0f, 340.0f, 10.0f, 4.0f }, // End off screen
+    { 100.0f, -30.0f, 140.0f, 900.0f, 1.0f, 20.0f }, // Far end off screen
+  };
+  static uint16_t rb[240 * 320];
+
+  tft.setRotation(0);
+  for (auto &t : line) {
+    tft.fillScreen(TFT_BLACK);
+    tft.drawWedgeLine(t.ax, t.ay, t.bx, t.by, t.ar, t.br, TFT_RED, TFT_BLACK);
+    tft.readRect(0, 0, 240, 320, rb);
+    int lit = 0;
+    for (int32_t i = 0; i < 240 * 320; i++) {
+      int32_t x = i % 240, y = i / 240;
+      // The coverage is fixed point, so allow for a step of the 1/32 thresholds
+      float a = wedgeRef(x, y, t.ax, t.ay, t.bx, t.by, t.ar, t.br);
+      int lo = wedgeRed(tft, a - 1.5f / 256), hi = wedgeRed(tft, a + 1.5f / 256);
+      uint16_t c = swap16(rb[i]);
+      lit += (c != TFT_BLACK);
+      if ((c & 0x07FF) || (c >> 11) < lo - 1 || (c >> 11) > hi + 1) {
+        fprintf(stderr, "wedge line: mismatch at %d,%d tft %04x ref %d-%d\n", x, y, c, lo, hi);
+        abort();
+      }
+    }
+    assert(lit > 0);
+  }
+}
+
+/***************************************************************************************
+** Arcs match the original per-pixel drawArc() for all start and end angle cases
+***************************************************************************************/
+// The original drawArc() drawing to an image, it tested each pixel of a line in turn
+static uint16_t arcImg[100 * 100];
+
+static void arcPixel(int32_t x, int32_t y, uint16_t c)
+{
+  if (x >= 0 && x < 100 && y >= 0 && y < 100) arcImg[x + y * 100] = c;
+}
+
+static uint8_t sqrtFractionRef(uint32_t num)
+{
+  if (num > (0x40000000)) return 0;
+  uint32_t bsh = 0x00004000;
+  uint32_t fpr = 0;
+  uint32_t osh = 0;
+
+  while (num > bsh) { bsh <<= 2; osh++; }
+
+  do {
+    uint32_t bod = bsh + fpr;
+    if (num >= bod) {
+      num -= bod;
+      fpr = bsh + bod;
+    }
+    num <<= 1;
+  } while (bsh >>= 1);
+
+  return fpr >> osh;
+}
+
+static void arcRef(int32_t x, int32_t y, int32_t r, int32_t ir, uint32_t startAngle, uint32_t endAngle,
+                   uint16_t fg_color, uint16_t bg_color, bool smooth)
+{
+  if (endAngle   > 360)   endAngle = 360;
+  if (startAngle > 360) startAngle = 360;
+  if (startAngle == endAngle) return;
+  if (r < ir) std::swap(r, ir);
+  if (r <= 0 || ir < 0) return;
+
+  if (endAngle < startAngle) {
+    if (startAngle < 360) arcRef(x, y, r, ir, startAngle, 360, fg_color, bg_color, smooth);
+    if (endAngle == 0) return;
+    startAngle = 0;
+  }
+
+  int32_t xs = 0;
+  uint8_t alpha = 0;
+
+  uint32_t r2 = r * r;
+  if (smooth) r++;
+  uint32_t r1 = r * r;
+  int16_t w  = r - ir;
+  uint32_t r3 = ir * ir;
+  if (smooth) ir--;
+  uint32_t r4 = ir * ir;
+
+  uint32_t startSlope[4] = {0, 0, 0xFFFFFFFF, 0};
+  uint32_t   endSlope[4] = {0, 0xFFFFFFFF, 0, 0};
+  constexpr float deg2rad = 3.14159265359 / 180.0;
+  constexpr float minDivisor = 1.0f/0x8000;
+
+  float fabscos = fabsf(cosf(startAngle * deg2rad));
+  float fabssin = fabsf(sinf(startAngle * deg2rad));
+  uint32_t slope = (fabscos/(fabssin + minDivisor)) * (float)(1UL<<16);
+
+  if (startAngle <= 90) startSlope[0] = slope;
+  else if (startAngle <= 180) startSlope[1] = slope;
+  else if (startAngle <= 270) { startSlope[1] = 0xFFFFFFFF; startSlope[2] = slope; }
+  else { startSlope[1] = 0xFFFFFFFF; startSlope[2] = 0; startSlope[3] = slope; }
+
+  fabscos = fabsf(cosf(endAngle * deg2rad));
+  fabssin = fabsf(sinf(endAngle * deg2rad));
+  slope   = (uint32_t)((fabscos/(fabssin + minDivisor)) * (float)(1UL<<16));
+
+  if (endAngle <= 90) { endSlope[0] = slope; endSlope[1] = 0; startSlope[2] = 0; }
+  else if (endAngle <= 180) { endSlope[1] = slope; startSlope[2] = 0; }
+  else if (endAngle <= 270) endSlope[2] = slope;
+  else endSlope[3] = slope;
+
+  for (int32_t cy = r - 1; cy > 0; cy--) {
+    uint32_t len[4] = { 0,  0,  0,  0};
+    int32_t  xst[4] = {-1, -1, -1, -1};
+    uint32_t dy2 = (r - cy) * (r - cy);
+
+    while ((r - xs) * (r - xs) + dy2 >= r1) xs++;
+
+    for (int32_t cx = xs; cx < r; cx++) {
+      uint32_t hyp = (r - cx) * (r - cx) + dy2;
+      if (hyp > r2) alpha = ~sqrtFractionRef(hyp);
+      else if (hyp >= r3) {
+        slope = ((r - cy) << 16)/(r - cx);
+        if (slope <= startSlope[0] && slope >= endSlope[0]) { xst[0] = cx; len[0]++; }
+        if (slope >= startSlope[1] && slope <= endSlope[1]) { xst[1] = cx; len[1]++; }
+        if (slope <= startSlope[2] && slope >= endSlope[2]) { xst[2] = cx; len[2]++; }
+        if (slope <= endSlope[3] && slope >= startSlope[3]) { xst[3] = cx; len[3]++; }
+        continue;
+      }
+      else {
+        if (hyp <= r4) break;
+        alpha = sqrtFractionRef(hyp);
+      }
+
+      if (alpha < 16) continue;
+
+      uint16_t pcol = fastBlend(alpha, fg_color, bg_color);
+      slope = ((r - cy)<<16)/(r - cx);
+      if (slope <= startSlope[0] && slope >= endSlope[0]) arcPixel(x + cx - r, y - cy + r, pcol);
+      if (slope >= startSlope[1] && slope <= endSlope[1]) arcPixel(x + cx - r, y + cy - r, pcol);
+      if (slope <= startSlope[2] && slope >= endSlope[2]) arcPixel(x - cx + r, y + cy - r, pcol);
+      if (slope <= endSlope[3] && slope >= startSlope[3]) arcPixel(x - cx + r, y - cy + r, pcol);
+    }
+    for (uint32_t i = 0; i < len[0]; i++) arcPixel(x + xst[0] - len[0] + 1 - r + i, y - cy + r, fg_color);
+    for (uint32_t i = 0; i < len[1]; i++) arcPixel(x + xst[1] - len[1] + 1 - r + i, y + cy - r, fg_color);
+    for (uint32_t i = 0; i < len[2]; i++) arcPixel(x - xst[2] + r + i, y + cy - r, fg_color);
+    for (uint32_t i = 0; i < len[3]; i++) arcPixel(x - xst[3] + r + i, y - cy + r, fg_color);
+  }
+
+  for (int32_t i = 0; i < w; i++) {
+    if (startAngle ==   0 || endAngle == 360) arcPixel(x, y + r - w + i, fg_color);
+    if (startAngle <=  90 && endAngle >=  90) arcPixel(x - r + 1 + i, y, fg_color);
+    if (startAngle <= 180 && endAngle >= 180) arcPixel(x, y - r + 1 + i, fg_color);
+    if (startAngle <= 270 && endAngle >= 270) arcPixel(x + r - w + i, y, fg_color);
+  }
+}
+
+static void testArc(TFT_eSPI &tft)
+{
+  static const uint16_t angle[] = { 0, 1, 30, 45, 89, 90, 91, 135, 180, 181, 200, 270, 300, 359, 360, 400 };
+  static const struct { int16_t r, ir; } size[] = { { 40, 30 }, { 25, 0 }, { 12, 11 }, { 30, 45 } };
+
+  tft.setRotation(0);
+  for (auto &sz : size) {
+    for (int smooth = 0; smooth < 2; smooth++) {
+      for (auto a0 : angle) for (auto a1 : angle) {
+        // The background is not read, 0x00FFFFFF blends with white. The blend rounding
+        // has changed so AA pixels can differ by 1 LSB
+        uint32_t bg = (a1 & 1) ? 0x00FFFFFF : TFT_NAVY;
+        for (auto &c : arcImg) c = TFT_DARKGREY;
+        tft.fillRect(10, 20, 100, 100, TFT_DARKGREY);
+        arcRef(50, 50, sz.r, sz.ir, a0, a1, TFT_ORANGE, (uint16_t)bg, smooth);
+        tft.drawArc(60, 70, sz.r, sz.ir, a0, a1, TFT_ORANGE, bg, smooth);
+        checkRectNear(tft, 10, 20, 100, 100, arcImg, 1, "arc");
+      }
+    }
+  }
+}
+
+/***************************************************************************************
+** 1 and 4bpp scrolling: the packed line copy matches the pixel loop and a reference
+***************************************************************************************/
+static void testScroll(TFT_eSPI &tft)
+{
+  static const int8_t dxs[] = { -13, -8, -3, -1, 0, 1, 2, 7, 8, 11 };
+  static const int8_t dys[] = { -3, -1, 0, 1, 2 };
+  static const struct { int16_t x, y, w, h; } area[] = { { 0, 0, 53, 17 }, { 3, 2, 37, 11 }, { 9, 5, 16, 4 } };
+  static uint8_t before[53 * 18], ref[53 * 18];
+  constexpr int32_t W = 53, H = 18;
+
+  for (int bpp = 1; bpp <= 4; bpp += 3) {
+    TFT_eSprite fast(&tft), slow(&tft);
+    for (TFT_eSprite *s : { &fast, &slow }) {
+      s->setColorDepth(bpp);
+      s->createSprite(W, H);
+    }
+
+    uint32_t seed = 7;
+    uint8_t  fill = (bpp == 4) ? 9 : 1;
+    for (auto &a : area) for (auto dx : dxs) for (auto dy : dys) {
+      for (int32_t i = 0; i < W * H; i++) {
+        uint8_t v = lcg(seed) & ((bpp == 4) ? 0x0F : 0x01);
+        fast.drawPixel(i % W, i / W, v);
+        slow.drawPixel(i % W, i / W, v);
+        before[i] = v;
+      }
+      // A viewport that is not the whole sprite makes scroll() use the pixel loop, the
+      // scroll areas are inside it
+      slow.setViewport(0, 0, W, H - 1);
+
+      // Pixels in the scroll area move by dx,dy, the uncovered pixels are the fill colour
+      for (int32_t i = 0; i < W * H; i++) {
+        int32_t x = i % W, y = i / W;
+        ref[i] = before[i];
+        if (x < a.x || x >= a.x + a.w || y < a.y || y >= a.y + a.h) continue;
+        int32_t fx = x - dx, fy = y - dy;
+        bool in = (fx >= a.x && fx < a.x + a.w && fy >= a.y && fy < a.y + a.h);
+        ref[i] = in ? before[fx + fy * W] : fill;
+      }
+
+      for (TFT_eSprite *s : { &fast, &slow }) {
+        s->setScrollRect(a.x, a.y, a.w, a.h, fill);
+        s->scroll(dx, dy);
+        s->resetViewport();
+        for (int32_t i = 0; i < W * H; i++) {
+          if (s->readPixelValue(i % W, i / W) != ref[i]) {
+            fprintf(stderr, "scroll %dbpp %s %d,%d: mismatch at %d,%d\n", bpp, s == &fast ? "lines" : "pixels",
+                    dx, dy, i % W, i / W);
+            abort();
+          }
+        }
+      }
+    }
+    fast.deleteSprite();
+    slow.deleteSprite();
+  }
+}
+
+/***************************************************************************************
+** Scaled images and sprites against nearest and bilinear references
+***************************************************************************************/
+// Check the dw x dh area at x,y of d against img scaled with mode, the area may be clipped
+// by the edge of d. The pixels around the area must still be the marker colour
+static void checkScaled(TFT_eSPI &d, int32_t x, int32_t y, int32_t dw, int32_t dh, const uint16_t *img,
+                        int32_t sw, int32_t sh, uint8_t mode, uint16_t marker, const char *what)
+{
+  for (int32_t py = y - 1; py <= y + dh; py++) {
+    for (int32_t px = x - 1; px <= x + dw; px++) {
+      if (px < 0 || py < 0 || px >= d.width() || py >= d.height()) continue;
+      uint16_t c = d.readPixel(px, py);
+      int32_t i = px - x, j = py - y;
+      if (i < 0 || j < 0 || i >= dw || j >= dh) {
+        if (c != marker) { fprintf(stderr, "%s: drawn outside at %d,%d\n", what, px, py); abort(); }
+        continue;
+      }
+      if (mode == SCALE_NEAREST) {
+        uint16_t ref = img[(2 * i + 1) * sw / (2 * dw) + (2 * j + 1) * sh / (2 * dh) * sw];
+        if (c != ref) {
+          fprintf(stderr, "%s: nearest at %d,%d is %04x, expected %04x\n", what, i, j, c, ref);
+          abort();
+        }
+      }
+      else {
+        float rgb[3];
+        bilinearRef(img, sw, sh, (i + 0.5f) * sw / dw, (j + 0.5f) * sh / dh, rgb);
+        int r = c >> 11, g = (c >> 5) & 63, b = c & 31;
+        if (fabsf(r - rgb[0]) > 1.5f || fabsf(g - rgb[1]) > 2.5f || fabsf(b - rgb[2]) > 1.5f) {
+          fprintf(stderr, "%s: bilinear at %d,%d is %04x, expected %.1f %.1f %.1f\n", what, i, j, c, rgb[0], rgb[1], rgb[2]);
+          abort();
+        }
+      }
+    }
+  }
+}
+
+static void testScaled(TFT_eSPI &tft)
+{
+  constexpr int32_t SW = 13, SH = 9;
+  static const struct { int16_t x, y, w, h; } dst[] = {
+    { 10, 12, 13, 9 },  // Same size
+    { 10, 12, 52, 36 }, // Whole number up scale
+    { 10, 12, 47, 20 }, // Up scale, different in x and y
+    { 10, 12, 6, 4 },   // Down scale
+    { 10, 12, 1, 30 },  // One column
+    { -7, -5, 40, 30 }, // Clipped at the top left
+    { 220, 300, 40, 30 }, // Clipped at the bottom right
+  };
+  static uint16_t img[SW * SH], tftImg[SW * SH];
+  uint32_t seed = 3;
+  for (int i = 0; i < SW * SH; i++) { img[i] = lcg(seed); tftImg[i] = swap16(img[i]); }
+
+  tft.setRotation(0);
+  TFT_eSprite spr(&tft), src(&tft);
+  spr.createSprite(100, 80);
+  src.createSprite(SW, SH);
+  src.pushImage(0, 0, SW, SH, tftImg); // Sprite memory is in TFT byte order
+  for (uint8_t mode = SCALE_NEAREST; mode <= SCALE_BILINEAR; mode++) {
+    for (auto &a : dst) {
+      // TFT, the image in processor and then in TFT byte order
+      for (int k = 0; k < 2; k++) {
+        tft.fillScreen(TFT_MAGENTA);
+        tft.setSwapBytes(k == 0);
+        tft.pushImageScaled(a.x, a.y, a.w, a.h, SW, SH, k ? tftImg : img, mode);
+        tft.setSwapBytes(false);
+        checkScaled(tft, a.x, a.y, a.w, a.h, img, SW, SH, mode, TFT_MAGENTA, "pushImageScaled");
+      }
+
+      // Sprite
+      spr.fillSprite(TFT_MAGENTA);
+      spr.setSwapBytes(true);
+      spr.pushImageScaled(a.x, a.y, a.w, a.h, SW, SH, img, mode);
+      spr.setSwapBytes(false);
+      checkScaled(spr, a.x, a.y, a.w, a.h, img, SW, SH, mode, TFT_MAGENTA, "sprite pushImageScaled");
+
+      // 16-bit sprite to the TFT
+      tft.fillScreen(TFT_MAGENTA);
+      assert(src.pushSpriteScaled(a.x, a.y, a.w, a.h, mode));
+      checkScaled(tft, a.x, a.y, a.w, a.h, img, SW, SH, mode, TFT_MAGENTA, "pushSpriteScaled");
+    }
+  }
+  spr.deleteSprite();
+  src.deleteSprite();
+
+  // Only 16-bit sprites can be scaled
+  src.setColorDepth(8);
+  src.createSprite(SW, SH);
+  assert(!src.pushSpriteScaled(0, 0, 20, 20));
+  src.deleteSprite();
+}
+
+/***************************************************************************************
+** Triangle meshes: shared edges, the top-left fill rule, culling and Gouraud shading
+***************************************************************************************/
+// Pixels of spr that are not black
+static int meshLit(TFT_eSprite &spr, uint8_t *count = nullptr)
+{
+  int lit = 0;
+  for (int32_t i = 0; i < spr.width() * spr.height(); i++) {
+    bool on = spr.readPixel(i % spr.width(), i / spr.width()) != TFT_BLACK;
+    lit += on;
+    if (count) count[i] += on;
+  }
+  return lit;
+}
+
+static void testMesh(TFT_eSPI &tft)
+{
+  constexpr int32_t W = 80, H = 60;
+  static const uint16_t white[] = { TFT_WHITE, TFT_WHITE };
+  TFT_eSprite spr(&tft);
+  spr.createSprite(W, H);
+
+  // A 6 x 5 grid from 10,8 to 70,48 with the inner vertices moved, two triangles per cell
+  // in both corner orders. Each triangle is drawn on its own, every pixel of the grid area
+  // must be drawn exactly once
+  static tftMeshVertex_t gv[7 * 6];
+  static uint16_t gi[6 * 5 * 6];
+  static uint8_t  count[W * H];
+  uint32_t seed = 11;
+  for (int j = 0; j < 6; j++) for (int i = 0; i < 7; i++) {
+    tftMeshVertex_t &v = gv[i + j * 7];
+    v.x = 10 + i * 10;
+    v.y = 8 + j * 8;
+    v.z = 0;
+    if (i > 0 && i < 6 && j > 0 && j < 5) { v.x += lcg(seed) % 7 - 3; v.y += lcg(seed) % 5 - 2; }
+  }
+  uint32_t n = 0;
+  for (int j = 0; j < 5; j++) for (int i = 0; i < 6; i++) {
+    uint16_t a = i + j * 7, b = a + 1, c = a + 7, d = a + 8;
+    uint16_t t[6] = { a, b, d, a, d, c };
+    if ((i + j) & 1) { t[0] = a; t[1] = b; t[2] = c; t[3] = b; t[4] = c; t[5] = d; } // Other diagonal, anticlockwise
+    for (int k = 0; k < 6; k++) gi[n++] = t[k];
+  }
+  memset(count, 0, sizeof(count));
+  for (uint32_t t = 0; t < n / 3; t++) {
+    spr.fillSprite(TFT_BLACK);
+    spr.drawTriangleMesh(gv, gi + 3 * t, 1, white);
+    assert(meshLit(spr, count) > 0);
+  }
+  for (int32_t i = 0; i < W * H; i++) {
+    int32_t x = i % W, y = i / W;
+    int expect = (x >= 10 && x < 70 && y >= 8 && y < 48);
+    if (count[i] != expect) {
+      fprintf(stderr, "mesh: pixel %d,%d drawn %d times\n", x, y, count[i]);
+      abort();
+    }
+  }
+
+  // The whole mesh in one call is the same, and the TFT matches the sprite
+  static uint16_t flat[6 * 5 * 2], ref[W * H];
+  for (auto &c : flat) c = lcg(seed) | 0x0821;
+  spr.fillSprite(TFT_BLACK);
+  spr.drawTriangleMesh(gv, gi, n / 3, flat);
+  assert(meshLit(spr) == 60 * 40);
+  for (int32_t i = 0; i < W * H; i++) ref[i] = spr.readPixel(i % W, i / W);
+  tft.setRotation(0);
+  tft.fillRect(0, 0, W, H, TFT_BLACK);
+  tft.drawTriangleMesh(gv, gi, n / 3, flat);
+  checkRect(tft, 0, 0, W, H, ref, "mesh");
+
+  // Top-left rule, pixel centres are at whole coordinates. Pixels on a left or top edge
+  // are drawn, pixels on a right or bottom edge are not
+  static const tftMeshVertex_t tv[] = { { 0, 0, 0 }, { 4, 0, 0 }, { 0, 4, 0 }, { 20, 10, 0 }, { 30, 10, 0 }, { 30, 20, 0 }, { 20, 20, 0 } };
+  static const uint16_t ti[] = { 0, 1, 2, 3, 4, 5, 3, 5, 6 };
+  spr.fillSprite(TFT_BLACK);
+  spr.drawTriangleMesh(tv, ti, 1, white);
+  assert(meshLit(spr) == 4 + 3 + 2 + 1);
+  for (int y = 0; y < 6; y++) for (int x = 0; x < 6; x++) assert((spr.readPixel(x, y) != TFT_BLACK) == (x + y < 4));
+  spr.fillSprite(TFT_BLACK);
+  spr.drawTriangleMesh(tv, ti + 3, 2, white);
+  assert(meshLit(spr) == 100);
+  for (int y = 8; y < 23; y++) for (int x = 18; x < 33; x++)
+    assert((spr.readPixel(x, y) != TFT_BLACK) == (x >= 20 && x < 30 && y >= 10 && y < 20));
+
+  // Culling, triangle 0 is clockwise on the screen and 1 is anticlockwise
+  static const uint16_t ci[] = { 0, 1, 2, 0, 2, 1 };
+  for (int k = 0; k < 4; k++) {
+    spr.fillSprite(TFT_BLACK);
+    spr.drawTriangleMesh(tv, ci + 3 * (k & 1), 1, white, (k & 2) ? MESH_CULL_CCW : MESH_FLAT);
+    assert(meshLit(spr) == ((k == 3) ? 0 : 10));
+  }
+
+  // Gouraud shading against the colour of each channel interpolated at the pixel centre
+  static const tftMeshVertex_t sv[] = { { 5, 3, 0 }, { 75, 20, 0 }, { 22, 57, 0 } };
+  static const uint16_t si[] = { 0, 1, 2 };
+  static const uint16_t sc[] = { TFT_RED, TFT_GREEN, TFT_BLUE };
+  spr.fillSprite(TFT_BLACK);
+  spr.drawTriangleMesh(sv, si, 1, sc, MESH_GOURAUD);
+  float area = (float)(sv[1].x - sv[0].x) * (sv[2].y - sv[0].y) - (float)(sv[1].y - sv[0].y) * (sv[2].x - sv[0].x);
+  int lit = 0;
+  for (int y = 0; y < H; y++) for (int x = 0; x < W; x++) {
+    uint16_t c = spr.readPixel(x, y);
+    float b1 = ((x - sv[0].x) * (sv[2].y - sv[0].y) - (y - sv[0].y) * (sv[2].x - sv[0].x)) / area;
+    float b2 = ((y - sv[0].y) * (sv[1].x - sv[0].x) - (x - sv[0].x) * (sv[1].y - sv[0].y)) / area;
+    float b0 = 1 - b1 - b2;
+    if (c == TFT_BLACK) { assert(b0 < 0.05f || b1 < 0.05f || b2 < 0.05f); continue; }
+    lit++;
+    assert(b0 > -0.05f && b1 > -0.05f && b2 > -0.05f);
+    if (fabsf((c >> 11) - 31 * b0) > 1.0f || fabsf(((c >> 5) & 63) - 63 * b1) > 1.0f || fabsf((c & 31) - 31 * b2) > 1.0f) {
+      fprintf(stderr, "mesh: Gouraud at %d,%d is %04x, expected %.1f %.1f %.1f\n", x, y, c, 31 * b0, 63 * b1, 31 * b2);
+      abort();
+    }
+  }
+  assert(lit > 1000);
+
+  spr.deleteSprite();
+}
+
+int main()
+{
+  static TFT_eSPI tft;
+  tft.init();
+
+  testPanel(tft);
+  testBusStats(tft);
+  testWindowShadow(tft);
+  testDisplayList(tft);
+  testDirty(tft);
+  testBanded(tft);
+  testColorSpans(tft);
+  testPackedImages(tft);
+  testTransparent(tft);
+  testBlend(tft);
+  testPolygon(tft);
+  testPath(tft);
+  testGradient(tft);
+  testAffine(tft);
+  testAllocator(tft);
+  testBatched(tft);
+  testWedgeLine(tft);
+  testArc(tft);
+  testScroll(tft);
+  testScaled(tft);
+  testMesh(tft);
+
+  printf("ok\n");
+  return 0;
+}
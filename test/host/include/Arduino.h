@@ -0,0 +1,98 @@
+        ////////////////////////////////////////////////////
+        //    Minimal Arduino API for the TFT_eSPI host    //
+        ////////////////////////////////////////////////////
+
+// Only what the library uses is provided, pins and delays do nothing as the
+// TFT model in Processors/TFT_eSPI_Host.c has no timing
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define INPUT     0
+#define OUTPUT    1
+#define LOW       0
+#define HIGH      1
+#define MSBFIRST  1
+#define SPI_MODE0 0
+#define SPI_MODE3 3
+
+// Flash is ordinary memory on the host, memcpy avoids type punned reads
+#define PROGMEM
+#define F(x) (x)
+class __FlashStringHelper;
+
+static inline uint8_t host_read_byte(const void *addr) { uint8_t v; memcpy(&v, addr, sizeof(v)); return v; }
+static inline uint16_t host_read_word(const void *addr) { uint16_t v; memcpy(&v, addr, sizeof(v)); return v; }
+static inline uint32_t host_read_dword(const void *addr) { uint32_t v; memcpy(&v, addr, sizeof(v)); return v; }
+
+#define pgm_read_byte(addr)  host_read_byte(addr)
+#define pgm_read_word(addr)  host_read_word(addr)
+#define pgm_read_dword(addr) host_read_dword(addr)
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int  digitalRead(int) { return 0; }
+inline uint32_t digitalPinToBitMask(int pin) { return 1u << (pin & 31); }
+
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+inline void yield(void) {}
+inline unsigned long millis(void) { return 0; }
+inline unsigned long micros(void) { return 0; }
+
+inline long random(long max) { return (max > 0) ? (rand() % max) : 0; }
+inline char* ltoa(long value, char *buf, int) { sprintf(buf, "%ld", value); return buf; }
+
+using std::min;
+using std::max;
+
+// Arduino round() returns a long
+#define round(x) lround(x)
+
+// Enough of the Arduino String class for the drawString() and print() overloads
+class String {
+ public:
+  String(const char *c = "") : s(c ? c : "") {}
+  String(const std::string &x) : s(x) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned int v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(double v, int d = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", d, v); s = b; }
+
+  unsigned int length(void) const { return s.size(); }
+  const char* c_str(void) const { return s.c_str(); }
+  void toCharArray(char *buf, unsigned int n) const { if (n) { strncpy(buf, s.c_str(), n); buf[n - 1] = 0; } }
+
+  String  operator+ (const String &o) const { return String(s + o.s); }
+  String  operator+ (const char *o) const { return String(s + o); }
+  friend String operator+ (const char *a, const String &b) { return String(std::string(a) + b.s); }
+  String& operator+=(const String &o) { s += o.s; return *this; }
+  bool    operator==(const String &o) const { return s == o.s; }
+  char    operator[](unsigned int i) const { return s[i]; }
+
+  bool startsWith(const String &o) const { return s.compare(0, o.s.size(), o.s) == 0; }
+  bool endsWith(const String &o) const {
+    return (s.size() >= o.s.size()) && (s.compare(s.size() - o.s.size(), o.s.size(), o.s) == 0);
+  }
+
+ private:
+  std::string s;
+};
+
+#include "Print.h"
+
+#endif
@@ -0,0 +1,32 @@
+        ////////////////////////////////////////////////////
+        //    Minimal Arduino Print for the TFT_eSPI host  //
+        ////////////////////////////////////////////////////
+
+#ifndef _HOST_PRINT_H_
+#define _HOST_PRINT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define DEC 10
+#define HEX 16
+
+class Print {
+ public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n) { size_t r = 0; while (n--) r += write(*buf++); return r; }
+  size_t write(const char *str) { size_t r = 0; while (*str) r += write((uint8_t)*str++); return r; }
+
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long v, int base = DEC) { char b[24]; snprintf(b, sizeof(b), (base == HEX) ? "%lx" : "%ld", v); return write(b); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { char b[24]; snprintf(b, sizeof(b), (base == HEX) ? "%x" : "%u", v); return write(b); }
+  size_t print(double v, int digits = 2) { char b[40]; snprintf(b, sizeof(b), "%.*f", digits, v); return write(b); }
+  size_t println(const char *str = "") { size_t r = write(str); return r + write("\n"); }
+};
+
+#endif